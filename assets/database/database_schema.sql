@@ -301,26 +301,26 @@ CREATE VIEW viewExport AS
 SELECT  flight_id,
         doft as 'Date',
         dept AS 'Dept',
-        printf('%02d',(tofb/60))||':'||printf('%02d',(tofb%60)) AS 'Time Out',
+        tofb AS 'Time Out',
         dest AS 'Dest',
-        printf('%02d',(tonb/60))||':'||printf('%02d',(tonb%60)) AS 'Time In ',
+        tonb AS 'Time In ',
         CASE  WHEN variant IS NOT NULL THEN make||' '||model||'-'||variant  ELSE make||' '||model  END  AS 'Type',
         registration AS 'Registration',
-        (SELECT printf('%02d',(tSPSE/60))||':'||printf('%02d',(tSPSE%60)) WHERE tSPSE IS NOT NULL) AS 'SP SE',
-        (SELECT printf('%02d',(tSPME/60))||':'||printf('%02d',(tSPME%60)) WHERE tSPME IS NOT NULL) AS 'SP ME',
-        (SELECT printf('%02d',(tMP/60))||':'||printf('%02d',(tMP%60)) WHERE tMP IS NOT NULL) AS 'MP',
-        printf('%02d',(tblk/60))||':'||printf('%02d',(tblk%60)) AS 'Total',
+        tSPSE AS 'SP SE',
+        tSPME AS 'SP ME',
+        tMP AS 'MP',
+        tblk AS 'Total',
         CASE  WHEN pilot_id = 1 THEN alias  ELSE lastname||', '||substr(firstname, 1, 1)||'.'  END  AS 'Name PIC',
         toDay AS 'Take-Off Day',
         ldgDay AS 'Landings Day',
         toNight AS 'Take-Off Night',
         ldgNight AS 'Landings Night',
-        (SELECT printf('%02d',(tNight/60))||':'||printf('%02d',(tNight%60)) WHERE tNight IS NOT NULL)  AS 'Night',
-        (SELECT printf('%02d',(tIFR/60))||':'||printf('%02d',(tIFR%60)) WHERE tIFR IS NOT NULL)  AS 'IFR',
-        (SELECT printf('%02d',(tPIC/60))||':'||printf('%02d',(tPIC%60)) WHERE tPIC IS NOT NULL)  AS 'PIC',
-        (SELECT printf('%02d',(tSIC/60))||':'||printf('%02d',(tSIC%60)) WHERE tSIC IS NOT NULL)  AS 'SIC',
-        (SELECT printf('%02d',(tDual/60))||':'||printf('%02d',(tDual%60)) WHERE tDual IS NOT NULL)  AS 'Dual',
-        (SELECT printf('%02d',(tFI/60))||':'||printf('%02d',(tFI%60)) WHERE tFI IS NOT NULL)  AS 'FI',
+        tNight AS 'Night',
+        tIFR AS 'IFR',
+        tPIC AS 'PIC',
+        tSIC AS 'SIC',
+        tDual AS 'Dual',
+        tFI AS 'FI',
         null AS 'Sim Type',
         null AS 'Time of Session',
         remarks AS 'Remarks'
@@ -336,7 +336,7 @@ SELECT (session_id * -1),
         null,  null,  null,
         'SIM',
         null,  null,  null,  null,  null,  null,  null,  null,  null,  null, null,
-        deviceType,  printf('%02d',(totalTime/60))||':'||printf('%02d',(totalTime%60)),
+        deviceType,  totalTime,
         remarks
 FROM simulators
 ORDER BY date DESC;
@@ -25,6 +25,7 @@
 #include "src/classes/style.h"
 #include "src/functions/log.h"
 #include "src/classes/paths.h"
+#include "src/testing/trace.h"
 #include <QApplication>
 #include <QProcess>
 #include <QSettings>
@@ -32,6 +33,7 @@
 #include <QStandardPaths>
 #include <QDebug>
 #include <QTranslator>
+#include <QElapsedTimer>
 
 
 
@@ -78,7 +80,13 @@ bool init()
     }
 
     LOG << "Setting up logging facilities...";
-    if(OPL::Log::init(true)) {
+    // Debug messages are only written to the log file in debug builds
+#ifdef QT_DEBUG
+    const bool log_debug = true;
+#else
+    const bool log_debug = false;
+#endif
+    if(OPL::Log::init(log_debug)) {
         LOG << "Logging enabled.";
     } else {
         LOG << "Unable to initalise logging.";
@@ -106,9 +114,18 @@ int main(int argc, char *argv[])
     QCoreApplication::setOrganizationDomain(ORGDOMAIN);
     QCoreApplication::setApplicationName(APPNAME);
 
+    QElapsedTimer startupTimer;
+    startupTimer.start();
+
+    // Setting OPL_TRACE_FILE records a trace of the whole session, which is written on exit
+    const QString trace_file = qEnvironmentVariable("OPL_TRACE_FILE");
+    if (!trace_file.isEmpty())
+        OPL::Trace::start();
+
     // Set Up the Application
     if(!init())
         return 1;
+    LOG << "Start up: Application set up in" << startupTimer.elapsed() << "ms";
 
     // Create Main Window and set Window Icon acc. to Platform
     MainWindow w;
@@ -131,5 +148,15 @@ int main(int argc, char *argv[])
 
     //w.showMaximized();
     w.show();
-    return openPilotLog.exec();
+    LOG << "Start up: Main Window shown after" << startupTimer.elapsed() << "ms";
+    const int exit_code = openPilotLog.exec();
+
+    if (!trace_file.isEmpty()) {
+        OPL::Trace::stop();
+        if (OPL::Trace::writeChromeTrace(trace_file))
+            LOG << "Trace written to" << trace_file;
+        else
+            LOG << "Unable to write trace file" << trace_file;
+    }
+    return exit_code;
 }
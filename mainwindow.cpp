@@ -27,7 +27,10 @@
 #include "src/classes/style.h"
 #include "src/gui/dialogues/firstrundialog.h"
 #include "src/database/databasecache.h"
+#include "src/database/flightstore.h"
+#include "src/database/flightpredictor.h"
 #include "src/classes/settings.h"
+#include "src/testing/trace.h"
 
 // WIP area - pressing SHIFT + ENTER executes this function
 // this is to provide easy and quick access to a currently worked on functionality
@@ -52,6 +55,7 @@ MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
 {
+    TRACE_FUNCTION("gui");
     ui->setupUi(this);
     init();
 }
@@ -63,12 +67,24 @@ MainWindow::~MainWindow()
 
 void MainWindow::init()
 {
+    // Only the home widget is constructed at start up, all other pages are created when first
+    // requested. Log how long each start up phase takes to spot regressions on large databases.
+    QElapsedTimer totalTimer;
+    totalTimer.start();
+    QElapsedTimer phaseTimer;
+
+    phaseTimer.start();
     connectDatabase();
-    initialiseWidgets();
+    LOG << "Start up: Database connected in" << phaseTimer.restart() << "ms";
+    loadDatabaseCache();
+    LOG << "Start up: Database cache loaded in" << phaseTimer.restart() << "ms";
     setupToolbar();
-    connectWidgets();
     setActionIcons(OPL::Style::getStyleType());
-    ui->stackedWidget->setCurrentWidget(homeWidget);
+    QObject::connect(this, &MainWindow::settingChanged,
+                     this, &MainWindow::onStyleChanged);
+    LOG << "Start up: Toolbar set up in" << phaseTimer.restart() << "ms";
+    ui->stackedWidget->setCurrentWidget(getHomeWidget());
+    LOG << "Start up: Main Window initialised in" << totalTimer.elapsed() << "ms";
 }
 
 void MainWindow::setupToolbar()
@@ -90,33 +106,109 @@ void MainWindow::setupToolbar()
     addToolBar(Qt::ToolBarArea::LeftToolBarArea, toolBar);
 }
 
-void MainWindow::initialiseWidgets()
+void MainWindow::addPage(QWidget *page, const QElapsedTimer &timer)
 {
-    // Construct Widgets
-    homeWidget = new HomeWidget(this);
-    ui->stackedWidget->addWidget(homeWidget);
+    ui->stackedWidget->addWidget(page);
+    LOG << "Page" << page->metaObject()->className() << "constructed in" << timer.elapsed() << "ms";
+}
 
-    logbookWidget = new LogbookTableEditWidget(this);
-    logbookWidget->init();
-    ui->stackedWidget->addWidget(logbookWidget);
+HomeWidget *MainWindow::getHomeWidget()
+{
+    if (homeWidget == nullptr) {
+        QElapsedTimer timer;
+        timer.start();
+        homeWidget = new HomeWidget(this);
+        addPage(homeWidget, timer);
+    }
+    return homeWidget;
+}
 
-    tailsWidget = new TailTableEditWidget(this);
-    tailsWidget->init();
-    ui->stackedWidget->addWidget(tailsWidget);
+/*!
+ * \brief Returns the logbook widget, constructing it on first use.
+ * \details The logbook widget is connected to signals that are emitted when a new entry has been
+ * requested from the toolbar or a setting affecting the layout of the view has changed.
+ */
+LogbookTableEditWidget *MainWindow::getLogbookWidget()
+{
+    if (logbookWidget == nullptr) {
+        QElapsedTimer timer;
+        timer.start();
+        logbookWidget = new LogbookTableEditWidget(this);
+        logbookWidget->init();
+        QObject::connect(this,			 &MainWindow::settingChanged,
+                         logbookWidget,  &LogbookTableEditWidget::viewSelectionChanged);
+        QObject::connect(this,			 &MainWindow::addFlightEntryRequested,
+                         logbookWidget,  &LogbookTableEditWidget::addEntryRequested);
+        QObject::connect(this,			 &MainWindow::addSimulatorEntryRequested,
+                         logbookWidget,  &LogbookTableEditWidget::addSimulatorEntryRequested);
+        addPage(logbookWidget, timer);
+    }
+    return logbookWidget;
+}
+
+TableEditWidget *MainWindow::getTailsWidget()
+{
+    if (tailsWidget == nullptr) {
+        QElapsedTimer timer;
+        timer.start();
+        tailsWidget = new TailTableEditWidget(this);
+        tailsWidget->init();
+        addPage(tailsWidget, timer);
+    }
+    return tailsWidget;
+}
 
-    pilotsWidget = new PilotTableEditWidget(this);
-    pilotsWidget->init();
-    ui->stackedWidget->addWidget(pilotsWidget);
+TableEditWidget *MainWindow::getPilotsWidget()
+{
+    if (pilotsWidget == nullptr) {
+        QElapsedTimer timer;
+        timer.start();
+        pilotsWidget = new PilotTableEditWidget(this);
+        pilotsWidget->init();
+        addPage(pilotsWidget, timer);
+    }
+    return pilotsWidget;
+}
 
-    airportWidget = new AirportTableEditWidget(this);
-    airportWidget->init();
-    ui->stackedWidget->addWidget(airportWidget);
+TableEditWidget *MainWindow::getAirportWidget()
+{
+    if (airportWidget == nullptr) {
+        QElapsedTimer timer;
+        timer.start();
+        airportWidget = new AirportTableEditWidget(this);
+        airportWidget->init();
+        addPage(airportWidget, timer);
+    }
+    return airportWidget;
+}
 
-    settingsWidget = new SettingsWidget(this);
-    ui->stackedWidget->addWidget(settingsWidget);
+/*!
+ * \brief Returns the settings widget, constructing it on first use.
+ * \details Setting changes are relayed through MainWindow::settingChanged, so that widgets
+ * which are constructed at a later point in time still receive them.
+ */
+SettingsWidget *MainWindow::getSettingsWidget()
+{
+    if (settingsWidget == nullptr) {
+        QElapsedTimer timer;
+        timer.start();
+        settingsWidget = new SettingsWidget(this);
+        QObject::connect(settingsWidget, &SettingsWidget::settingChanged,
+                         this,           &MainWindow::settingChanged);
+        addPage(settingsWidget, timer);
+    }
+    return settingsWidget;
+}
 
-    debugWidget = new DebugWidget(this);
-    ui->stackedWidget->addWidget(debugWidget);
+DebugWidget *MainWindow::getDebugWidget()
+{
+    if (debugWidget == nullptr) {
+        QElapsedTimer timer;
+        timer.start();
+        debugWidget = new DebugWidget(this);
+        addPage(debugWidget, timer);
+    }
+    return debugWidget;
 }
 
 void MainWindow::connectDatabase()
@@ -129,9 +221,13 @@ void MainWindow::connectDatabase()
         WARN(tr("Error establishing database connection. The following error has ocurred:<br><br>%1")
              .arg(DB->lastError.text()));
     }
+}
 
-    // Load Cache
+void MainWindow::loadDatabaseCache()
+{
     DBCache->init();
+    OPL::FlightStore::instance()->init();
+    OPL::FlightPredictor::instance()->init();
 }
 
 void MainWindow::setActionIcons(OPL::Style::StyleType style)
@@ -171,23 +267,6 @@ void MainWindow::nope()
     message_box.exec();
 }
 
-/*!
- * \brief Connect the widgets to signals that are emitted when an update of the widegts' contents,
- * is required, either because the database has changed (model and view need to be refreshed) or
- * because a setting that affects the widgets layout has changed.
- */
-void MainWindow::connectWidgets()
-{
-    QObject::connect(settingsWidget, &SettingsWidget::settingChanged,
-                     logbookWidget,  &LogbookTableEditWidget::viewSelectionChanged);
-    QObject::connect(this,			 &MainWindow::addFlightEntryRequested,
-                     logbookWidget,  &LogbookTableEditWidget::addEntryRequested);
-    QObject::connect(this,			 &MainWindow::addSimulatorEntryRequested,
-                     logbookWidget,  &LogbookTableEditWidget::addSimulatorEntryRequested);
-    QObject::connect(settingsWidget, &SettingsWidget::settingChanged,
-                     this,           &MainWindow::onStyleChanged);
-}
-
 void MainWindow::onDatabaseInvalid()
 {
     QMessageBox db_error(this);
@@ -233,12 +312,12 @@ void MainWindow::onDatabaseInvalid()
 
 void MainWindow::on_actionHome_triggered()
 {
-    ui->stackedWidget->setCurrentWidget(homeWidget);
+    ui->stackedWidget->setCurrentWidget(getHomeWidget());
 }
 
 void MainWindow::on_actionNewFlight_triggered()
 {
-    ui->stackedWidget->setCurrentWidget(logbookWidget);
+    ui->stackedWidget->setCurrentWidget(getLogbookWidget());
     emit addFlightEntryRequested();
 }
 
@@ -246,33 +325,33 @@ void MainWindow::on_actionNewSim_triggered()
 {
     // auto nsd = NewSimDialog(this);
     // nsd.exec();
-    ui->stackedWidget->setCurrentWidget(logbookWidget);
+    ui->stackedWidget->setCurrentWidget(getLogbookWidget());
     emit addSimulatorEntryRequested();
 }
 
 void MainWindow::on_actionLogbook_triggered()
 {
-    ui->stackedWidget->setCurrentWidget(logbookWidget);
+    ui->stackedWidget->setCurrentWidget(getLogbookWidget());
 }
 
 void MainWindow::on_actionAircraft_triggered()
 {
-    ui->stackedWidget->setCurrentWidget(tailsWidget);
+    ui->stackedWidget->setCurrentWidget(getTailsWidget());
 }
 
 void MainWindow::on_actionPilots_triggered()
 {
-    ui->stackedWidget->setCurrentWidget(pilotsWidget);
+    ui->stackedWidget->setCurrentWidget(getPilotsWidget());
 }
 
 void MainWindow::on_actionAirports_triggered()
 {
-    ui->stackedWidget->setCurrentWidget(airportWidget);
+    ui->stackedWidget->setCurrentWidget(getAirportWidget());
 }
 
 void MainWindow::on_actionSettings_triggered()
 {
-    ui->stackedWidget->setCurrentWidget(settingsWidget);
+    ui->stackedWidget->setCurrentWidget(getSettingsWidget());
 }
 
 void MainWindow::on_actionQuit_triggered()
@@ -283,7 +362,7 @@ void MainWindow::on_actionQuit_triggered()
 
 void MainWindow::on_actionDebug_triggered()
 {
-    ui->stackedWidget->setCurrentWidget(debugWidget);
+    ui->stackedWidget->setCurrentWidget(getDebugWidget());
 }
 
 
@@ -28,6 +28,7 @@
 #include <QFile>
 #include <QKeyEvent>
 #include <QToolBar>
+#include <QElapsedTimer>
 
 #include <src/gui/widgets/logbooktableeditwidget.h>
 
@@ -116,31 +117,43 @@ private slots:
 private:
     Ui::MainWindow *ui;
 
-    HomeWidget* homeWidget;
+    // The stacked widget pages are constructed on first activation, see the get...Widget() functions
+    HomeWidget* homeWidget = nullptr;
 
-    LogbookTableEditWidget* logbookWidget; // This widget has a slot not present in TableEditWidget
+    LogbookTableEditWidget* logbookWidget = nullptr; // This widget has a slot not present in TableEditWidget
     
-    TableEditWidget* tailsWidget;
+    TableEditWidget* tailsWidget = nullptr;
 
-    TableEditWidget* pilotsWidget;
+    TableEditWidget* pilotsWidget = nullptr;
 
-    TableEditWidget* airportWidget;
+    TableEditWidget* airportWidget = nullptr;
 
-    SettingsWidget* settingsWidget;
+    SettingsWidget* settingsWidget = nullptr;
 
-    DebugWidget* debugWidget;
+    DebugWidget* debugWidget = nullptr;
 
     bool airportDbIsDirty = false;
 
     void init();
     void setupToolbar();
-    void initialiseWidgets();
     void connectDatabase();
+    void loadDatabaseCache();
     void setActionIcons(OPL::Style::StyleType style = OPL::Style::StyleType::Light);
 
     void nope();
 
-    void connectWidgets();
+    /*!
+     * \brief Adds a newly constructed page to the stacked widget and logs how long its construction took
+     */
+    void addPage(QWidget *page, const QElapsedTimer &timer);
+
+    HomeWidget *getHomeWidget();
+    LogbookTableEditWidget *getLogbookWidget();
+    TableEditWidget *getTailsWidget();
+    TableEditWidget *getPilotsWidget();
+    TableEditWidget *getAirportWidget();
+    SettingsWidget *getSettingsWidget();
+    DebugWidget *getDebugWidget();
 
     // Prompts the user to fix a broken database or import a backup
     void onDatabaseInvalid();
@@ -178,6 +191,10 @@ protected:
 signals:
     void addFlightEntryRequested();
     void addSimulatorEntryRequested();
+    /*!
+     * \brief Relays SettingsWidget::settingChanged to pages that are constructed after the SettingsWidget
+     */
+    void settingChanged(SettingsWidget::SettingSignal widget);
     //void closeEvent(QCloseEvent *event) override; //TODO check and prompt for creation of backup?
 };
 #endif // MAINWINDOW_H
@@ -0,0 +1,396 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "completionindex.h"
+#include "src/testing/trace.h"
+
+namespace OPL {
+
+// marks the beginning of a word in the trigram index
+static constexpr char16_t WORD_START = u'\x01';
+
+void CompletionIndex::build(const QStringList &entries, const QHash<QString, int> &scores)
+{
+    TRACE_FUNCTION("completion");
+    m_entries = entries;
+    m_keys.clear();
+    m_keys.reserve(entries.size());
+    for (const auto &entry : entries)
+        m_keys.append(fold(entry));
+
+    m_scores.fill(0, entries.size());
+    for (int i = 0; i < entries.size(); i++)
+        m_scores[i] = scores.value(entries.at(i));
+
+    buildTrie();
+    buildTrigrams();
+    computeTopHits();
+
+    m_sharedTrigrams.fill(0, entries.size());
+    m_candidates.clear();
+}
+
+void CompletionIndex::setScores(const QHash<QString, int> &scores)
+{
+    TRACE_FUNCTION("completion");
+    for (int i = 0; i < m_entries.size(); i++)
+        m_scores[i] = scores.value(m_entries.at(i));
+    computeTopHits();
+}
+
+QVector<int> CompletionIndex::complete(QStringView input, int limit) const
+{
+    QVector<int> results;
+    limit = qBound(0, limit, TOP_K);
+    if (input.isEmpty() || limit == 0 || m_nodes.isEmpty())
+        return results;
+
+    const QString key = fold(input);
+    completePrefix(key, limit, results);
+    if (results.size() < limit && key.size() >= MIN_FUZZY_LENGTH)
+        completeFuzzy(key, limit, maxDistance(key), results);
+    else if (results.size() < limit)
+        completeContains(key, limit, results);
+
+    return results;
+}
+
+QString CompletionIndex::bestMatch(QStringView input) const
+{
+    QVector<int> results;
+    if (input.isEmpty() || m_nodes.isEmpty())
+        return QString();
+
+    const QString key = fold(input);
+    completePrefix(key, 1, results);
+    if (results.isEmpty() && key.size() >= MIN_FUZZY_LENGTH)
+        completeFuzzy(key, 1, 0, results);
+    else if (results.isEmpty())
+        completeContains(key, 1, results);
+
+    if (results.isEmpty())
+        return QString();
+    return m_entries.at(results.first());
+}
+
+bool CompletionIndex::ranksBefore(const Hit &lhs, const Hit &rhs) const
+{
+    if (lhs.type != rhs.type)
+        return lhs.type < rhs.type;
+    const int lhs_score = m_scores.at(lhs.entry);
+    const int rhs_score = m_scores.at(rhs.entry);
+    if (lhs_score != rhs_score)
+        return lhs_score > rhs_score;
+    return lhs.entry < rhs.entry;
+}
+
+/*!
+ * \brief Inserts every entry and every word of an entry into the trie.
+ * \details The keys are sorted first, so that the trie can be built in a single pass: a key shares the path of
+ * its common prefix with the previous key and new nodes are always appended as the last child of their parent.
+ * The nodes are therefore stored in depth-first order and every child has a higher index than its parent.
+ */
+void CompletionIndex::buildTrie()
+{
+    struct Posting {
+        QStringView key;
+        Hit hit;
+    };
+
+    QVector<Posting> postings;
+    postings.reserve(m_keys.size());
+    for (int i = 0; i < m_keys.size(); i++) {
+        const QStringView key = m_keys.at(i);
+        for (qsizetype position = 0; position < key.size(); position++) {
+            if (position == 0)
+                postings.append({key, {i, MatchType::Prefix}});
+            else if (isSeparator(key.at(position - 1)) && !isSeparator(key.at(position)))
+                postings.append({key.mid(position), {i, MatchType::WordPrefix}});
+        }
+    }
+    std::sort(postings.begin(), postings.end(), [](const Posting &lhs, const Posting &rhs) {
+        const int comparison = lhs.key.compare(rhs.key);
+        return comparison != 0 ? comparison < 0 : lhs.hit.entry < rhs.hit.entry;
+    });
+
+    m_nodes.clear();
+    m_terminals.clear();
+    m_terminals.reserve(postings.size());
+    m_nodes.append(Node());
+
+    QVector<int> last_child = {-1};
+    QVarLengthArray<int, 64> path = {0};
+    QStringView previous;
+    for (const auto &posting : postings) {
+        const QStringView key = posting.key;
+        qsizetype common = 0;
+        const qsizetype common_max = std::min(key.size(), previous.size());
+        while (common < common_max && key.at(common) == previous.at(common))
+            common++;
+
+        path.resize(common + 1);
+        for (qsizetype depth = common; depth < key.size(); depth++) {
+            const int parent = path.back();
+            const int child = m_nodes.size();
+            Node node;
+            node.character = key.at(depth).unicode();
+            m_nodes.append(node);
+            last_child.append(-1);
+
+            if (last_child.at(parent) == -1)
+                m_nodes[parent].firstChild = child;
+            else
+                m_nodes[last_child.at(parent)].nextSibling = child;
+            last_child[parent] = child;
+            path.append(child);
+        }
+
+        // identical keys are adjacent, so the terminals of a node are a contiguous range
+        Node &node = m_nodes[path.back()];
+        if (node.terminalBegin == node.terminalEnd)
+            node.terminalBegin = m_terminals.size();
+        m_terminals.append(posting.hit);
+        node.terminalEnd = m_terminals.size();
+        previous = key;
+    }
+}
+
+void CompletionIndex::buildTrigrams()
+{
+    m_trigrams.clear();
+    for (int i = 0; i < m_keys.size(); i++) {
+        const QString &key = m_keys.at(i);
+        char16_t first = 0;
+        char16_t second = 0;
+        for (qsizetype position = 0; position < key.size(); position++) {
+            const QChar c = key.at(position);
+            if (position == 0 || (isSeparator(key.at(position - 1)) && !isSeparator(c))) {
+                // the word start marker precedes the first character of every word
+                first = second;
+                second = WORD_START;
+            }
+            if (first != 0) {
+                auto &entries = m_trigrams[trigram(first, second, c.unicode())];
+                if (entries.isEmpty() || entries.last() != i)
+                    entries.append(i);
+            }
+            first = second;
+            second = c.unicode();
+        }
+    }
+}
+
+/*!
+ * \brief Determines the TOP_K best entries of every node
+ * \details Since every child has a higher index than its parent, iterating the nodes backwards visits the children
+ * first and the best entries of a node can be merged from the entries ending in the node and the best entries of
+ * its children.
+ */
+void CompletionIndex::computeTopHits()
+{
+    m_top.clear();
+    QVector<Hit> candidates;
+    for (int n = m_nodes.size() - 1; n >= 0; n--) {
+        candidates.clear();
+        for (int t = m_nodes.at(n).terminalBegin; t < m_nodes.at(n).terminalEnd; t++)
+            candidates.append(m_terminals.at(t));
+        for (int child = m_nodes.at(n).firstChild; child != -1; child = m_nodes.at(child).nextSibling) {
+            const Node &child_node = m_nodes.at(child);
+            for (int i = 0; i < child_node.topCount; i++)
+                candidates.append(m_top.at(child_node.topBegin + i));
+        }
+        std::sort(candidates.begin(), candidates.end(), [this](const Hit &lhs, const Hit &rhs) {
+            return ranksBefore(lhs, rhs);
+        });
+
+        Node &node = m_nodes[n];
+        node.topBegin = m_top.size();
+        node.topCount = 0;
+        for (const auto &hit : qAsConst(candidates)) {
+            if (node.topCount == TOP_K)
+                break;
+            // an entry can be reached through several of its words, keep only its best hit
+            const auto begin = m_top.cbegin() + node.topBegin;
+            const bool seen = std::any_of(begin, m_top.cend(), [&hit](const Hit &top) {
+                return top.entry == hit.entry;
+            });
+            if (!seen) {
+                m_top.append(hit);
+                node.topCount++;
+            }
+        }
+    }
+}
+
+int CompletionIndex::findNode(QStringView key) const
+{
+    int node = 0;
+    for (const QChar c : key) {
+        int child = m_nodes.at(node).firstChild;
+        while (child != -1 && m_nodes.at(child).character != c.unicode())
+            child = m_nodes.at(child).nextSibling;
+        if (child == -1)
+            return -1;
+        node = child;
+    }
+    return node;
+}
+
+void CompletionIndex::completePrefix(QStringView key, int limit, QVector<int> &results) const
+{
+    const int node_index = findNode(key);
+    if (node_index == -1)
+        return;
+    const Node &node = m_nodes.at(node_index);
+    for (int i = 0; i < node.topCount && results.size() < limit; i++)
+        results.append(m_top.at(node.topBegin + i).entry);
+}
+
+void CompletionIndex::completeFuzzy(QStringView key, int limit, int max_distance, QVector<int> &results) const
+{
+    if (key.size() > MAX_FUZZY_LENGTH)
+        return;
+
+    QVarLengthArray<quint64, MAX_FUZZY_LENGTH> trigrams;
+    char16_t first = 0;
+    char16_t second = WORD_START;
+    for (const QChar c : key) {
+        if (first != 0) {
+            const quint64 gram = trigram(first, second, c.unicode());
+            if (!trigrams.contains(gram))
+                trigrams.append(gram);
+        }
+        first = second;
+        second = c.unicode();
+    }
+
+    // count the shared trigrams of every candidate
+    m_candidates.clear();
+    for (const auto gram : trigrams) {
+        const auto it = m_trigrams.constFind(gram);
+        if (it == m_trigrams.cend())
+            continue;
+        for (const int entry : *it) {
+            if (m_sharedTrigrams[entry]++ == 0)
+                m_candidates.append(entry);
+        }
+    }
+
+    // every typo destroys up to three trigrams, the word start trigram is missing for a match inside a word
+    const int min_shared = std::max(1, int(trigrams.size()) - 1 - 3 * max_distance);
+
+    struct FuzzyHit {
+        int entry;
+        int distance;
+    };
+    QVector<FuzzyHit> hits;
+    for (const int entry : qAsConst(m_candidates)) {
+        const int shared = m_sharedTrigrams.at(entry);
+        m_sharedTrigrams[entry] = 0;
+        if (shared < min_shared || results.contains(entry))
+            continue;
+        const int distance = substringDistance(key, m_keys.at(entry));
+        if (distance <= max_distance)
+            hits.append({entry, distance});
+    }
+
+    const auto count = std::min<qsizetype>(limit - results.size(), hits.size());
+    std::partial_sort(hits.begin(), hits.begin() + count, hits.end(), [this](const FuzzyHit &lhs, const FuzzyHit &rhs) {
+        if (lhs.distance != rhs.distance)
+            return lhs.distance < rhs.distance;
+        return ranksBefore({lhs.entry, MatchType::Fuzzy}, {rhs.entry, MatchType::Fuzzy});
+    });
+    for (qsizetype i = 0; i < count; i++)
+        results.append(hits.at(i).entry);
+}
+
+/*!
+ * \brief Appends the best entries containing key to results
+ * \details Used for keys shorter than MIN_FUZZY_LENGTH, which are too short for the trigram index. The keys are
+ * short, so a scan of all of them is still fast enough to run on every keystroke.
+ */
+void CompletionIndex::completeContains(QStringView key, int limit, QVector<int> &results) const
+{
+    QVector<Hit> hits;
+    for (int i = 0; i < m_keys.size(); i++) {
+        if (m_keys.at(i).contains(key) && !results.contains(i))
+            hits.append({i, MatchType::Fuzzy});
+    }
+
+    const auto count = std::min<qsizetype>(limit - results.size(), hits.size());
+    std::partial_sort(hits.begin(), hits.begin() + count, hits.end(), [this](const Hit &lhs, const Hit &rhs) {
+        return ranksBefore(lhs, rhs);
+    });
+    for (qsizetype i = 0; i < count; i++)
+        results.append(hits.at(i).entry);
+}
+
+QString CompletionIndex::fold(QStringView string)
+{
+    QString folded(string.size(), Qt::Uninitialized);
+    for (qsizetype i = 0; i < string.size(); i++)
+        folded[i] = QChar(char16_t(QChar::toCaseFolded(string.at(i).unicode())));
+    return folded;
+}
+
+/*!
+ * \brief Returns the number of typos tolerated in key. Short inputs would match almost anything with a typo,
+ * they are only found as a substring.
+ */
+int CompletionIndex::maxDistance(QStringView key)
+{
+    return key.size() <= MIN_FUZZY_LENGTH ? 0 : key.size() < 8 ? 1 : 2;
+}
+
+bool CompletionIndex::isSeparator(QChar c)
+{
+    return !c.isLetterOrNumber();
+}
+
+quint64 CompletionIndex::trigram(char16_t a, char16_t b, char16_t c)
+{
+    return (quint64(a) << 32) | (quint64(b) << 16) | quint64(c);
+}
+
+/*!
+ * \brief Returns the smallest edit distance between pattern and any substring of text (Sellers' algorithm)
+ */
+int CompletionIndex::substringDistance(QStringView pattern, QStringView text)
+{
+    QVarLengthArray<int, MAX_FUZZY_LENGTH + 1> column(pattern.size() + 1);
+    for (qsizetype i = 0; i < column.size(); i++)
+        column[i] = int(i);
+
+    int best = column.last();
+    for (const QChar t : text) {
+        // a match may start anywhere in text, so the first row is always 0
+        int diagonal = column[0];
+        column[0] = 0;
+        for (qsizetype i = 1; i < column.size(); i++) {
+            const int left = column[i];
+            const int cost = pattern.at(i - 1) == t ? 0 : 1;
+            column[i] = std::min({left + 1, column[i - 1] + 1, diagonal + cost});
+            diagonal = left;
+        }
+        best = std::min(best, column.last());
+        if (best == 0)
+            break;
+    }
+    return best;
+}
+
+} // namespace OPL
@@ -0,0 +1,134 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef COMPLETIONINDEX_H
+#define COMPLETIONINDEX_H
+#include <QtCore>
+
+namespace OPL {
+
+/*!
+ * \brief The CompletionIndex class finds and ranks completions for user input in a list of entries
+ *
+ * \details The index is built once from a list of entries (airport codes, pilot names, registrations,...) and a
+ * score for every entry, usually the number of times it has been used in the logbook. Matching is case-insensitive.
+ *
+ * A query is answered in up to two steps:
+ * <ul>
+ * <li> A prefix trie contains every entry as well as every word of an entry, so that "john" finds "Smith, John"
+ *      and "dabc" finds "D-ABCD (DABCD)". Every node of the trie keeps the TOP_K best entries below it, so a
+ *      prefix query only walks one node per input character and never looks at the other entries. </li>
+ * <li> If the trie yields less than the requested number of results, a trigram index is used to find entries
+ *      containing the input anywhere. Inputs of MIN_FUZZY_LENGTH characters must be contained exactly, one typo is
+ *      tolerated for inputs of MIN_FUZZY_LENGTH + 1 to 7 characters and two typos for longer inputs. Candidates
+ *      sharing a trigram with the input are verified with an edit distance. Shorter inputs have no trigram to look
+ *      up, entries containing them are found by scanning all keys instead. </li>
+ * </ul>
+ *
+ * Results are ranked by match type (entry starts with the input, a word starts with the input, fuzzy match), then
+ * by score and finally in the order of the entries. Fuzzy matches are ranked by their edit distance before the score.
+ *
+ * \note Queries use scratch buffers of the index, the index must only be used from a single thread.
+ */
+class CompletionIndex
+{
+public:
+    static constexpr int TOP_K = 10;
+    static constexpr int MIN_FUZZY_LENGTH = 3;
+    static constexpr int MAX_FUZZY_LENGTH = 64;
+
+    /*!
+     * \brief Builds the index for the given entries. Entries not contained in scores are scored 0.
+     */
+    void build(const QStringList &entries, const QHash<QString, int> &scores = {});
+
+    /*!
+     * \brief Updates the scores of the entries without rebuilding the trie and the trigram index
+     */
+    void setScores(const QHash<QString, int> &scores);
+
+    /*!
+     * \brief Returns the indexes of the best completions for input, best first
+     * \param limit - the maximum number of results, at most TOP_K
+     */
+    QVector<int> complete(QStringView input, int limit = TOP_K) const;
+
+    /*!
+     * \brief Returns the best completion for input or an empty string if there is none
+     * \details Unlike complete(), no typos are tolerated: the completion starts with the input, has a word starting
+     * with it or contains it. Use this to fix up user input, which must not be replaced with a different entry.
+     */
+    QString bestMatch(QStringView input) const;
+
+    const QString &entry(int index) const { return m_entries.at(index); }
+    int size() const { return m_entries.size(); }
+    bool isEmpty() const { return m_entries.isEmpty(); }
+
+private:
+    enum class MatchType : quint8 { Prefix, WordPrefix, Fuzzy };
+
+    struct Hit {
+        int entry;
+        MatchType type;
+    };
+
+    /*!
+     * \brief A node of the prefix trie. The children of a node are a linked list of siblings, the
+     * entries ending in the node and the best entries below it are ranges in m_terminals and m_top.
+     */
+    struct Node {
+        char16_t character = 0;
+        int firstChild = -1;
+        int nextSibling = -1;
+        int terminalBegin = 0;
+        int terminalEnd = 0;
+        int topBegin = 0;
+        int topCount = 0;
+    };
+
+    QStringList m_entries;
+    QVector<QString> m_keys;
+    QVector<int> m_scores;
+
+    QVector<Node> m_nodes;
+    QVector<Hit> m_terminals;
+    QVector<Hit> m_top;
+    QHash<quint64, QVector<int>> m_trigrams;
+
+    // scratch buffers for fuzzy queries, sized to the number of entries
+    mutable QVector<quint8> m_sharedTrigrams;
+    mutable QVector<int> m_candidates;
+
+    bool ranksBefore(const Hit &lhs, const Hit &rhs) const;
+    void buildTrie();
+    void buildTrigrams();
+    void computeTopHits();
+    int findNode(QStringView key) const;
+    void completePrefix(QStringView key, int limit, QVector<int> &results) const;
+    void completeFuzzy(QStringView key, int limit, int max_distance, QVector<int> &results) const;
+    void completeContains(QStringView key, int limit, QVector<int> &results) const;
+
+    static QString fold(QStringView string);
+    static bool isSeparator(QChar c);
+    static quint64 trigram(char16_t a, char16_t b, char16_t c);
+    static int maxDistance(QStringView key);
+    static int substringDistance(QStringView pattern, QStringView text);
+};
+
+} // namespace OPL
+
+#endif // COMPLETIONINDEX_H
@@ -1,49 +1,31 @@
 #include "date.h"
+#include "src/functions/datetimeparser.h"
 #include <QLocale>
 
 namespace OPL {
 
-Date::Date(int julianDay, const DateTimeFormat &format)
-    : m_format(format)
+static QDate parsedDate(int julianDay)
 {
-    m_date = QDate::fromJulianDay(julianDay);
+    return julianDay == DateTimeParser::INVALID ? QDate() : QDate::fromJulianDay(julianDay);
 }
 
-Date::Date(const QString &textDate, const DateTimeFormat &format)
-    : m_format(format)
+Date Date::fromString(const QString &textDate, const DateTimeFormat &format)
 {
     switch(format.dateFormat()) {
     case DateTimeFormat::DateFormat::Default:
-        m_date = QDate::fromString(textDate, Qt::ISODate);
-        break;
-    case DateTimeFormat::DateFormat::Custom:
-        m_date = QDate::fromString(textDate, format.dateFormatString());
-        break;
-    case DateTimeFormat::DateFormat::SystemLocale:
-        m_date = QDate::fromString(QLocale::system().dateFormat(QLocale::ShortFormat));
-        break;
-    default:
-        break;
+        return Date(parsedDate(DateTimeParser::julianDay(textDate, DateTimeParser::DateLayout::YearMonthDay)));
+    case DateTimeFormat::DateFormat::Custom: {
+        // use the fast path for common layouts
+        const auto layout = DateTimeParser::layoutFromFormat(format.dateFormatString());
+        if(layout)
+            return Date(parsedDate(DateTimeParser::julianDay(textDate, *layout)));
+        return Date(QDate::fromString(textDate, format.dateFormatString()));
     }
-}
-
-Date::Date(const QDate &date, const DateTimeFormat &format)
-    : m_format(format), m_date(date)
-{}
-
-const QString Date::toString() const
-{
-    switch (m_format.dateFormat()) {
-    case DateTimeFormat::DateFormat::Default:
-        return m_date.toString(Qt::ISODate);
     case DateTimeFormat::DateFormat::SystemLocale:
-        return m_date.toString(QLocale::system().dateFormat(QLocale::ShortFormat));
-    case DateTimeFormat::DateFormat::Custom:
-        return m_date.toString(m_format.dateFormatString());
+        return Date(QDate::fromString(textDate, QLocale::system().dateFormat(QLocale::ShortFormat)));
     default:
-        return QString();
+        return Date();
     }
 }
 
-
 } // namespace OPL
@@ -2,43 +2,49 @@
 #define DATE_H
 #include <QDate>
 #include "src/opl.h"
+#include "src/classes/datetimeformatter.h"
 namespace OPL {
 
 /*!
- * \brief The Date class wraps the QDate class.
- * \details The QDate class stores dates internally as a Julian Day number,
+ * \brief The Date class holds a date as a Julian Day number.
+ * \details Like the QDate class, dates are stored as a Julian Day number,
  * an integer count of every day in a contiguous range, with 24 November 4714 BCE
  * in the Gregorian calendar being Julian Day 0 (1 January 4713 BCE in the Julian calendar).
  *
  * Storing a given date as an integer value allows for easy conversion to localised strings
- * as well as calculations like date ranges.
+ * as well as calculations like date ranges. A Date holds nothing but the julian day, conversion
+ * to a display string is done by a DateTimeFormatter.
  *
  * Julian day is also used to store a date in the database.
  */
 class Date
 {
 public:
+    /*!
+     * \brief Create an invalid date
+     */
+    constexpr Date() = default;
+    constexpr explicit Date(int julianDay) : m_julianDay(julianDay) {}
+    explicit Date(const QDate &date) : m_julianDay(date.isValid() ? int(date.toJulianDay()) : INVALID) {}
 
-    Date() = delete;
-    Date(int julianDay, const DateTimeFormat &format);
-    Date(const QString &textDate, const DateTimeFormat &format);
-    Date(const QDate &date, const DateTimeFormat &format);
+    /*!
+     * \brief Create a Date from user input in the given format, the date is invalid if the input can not be parsed.
+     */
+    static Date fromString(const QString &textDate, const DateTimeFormat &format);
 
-    const QString toString() const;
-    const bool isValid() const { return m_date.isValid(); }
+    QString toString(const DateTimeFormatter &formatter) const { return formatter.dateString(m_julianDay); }
+    constexpr bool isValid() const { return m_julianDay != INVALID; }
 
-    const inline int toJulianDay() const { return m_date.toJulianDay(); }
-    const static inline Date today(const DateTimeFormat &format) { return Date(QDate::currentDate().toJulianDay(), format); }
-
-//    void setDateFormat(const DateFormat_ &format) {m_format = format}
-    // todo copy constructor
+    constexpr int toJulianDay() const { return m_julianDay; }
+    QDate toQDate() const { return isValid() ? QDate::fromJulianDay(m_julianDay) : QDate(); }
+    static Date today() { return Date(QDate::currentDate()); }
 
 private:
-    QDate m_date;
-    DateTimeFormat m_format;
+    static constexpr int INVALID = std::numeric_limits<int32_t>::min();
+    int32_t m_julianDay = INVALID;
 };
 
-
+static_assert(sizeof(Date) == sizeof(int32_t));
 
 } // namespace OPL
 
@@ -0,0 +1,301 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "datetimeformatter.h"
+#include <QLocale>
+
+namespace OPL {
+
+// the invalid julian day, see OPL::Date
+static constexpr int INVALID_DATE = std::numeric_limits<int32_t>::min();
+// the maximum number of characters written for a numeric field, including the sign
+static constexpr int MAX_FIELD_LENGTH = 11;
+
+/*!
+ * \brief Writes the decimal digits of value to out, zero-padded to min_digits and returns the number of characters written
+ */
+static inline qsizetype writeNumber(QChar *out, qint64 value, int min_digits)
+{
+    char16_t digits[20];
+    int count = 0;
+    do {
+        digits[count++] = u'0' + char16_t(value % 10);
+        value /= 10;
+    } while (value > 0);
+    while (count < min_digits)
+        digits[count++] = u'0';
+
+    for (int i = 0; i < count; i++)
+        out[i] = QChar(digits[count - 1 - i]);
+    return count;
+}
+
+/*!
+ * \brief Returns the length of the run of character c starting at position i
+ */
+static inline int runLength(const QString &string, qsizetype i, QChar c)
+{
+    int length = 0;
+    while (i + length < string.size() && string.at(i + length) == c)
+        length++;
+    return length;
+}
+
+/*!
+ * \brief Appends the quoted text starting at position i (the opening quote) to layout and returns the position
+ * after the closing quote. Two consecutive quotes are an escaped quote.
+ */
+template<typename Layout, typename Element>
+static qsizetype appendQuoted(const QString &string, qsizetype i, Layout &layout, Element literal)
+{
+    if (i + 1 < string.size() && string.at(i + 1) == QLatin1Char('\'')) {
+        literal.literal = QLatin1Char('\'');
+        layout.append(literal);
+        return i + 2;
+    }
+    for (i++; i < string.size(); i++) {
+        if (string.at(i) == QLatin1Char('\'')) {
+            if (i + 1 < string.size() && string.at(i + 1) == QLatin1Char('\'')) {
+                i++;
+            } else {
+                return i + 1;
+            }
+        }
+        literal.literal = string.at(i);
+        layout.append(literal);
+    }
+    return i;
+}
+
+DateTimeFormatter::DateTimeFormatter(const DateTimeFormat &format)
+    : m_format(format)
+{
+    switch (format.dateFormat()) {
+    case DateTimeFormat::DateFormat::Default:
+        m_dateFormatString = QStringLiteral("yyyy-MM-dd");
+        break;
+    case DateTimeFormat::DateFormat::SystemLocale:
+        m_dateFormatString = QLocale::system().dateFormat(QLocale::ShortFormat);
+        break;
+    case DateTimeFormat::DateFormat::Custom:
+        m_dateFormatString = format.dateFormatString();
+        break;
+    }
+    m_dateFallback = !parseDateLayout(m_dateFormatString, m_dateLayout);
+
+    switch (format.timeFormat()) {
+    case DateTimeFormat::TimeFormat::Default:
+        m_timeFallback = !parseTimeLayout(QStringLiteral("hh:mm"), m_timeLayout);
+        break;
+    case DateTimeFormat::TimeFormat::Decimal:
+        break;
+    case DateTimeFormat::TimeFormat::Custom:
+        m_timeFallback = !parseTimeLayout(format.timeFormatString(), m_timeLayout);
+        break;
+    }
+}
+
+bool DateTimeFormatter::parseDateLayout(const QString &format_string, Layout &layout)
+{
+    int length = 0;
+    for (qsizetype i = 0; i < format_string.size();) {
+        const QChar c = format_string.at(i);
+        const int run = runLength(format_string, i, c);
+        if (c == QLatin1Char('\'')) {
+            i = appendQuoted(format_string, i, layout, Element{Field::Literal, QChar()});
+            continue;
+        }
+
+        if (c == QLatin1Char('d') || c == QLatin1Char('M')) {
+            // day and month names depend on the locale
+            if (run > 2)
+                return false;
+            if (c == QLatin1Char('d'))
+                layout.append({run == 2 ? Field::Day2 : Field::Day, QChar()});
+            else
+                layout.append({run == 2 ? Field::Month2 : Field::Month, QChar()});
+            length += MAX_FIELD_LENGTH;
+            i += run;
+        } else if (c == QLatin1Char('y')) {
+            if (run != 2 && run != 4)
+                return false;
+            layout.append({run == 2 ? Field::Year2 : Field::Year4, QChar()});
+            length += MAX_FIELD_LENGTH;
+            i += run;
+        } else {
+            layout.append({Field::Literal, c});
+            i++;
+        }
+    }
+    length += layout.size();
+    return length <= BUFFER_SIZE;
+}
+
+bool DateTimeFormatter::parseTimeLayout(const QString &format_string, Layout &layout)
+{
+    int length = 0;
+    for (qsizetype i = 0; i < format_string.size();) {
+        const QChar c = format_string.at(i);
+        const int run = runLength(format_string, i, c);
+        if (c == QLatin1Char('\'')) {
+            i = appendQuoted(format_string, i, layout, Element{Field::Literal, QChar()});
+            continue;
+        }
+
+        if (c == QLatin1Char('h') || c == QLatin1Char('H') || c == QLatin1Char('m')) {
+            if (run > 2)
+                return false;
+            if (c == QLatin1Char('m'))
+                layout.append({run == 2 ? Field::Minutes2 : Field::Minutes, QChar()});
+            else
+                layout.append({run == 2 ? Field::Hours2 : Field::Hours, QChar()});
+            length += MAX_FIELD_LENGTH;
+            i += run;
+        } else if (c == QLatin1Char('s') || c == QLatin1Char('z') || c == QLatin1Char('t')
+                   || c == QLatin1Char('a') || c == QLatin1Char('A')) {
+            // seconds, milliseconds, time zones and AM/PM are left to QTime
+            return false;
+        } else {
+            layout.append({Field::Literal, c});
+            i++;
+        }
+    }
+    length += layout.size();
+    return length <= BUFFER_SIZE;
+}
+
+qsizetype DateTimeFormatter::write(const Layout &layout, int day, int month, int year, int32_t minutes, QChar *out)
+{
+    const bool negative = minutes < 0;
+    const qint64 abs_minutes = negative ? -qint64(minutes) : minutes;
+
+    qsizetype size = 0;
+    for (const auto &element : layout) {
+        switch (element.field) {
+        case Field::Literal:
+            out[size++] = element.literal;
+            break;
+        case Field::Day:
+        case Field::Day2:
+            size += writeNumber(out + size, day, element.field == Field::Day2 ? 2 : 1);
+            break;
+        case Field::Month:
+        case Field::Month2:
+            size += writeNumber(out + size, month, element.field == Field::Month2 ? 2 : 1);
+            break;
+        case Field::Year2:
+            size += writeNumber(out + size, (year < 0 ? -year : year) % 100, 2);
+            break;
+        case Field::Year4:
+            if (year < 0)
+                out[size++] = QLatin1Char('-');
+            size += writeNumber(out + size, year < 0 ? -qint64(year) : year, 4);
+            break;
+        case Field::Hours:
+        case Field::Hours2:
+            if (negative)
+                out[size++] = QLatin1Char('-');
+            size += writeNumber(out + size, abs_minutes / 60, element.field == Field::Hours2 ? 2 : 1);
+            break;
+        case Field::Minutes:
+        case Field::Minutes2:
+            size += writeNumber(out + size, abs_minutes % 60, element.field == Field::Minutes2 ? 2 : 1);
+            break;
+        }
+    }
+    return size;
+}
+
+qsizetype DateTimeFormatter::copy(QStringView string, Buffer &buffer)
+{
+    buffer.size = std::min<qsizetype>(string.size(), BUFFER_SIZE);
+    std::copy_n(string.data(), buffer.size, buffer.data.data());
+    return buffer.size;
+}
+
+QStringView DateTimeFormatter::formatDate(int julian_day, Buffer &buffer) const
+{
+    buffer.size = 0;
+    if (julian_day == INVALID_DATE)
+        return buffer.view();
+
+    if (m_dateFallback) {
+        copy(dateString(julian_day), buffer);
+        return buffer.view();
+    }
+
+    int year, month, day;
+    QDate::fromJulianDay(julian_day).getDate(&year, &month, &day);
+    // like Qt::ISODate, the default format is only defined for the years 0 to 9999
+    if (m_format.dateFormat() == DateTimeFormat::DateFormat::Default && (year < 0 || year > 9999))
+        return buffer.view();
+
+    buffer.size = write(m_dateLayout, day, month, year, 0, buffer.data.data());
+    return buffer.view();
+}
+
+QStringView DateTimeFormatter::formatTime(int32_t minutes, Buffer &buffer) const
+{
+    buffer.size = 0;
+    if (m_timeFallback) {
+        copy(timeString(minutes), buffer);
+        return buffer.view();
+    }
+
+    if (m_format.timeFormat() == DateTimeFormat::TimeFormat::Decimal) {
+        // hours with two decimals, minutes * 100 / 60 is never exactly halfway between two hundredths
+        QChar *out = buffer.data.data();
+        const qint64 abs_minutes = minutes < 0 ? -qint64(minutes) : minutes;
+        const qint64 hundredths = (abs_minutes * 5 + 1) / 3;
+        if (minutes < 0)
+            out[buffer.size++] = QLatin1Char('-');
+        buffer.size += writeNumber(out + buffer.size, hundredths / 100, 1);
+        out[buffer.size++] = QLatin1Char('.');
+        buffer.size += writeNumber(out + buffer.size, hundredths % 100, 2);
+        return buffer.view();
+    }
+
+    buffer.size = write(m_timeLayout, 0, 0, 0, minutes, buffer.data.data());
+    return buffer.view();
+}
+
+QString DateTimeFormatter::dateString(int julian_day) const
+{
+    if (m_dateFallback) {
+        if (julian_day == INVALID_DATE)
+            return QString();
+        return QDate::fromJulianDay(julian_day).toString(m_dateFormatString);
+    }
+
+    Buffer buffer;
+    return formatDate(julian_day, buffer).toString();
+}
+
+QString DateTimeFormatter::timeString(int32_t minutes) const
+{
+    if (m_timeFallback) {
+        // QTime can only represent a time of day
+        if (minutes < 0 || minutes >= 24 * 60)
+            return QString();
+        return QTime::fromMSecsSinceStartOfDay(minutes * 60000).toString(m_format.timeFormatString());
+    }
+
+    Buffer buffer;
+    return formatTime(minutes, buffer).toString();
+}
+
+} // namespace OPL
@@ -0,0 +1,115 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef DATETIMEFORMATTER_H
+#define DATETIMEFORMATTER_H
+#include "src/opl.h"
+#include <QtCore>
+#include <array>
+
+namespace OPL {
+
+/*!
+ * \brief The DateTimeFormatter class converts julian days and minutes to display strings
+ *
+ * \details Dates and times are stored as integers (julian days and minutes) and OPL::Date and OPL::Time
+ * are thin wrappers around these integers. Formatting them is done by a DateTimeFormatter, which
+ * translates the date and time format of a DateTimeFormat into a layout of fields and literals once,
+ * when it is created. Formatting a value then writes the digits straight into a Buffer on the stack:
+ *
+ * \code
+ * const OPL::DateTimeFormatter formatter(Settings::getDisplayFormat());
+ * OPL::DateTimeFormatter::Buffer buffer;
+ * writer.writeField(formatter.formatTime(minutes, buffer)); // no heap allocation
+ * label->setText(formatter.timeString(minutes));            // allocates the returned QString only
+ * \endcode
+ *
+ * Create the formatter once and keep it for as long as the format does not change, for example as a
+ * member of a delegate. Format strings containing elements which require locale data (day and month names,
+ * AM/PM) or seconds are passed on to QDate::toString() and QTime::toString() instead.
+ */
+class DateTimeFormatter
+{
+public:
+    static constexpr int BUFFER_SIZE = 64;
+
+    /*!
+     * \brief A stack buffer that holds a formatted value
+     */
+    struct Buffer {
+        std::array<QChar, BUFFER_SIZE> data;
+        qsizetype size = 0;
+
+        QStringView view() const { return QStringView(data.data(), size); }
+    };
+
+    /*!
+     * \brief Create a formatter for the given date and time format (default: ISO dates and hh:mm)
+     */
+    explicit DateTimeFormatter(const DateTimeFormat &format = DateTimeFormat());
+
+    /*!
+     * \brief Formats the julian day into buffer and returns a view on the result.
+     * \details Returns an empty view for the invalid date (INT32_MIN).
+     */
+    QStringView formatDate(int julian_day, Buffer &buffer) const;
+
+    /*!
+     * \brief Formats the minutes into buffer and returns a view on the result.
+     */
+    QStringView formatTime(int32_t minutes, Buffer &buffer) const;
+
+    /*!
+     * \brief Returns the formatted julian day
+     */
+    QString dateString(int julian_day) const;
+
+    /*!
+     * \brief Returns the formatted minutes
+     */
+    QString timeString(int32_t minutes) const;
+
+    const DateTimeFormat &format() const { return m_format; }
+
+private:
+    enum class Field : quint8 {
+        Literal,
+        Day, Day2, Month, Month2, Year2, Year4,   // date fields
+        Hours, Hours2, Minutes, Minutes2,         // time fields
+    };
+    struct Element {
+        Field field;
+        QChar literal;
+    };
+    using Layout = QVarLengthArray<Element, 16>;
+
+    DateTimeFormat m_format;
+    Layout m_dateLayout;
+    Layout m_timeLayout;
+    QString m_dateFormatString;
+    bool m_dateFallback = false;
+    bool m_timeFallback = false;
+
+    static bool parseDateLayout(const QString &format_string, Layout &layout);
+    static bool parseTimeLayout(const QString &format_string, Layout &layout);
+    static qsizetype write(const Layout &layout, int day, int month, int year, int32_t minutes, QChar *out);
+    static qsizetype copy(QStringView string, Buffer &buffer);
+};
+
+} // namespace OPL
+
+#endif // DATETIMEFORMATTER_H
@@ -18,6 +18,7 @@
 #include "jsonhelper.h"
 #include "src/database/database.h"
 #include "src/classes/paths.h"
+#include "src/database/jsontableloader.h"
 
 void JsonHelper::exportDatabase()
 {
@@ -46,9 +47,12 @@ void JsonHelper::importDatabase()
         const QString table_name = OPL::GLOBALS->getDbTableName(table);
         q.prepare(QLatin1String("DELETE FROM ") + table_name);
         q.exec();
-        const auto doc = readFileToDoc(OPL::Paths::filePath(OPL::Paths::Templates,
-                                                               table_name + QLatin1String(".json")));
-        DB->commit(doc.array(), table);
+
+        OPL::JsonTableLoader loader(table);
+        if (!loader.loadFile(OPL::Paths::filePath(OPL::Paths::Templates, table_name + QLatin1String(".json"))))
+            LOG << "Unable to import" << table_name << "-" << loader.errorString();
+        for (const auto &error : loader.rowErrors())
+            LOG << "Row" << error.row << "of" << table_name << "has not been imported:" << error.message;
     }
 }
 
@@ -32,6 +32,13 @@ public:
      * saves the result in the checksum member variable
      */
     Md5Sum(QFileInfo &file_info);
+
+    /*!
+     * \brief calculates the MD5-checksum of a block of data in memory
+     */
+    Md5Sum(const QByteArray &data)
+        : checksum(QCryptographicHash::hash(data, QCryptographicHash::Md5))
+    {};
     Md5Sum() = delete;
 
     QByteArray checksum;
@@ -58,10 +58,17 @@ public:
      */
     static const QFileInfo databaseFileInfo();
 
+    /*!
+     * \brief Relocates the Application Directory, e.g. to a temporary directory for benchmarks.
+     * \attention Has to be called before the database is accessed for the first time.
+     */
+    static void setBasePath(const QString &path) { basePath = QDir(path).absolutePath() + QDir::toNativeSeparators("/"); }
+
+private:
     /*!
      * \brief the base Path of the Application Directory. Evaluates to an XDG writable App Data location depending on the OS
      */
-    static const inline QString basePath = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + QDir::toNativeSeparators("/")
+    static inline QString basePath = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + QDir::toNativeSeparators("/")
             + ORGNAME + QDir::toNativeSeparators("/");
 };
 
@@ -1,13 +1,12 @@
 #include "styleddatedelegate.h"
-#include "src/classes/date.h"
 
 StyledDateDelegate::StyledDateDelegate(const OPL::DateTimeFormat &dateFormat, QObject *parent)
     :
     QStyledItemDelegate(parent),
-    m_format(dateFormat)
+    m_formatter(dateFormat)
 {}
 
 QString StyledDateDelegate::displayText(const QVariant &value, const QLocale &locale) const
 {
-    return OPL::Date(value.toInt(), m_format).toString();
+    return m_formatter.dateString(value.toInt());
 }
@@ -3,6 +3,7 @@
 
 #include <QStyledItemDelegate>
 #include "src/opl.h"
+#include "src/classes/datetimeformatter.h"
 
 /*!
  * \brief The StyledDateDelegate class is used to display a database date value human-readable.
@@ -17,7 +18,7 @@ public:
 
     QString displayText(const QVariant &value, const QLocale &locale) const override;
 private:
-    OPL::DateTimeFormat m_format;
+    OPL::DateTimeFormatter m_formatter;
 };
 
 #endif // STYLEDDATEDELEGATE_H
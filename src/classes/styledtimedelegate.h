@@ -2,6 +2,7 @@
 #define STYLEDTIMEDELEGATE_H
 
 #include "src/opl.h"
+#include "src/classes/datetimeformatter.h"
 #include <QStyledItemDelegate>
 
 /*!
@@ -16,7 +17,7 @@ public:
 
     QString displayText(const QVariant &value, const QLocale &locale) const override;
 private:
-    OPL::DateTimeFormat m_format;
+    OPL::DateTimeFormatter m_formatter;
 };
 
 #endif // STYLEDTIMEDELEGATE_H
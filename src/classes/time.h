@@ -2,6 +2,7 @@
 #define TIME_H
 
 #include "src/opl.h"
+#include "src/classes/datetimeformatter.h"
 #include <QtCore>
 namespace OPL {
 
@@ -10,14 +11,19 @@ namespace OPL {
  * database format.
  * \details Time data in the database is stored as an integer value of minutes, whereas the user-facing
  * time data is normally displayed in accordance with the selected DateTimeFormat, by default "hh:mm".
+ *
+ * A Time holds nothing but the minutes and can be passed around by value. Converting it to a display
+ * string is done by a DateTimeFormatter, which should be kept around when many values are formatted.
  */
 class Time
 {
 public:
-    Time() = delete;
-    Time(const DateTimeFormat &format);
-    Time(const QTime &qTime, const DateTimeFormat &format);
-    Time(int32_t minutes, const DateTimeFormat &format);;
+    /*!
+     * \brief Create an invalid time
+     */
+    constexpr Time() = default;
+    constexpr explicit Time(int32_t minutes) : m_minutes(minutes) {}
+    explicit Time(const QTime &qTime);
 
     enum TimeFrame {Day, Week, Year};
 
@@ -25,27 +31,27 @@ public:
      * @brief isValidTimeOfDay - determines whether the instance can be converted to a time hh:mm
      * @return true if the total amount of minutes does not exceed one day.
      */
-    bool isValidTimeOfDay() const;
+    constexpr bool isValidTimeOfDay() const { return isValid() && m_minutes <= MINUTES_PER_DAY; }
 
     /*!
      * \brief a time is considered valid if it has a time value of >= 0
      */
-    bool isValid() const;
+    constexpr bool isValid() const { return m_minutes >= 0; }
 
     /**
-     * @brief toString returns the time in the specified format
+     * @brief toString returns the time in the format of the formatter
      */
-    const QString toString() const;
+    QString toString(const DateTimeFormatter &formatter) const { return formatter.timeString(m_minutes); }
 
     /**
      * @brief toMinutes - returns the number of minutes in the time Object
      */
-    int32_t toMinutes() const;
+    constexpr int32_t toMinutes() const { return m_minutes; }
 
     /**
      * @brief fromString create a Time Object from a String formatted as hh:mm
      * @param timeString the input string
-     * @return the Time Object corresponding to the string, equivalent to 0 minutes if conversion fails.
+     * @return the Time Object corresponding to the string, invalid if conversion fails.
      */
     static Time fromString(const QString& timeString, const DateTimeFormat &format);
 
@@ -55,7 +61,15 @@ public:
      * \param onBlocks - the end time
      * \return The elapsed time
      */
-    static Time blockTime(const Time &offBlocks, const Time& onBlocks);
+    static constexpr Time blockTime(Time offBlocks, Time onBlocks)
+    {
+        // make sure both times are in 24h range
+        if(!offBlocks.isValidTimeOfDay() || !onBlocks.isValidTimeOfDay())
+            return Time();
+
+        // calculate the block time - we assume no flight duration exceeds 24h
+        return Time((onBlocks.m_minutes - offBlocks.m_minutes + MINUTES_PER_DAY) % MINUTES_PER_DAY);
+    }
 
     /*!
      * \brief Calculate elapsed time between two events
@@ -63,7 +77,10 @@ public:
      * \param onBlocks - The end time
      * \return the elapsed time in minutes
      */
-    static int32_t blockMinutes(const Time &offBlocks, const Time& onBlocks);
+    static constexpr int32_t blockMinutes(Time offBlocks, Time onBlocks)
+    {
+        return blockTime(offBlocks, onBlocks).toMinutes();
+    }
 
     /*!
      * \brief toMinutes returns the number of minutes in the given time frame
@@ -87,11 +104,12 @@ public:
 private:
     static constexpr int MINUTES_PER_DAY = 24 * 60;
 
-    const DateTimeFormat m_format;
-    int32_t m_minutes;
+    int32_t m_minutes = -1;
 
 };
 
+static_assert(sizeof(Time) == sizeof(int32_t));
+
 }// namespace OPL
 
 #endif // TIME_H
@@ -23,12 +23,12 @@ AircraftEntry::AircraftEntry()
     : Row(DbTable::Aircraft, 0)
 {}
 
-AircraftEntry::AircraftEntry(const RowData_T &row_data)
-    : Row(DbTable::Aircraft, 0, row_data)
+AircraftEntry::AircraftEntry(RowData_T row_data)
+    : Row(DbTable::Aircraft, 0, std::move(row_data))
 {}
 
-AircraftEntry::AircraftEntry(int row_id, const RowData_T &row_data)
-    : Row(DbTable::Aircraft, row_id, row_data)
+AircraftEntry::AircraftEntry(int row_id, RowData_T row_data)
+    : Row(DbTable::Aircraft, row_id, std::move(row_data))
 {}
 
 const QString AircraftEntry::getTableName() const
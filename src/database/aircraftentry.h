@@ -39,8 +39,8 @@ class AircraftEntry : public Row
     const static inline QString TABLE_NAME = QStringLiteral("aircraft");
 public:
     AircraftEntry();
-    AircraftEntry(const RowData_T &row_data);
-    AircraftEntry(int row_id, const RowData_T &row_data);
+    AircraftEntry(RowData_T row_data);
+    AircraftEntry(int row_id, RowData_T row_data);
     const QString getTableName() const override;
 
     /*!
@@ -23,12 +23,12 @@ AirportEntry::AirportEntry()
     : Row(DbTable::Airports, 0)
 {}
 
-AirportEntry::AirportEntry(const RowData_T &row_data)
-    : Row(DbTable::Airports, 0, row_data)
+AirportEntry::AirportEntry(RowData_T row_data)
+    : Row(DbTable::Airports, 0, std::move(row_data))
 {}
 
-AirportEntry::AirportEntry(int row_id, const RowData_T &row_data)
-    : Row(DbTable::Airports, row_id, row_data)
+AirportEntry::AirportEntry(int row_id, RowData_T row_data)
+    : Row(DbTable::Airports, row_id, std::move(row_data))
 {}
 
 const QString AirportEntry::getTableName() const
@@ -29,8 +29,8 @@ class AirportEntry : public Row
     const static inline QString TABLE_NAME = QStringLiteral("airports");
 public:
     AirportEntry();
-    AirportEntry(const RowData_T &row_data);
-    AirportEntry(int row_id, const RowData_T &row_data);
+    AirportEntry(RowData_T row_data);
+    AirportEntry(int row_id, RowData_T row_data);
     const QString getTableName() const override;
 
     /*!
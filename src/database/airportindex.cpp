@@ -0,0 +1,297 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "airportindex.h"
+#include "src/functions/calc.h"
+#include "src/functions/metrics.h"
+#include "src/testing/trace.h"
+#include <algorithm>
+
+namespace OPL {
+
+namespace {
+
+using Vector = std::array<double, 3>;
+
+Vector toVector(const Coordinates &coordinates)
+{
+    const double lat = Calc::degToRad(coordinates.lat);
+    const double lon = Calc::degToRad(coordinates.lon);
+    return {cos(lat) * cos(lon), cos(lat) * sin(lon), sin(lat)};
+}
+
+double dot(const Vector &a, const Vector &b)
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+Vector cross(const Vector &a, const Vector &b)
+{
+    return {a[1] * b[2] - a[2] * b[1],
+            a[2] * b[0] - a[0] * b[2],
+            a[0] * b[1] - a[1] * b[0]};
+}
+
+double squaredChord(const Vector &a, const Vector &b)
+{
+    const double x = a[0] - b[0];
+    const double y = a[1] - b[1];
+    const double z = a[2] - b[2];
+    return x * x + y * y + z * z;
+}
+
+/*!
+ * \brief Converts the squared chord length between two points on the unit sphere to their angular distance in radians
+ */
+double squaredChordToAngle(double squared_chord)
+{
+    return 2 * asin(std::min(1.0, sqrt(squared_chord) / 2));
+}
+
+/*!
+ * \brief Converts an angular distance in radians to the squared chord length between two points on the unit sphere
+ */
+double angleToSquaredChord(double angle)
+{
+    const double chord = 2 * sin(std::clamp(angle, 0.0, M_PI) / 2);
+    return chord * chord;
+}
+
+} // namespace
+
+int AirportIndex::size()
+{
+    ensureBuilt();
+    return m_points.size();
+}
+
+/*!
+ * \brief Calls visit(point, squared_chord) for every point in [begin, end) which may lie within bound of query
+ * \details bound is the squared chord length beyond which points are of no interest. It is taken by reference so
+ * that visit can narrow it down while the search is running, as a nearest neighbour search does. Points further
+ * away than bound may be visited as well.
+ */
+template<typename Visitor>
+void AirportIndex::search(int begin, int end, const Vector &query, const double &bound, Visitor &visit) const
+{
+    while (begin < end) {
+        const int median = begin + (end - begin) / 2;
+        const Point &point = m_points.at(median);
+        visit(point, squaredChord(query, point.position));
+
+        // descend into the half containing the query first, the other half only if it is within bound
+        const double delta = query[point.axis] - point.position[point.axis];
+        if (delta < 0) {
+            search(begin, median, query, bound, visit);
+            begin = median + 1;
+        } else {
+            search(median + 1, end, query, bound, visit);
+            end = median;
+        }
+        if (delta * delta > bound)
+            return;
+    }
+}
+
+QVector<AirportIndex::Hit> AirportIndex::nearest(const Coordinates &position, int k)
+{
+    static auto &latency = Metrics::histogram(QStringLiteral("airportindex/nearest"));
+    Metrics::LatencyScope scope(latency);
+    ensureBuilt();
+
+    QVector<Hit> hits;
+    k = std::min<int>(k, m_points.size());
+    if (k <= 0)
+        return hits;
+
+    // a max-heap of the k closest airports found so far, its top bounds the search
+    struct Candidate {
+        double squaredChord;
+        int airportId;
+        bool operator<(const Candidate &other) const { return squaredChord < other.squaredChord; }
+    };
+    QVector<Candidate> heap;
+    heap.reserve(k);
+    double bound = std::numeric_limits<double>::max();
+    auto visit = [&heap, &bound, k](const Point &point, double squared_chord) {
+        if (heap.size() == k) {
+            if (squared_chord >= bound)
+                return;
+            std::pop_heap(heap.begin(), heap.end());
+            heap.removeLast();
+        }
+        heap.append({squared_chord, point.airportId});
+        std::push_heap(heap.begin(), heap.end());
+        if (heap.size() == k)
+            bound = heap.first().squaredChord;
+    };
+    search(0, m_points.size(), toVector(position), bound, visit);
+
+    std::sort_heap(heap.begin(), heap.end());
+    hits.reserve(heap.size());
+    for (const auto &candidate : std::as_const(heap))
+        hits.append({candidate.airportId, Calc::radToNauticalMiles(squaredChordToAngle(candidate.squaredChord))});
+    return hits;
+}
+
+QVector<AirportIndex::Hit> AirportIndex::withinRadius(const Coordinates &position, double radius)
+{
+    static auto &latency = Metrics::histogram(QStringLiteral("airportindex/radius"));
+    Metrics::LatencyScope scope(latency);
+    ensureBuilt();
+
+    QVector<Hit> hits;
+    if (radius < 0)
+        return hits;
+
+    const double bound = angleToSquaredChord(Calc::nauticalMilesToRad(radius));
+    auto visit = [&hits, &bound](const Point &point, double squared_chord) {
+        if (squared_chord <= bound)
+            hits.append({point.airportId, squaredChordToAngle(squared_chord)});
+    };
+    search(0, m_points.size(), toVector(position), bound, visit);
+
+    std::sort(hits.begin(), hits.end(), [](const Hit &lhs, const Hit &rhs) { return lhs.distance < rhs.distance; });
+    for (auto &hit : hits)
+        hit.distance = Calc::radToNauticalMiles(hit.distance);
+    return hits;
+}
+
+QVector<AirportIndex::Hit> AirportIndex::alongRoute(const Coordinates &departure, const Coordinates &destination, double corridor)
+{
+    static auto &latency = Metrics::histogram(QStringLiteral("airportindex/corridor"));
+    Metrics::LatencyScope scope(latency);
+
+    const Vector a = toVector(departure);
+    const Vector b = toVector(destination);
+    Vector normal = cross(a, b);
+    const double normal_length = sqrt(dot(normal, normal));
+    // departure and destination are the same, or antipodal and the track is undefined
+    if (normal_length < 1e-12)
+        return withinRadius(departure, corridor);
+
+    ensureBuilt();
+    QVector<Hit> hits;
+    if (corridor < 0)
+        return hits;
+
+    for (auto &component : normal)
+        component /= normal_length;
+    const double track = atan2(normal_length, dot(a, b));
+    const double width = Calc::nauticalMilesToRad(corridor);
+
+    // the whole corridor lies within half the track length plus its width of the midpoint of the track
+    Vector midpoint = {a[0] + b[0], a[1] + b[1], a[2] + b[2]};
+    const double midpoint_length = sqrt(dot(midpoint, midpoint));
+    for (auto &component : midpoint)
+        component /= midpoint_length;
+    const double bound = angleToSquaredChord(track / 2 + width);
+
+    auto visit = [&](const Point &point, double squared_chord) {
+        if (squared_chord > bound)
+            return;
+        const Vector &p = point.position;
+        double distance;
+        if (dot(cross(a, p), normal) >= 0 && dot(cross(p, b), normal) >= 0) {
+            // abeam the track, the distance is the cross track distance
+            distance = fabs(asin(std::clamp(dot(p, normal), -1.0, 1.0)));
+        } else {
+            // before the departure or beyond the destination
+            distance = squaredChordToAngle(std::min(squaredChord(p, a), squaredChord(p, b)));
+        }
+        if (distance <= width)
+            hits.append({point.airportId, distance});
+    };
+    search(0, m_points.size(), midpoint, bound, visit);
+
+    std::sort(hits.begin(), hits.end(), [](const Hit &lhs, const Hit &rhs) { return lhs.distance < rhs.distance; });
+    for (auto &hit : hits)
+        hit.distance = Calc::radToNauticalMiles(hit.distance);
+    return hits;
+}
+
+void AirportIndex::build()
+{
+    TRACE_FUNCTION("cache");
+    static auto &builds = Metrics::counter(QStringLiteral("airportindex/builds"));
+    static auto &latency = Metrics::histogram(QStringLiteral("airportindex/build"));
+    Metrics::LatencyScope scope(latency);
+    builds.add();
+
+    // Listen to the database cache for updates, rebuild the index if the airports have changed
+    QObject::connect(DBCache,      &OPL::DatabaseCache::databaseCacheUpdated,
+                     this,         &OPL::AirportIndex::onDatabaseCacheUpdated,
+                     Qt::UniqueConnection);
+
+    const auto &coordinates = DBCache->getAirportCoordinatesMap();
+    m_points.clear();
+    m_points.reserve(coordinates.size());
+    for (auto it = coordinates.cbegin(); it != coordinates.cend(); ++it)
+        m_points.append({toVector(it.value()), it.key(), 0});
+
+    buildRange(0, m_points.size());
+    m_stale = false;
+}
+
+/*!
+ * \brief Arranges the points in [begin, end) as a balanced k-d tree
+ * \details The range is split at the median along the axis on which its points are spread the most. Airports are
+ * clustered on the continents, so this gives tighter subtrees than cycling through the axes.
+ */
+void AirportIndex::buildRange(int begin, int end)
+{
+    if (end - begin < 2)
+        return;
+
+    Vector min = m_points.at(begin).position;
+    Vector max = min;
+    for (int i = begin + 1; i < end; i++) {
+        const Vector &position = m_points.at(i).position;
+        for (int axis = 0; axis < 3; axis++) {
+            min[axis] = std::min(min[axis], position[axis]);
+            max[axis] = std::max(max[axis], position[axis]);
+        }
+    }
+    int split_axis = 0;
+    for (int axis = 1; axis < 3; axis++) {
+        if (max[axis] - min[axis] > max[split_axis] - min[split_axis])
+            split_axis = axis;
+    }
+
+    const int median = begin + (end - begin) / 2;
+    std::nth_element(m_points.begin() + begin, m_points.begin() + median, m_points.begin() + end,
+                     [split_axis](const Point &lhs, const Point &rhs) {
+        return lhs.position[split_axis] < rhs.position[split_axis];
+    });
+    m_points[median].axis = split_axis;
+    buildRange(begin, median);
+    buildRange(median + 1, end);
+}
+
+void AirportIndex::ensureBuilt()
+{
+    if (m_stale)
+        build();
+}
+
+void AirportIndex::onDatabaseCacheUpdated(const DbTable table)
+{
+    if (table == DbTable::Airports)
+        m_stale = true;
+}
+
+} // namespace OPL
@@ -0,0 +1,120 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef AIRPORTINDEX_H
+#define AIRPORTINDEX_H
+#include "src/opl.h"
+#include "src/database/databasecache.h"
+#include <QtCore>
+#include <array>
+
+namespace OPL {
+
+/*!
+ * \brief The AirportIndex class answers spatial queries over the airports in the database
+ *
+ * \details The airports table holds the coordinates of tens of thousands of airports, which used to be only accessible
+ * pair-wise. The AirportIndex keeps the coordinates cached in DatabaseCache::getAirportCoordinatesMap() as points on
+ * the unit sphere in a k-d tree. The straight-line (chord) distance between two points on the unit sphere grows
+ * monotonically with their great circle distance, so nearest neighbour and radius queries can be answered with plain
+ * euclidean distances and without any trigonometry while traversing the tree. The following queries are supported:
+ * <ul>
+ * <li> nearest(): the k airports closest to a position, for example to resolve a recorded position to an airport </li>
+ * <li> withinRadius(): all airports within a given distance of a position </li>
+ * <li> alongRoute(): all airports within a corridor along the great circle track between two positions,
+ *      for example to suggest alternates </li>
+ * </ul>
+ * All distances are in nautical miles and the results are sorted by distance.
+ *
+ * The index is built on the first query, so it costs nothing until it is used, and is rebuilt lazily on the next
+ * query whenever the airports in the DatabaseCache have been updated.
+ *
+ * \note The index is only accessed from the GUI thread and is not thread-safe.
+ */
+class AirportIndex : public QObject
+{
+    Q_OBJECT
+public:
+    /*!
+     * \brief An airport found by a query and its distance to the query in nautical miles
+     */
+    struct Hit {
+        int airportId = 0;
+        double distance = 0;
+    };
+
+    static AirportIndex* instance() {
+        static AirportIndex instance;
+        return &instance;
+    }
+
+    AirportIndex(AirportIndex const&) = delete;
+    void operator=(AirportIndex const&) = delete;
+
+    /*!
+     * \brief Returns the number of airports in the index
+     */
+    int size();
+
+    /*!
+     * \brief Returns the k airports closest to position
+     */
+    QVector<Hit> nearest(const Coordinates &position, int k = 1);
+
+    /*!
+     * \brief Returns all airports within radius nautical miles of position
+     */
+    QVector<Hit> withinRadius(const Coordinates &position, double radius);
+
+    /*!
+     * \brief Returns all airports within corridor nautical miles of the great circle track from departure to
+     * destination. The distance of a hit is its distance to the track.
+     */
+    QVector<Hit> alongRoute(const Coordinates &departure, const Coordinates &destination, double corridor);
+
+private:
+    AirportIndex() {};
+
+    using Vector = std::array<double, 3>;
+
+    /*!
+     * \brief A node of the k-d tree. The tree is stored implicitly: the node of a range of points is its median,
+     * the points before and after the median form the left and right subtree.
+     */
+    struct Point {
+        Vector position;
+        int airportId;
+        int axis;
+    };
+
+    bool m_stale = true;
+    QVector<Point> m_points;
+
+    void build();
+    void buildRange(int begin, int end);
+    void ensureBuilt();
+
+    template<typename Visitor>
+    void search(int begin, int end, const Vector &query, const double &bound, Visitor &visit) const;
+
+public slots:
+    void onDatabaseCacheUpdated(const OPL::DbTable table);
+};
+
+} // namespace OPL
+
+#endif // AIRPORTINDEX_H
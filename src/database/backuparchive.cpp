@@ -0,0 +1,463 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "backuparchive.h"
+#include "src/opl.h"
+#include "src/classes/md5sum.h"
+#include "src/database/database.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QSaveFile>
+#include <QTemporaryFile>
+
+namespace OPL {
+
+/*!
+ * \brief Returns the names of all columns of a table
+ */
+static QStringList tableColumns(QSqlDatabase &database, const QString &table_name)
+{
+    QStringList columns;
+    QSqlQuery query(database);
+    query.exec(QStringLiteral("PRAGMA table_info(\"%1\")").arg(table_name));
+    while (query.next())
+        columns.append(query.value(1).toString());
+    return columns;
+}
+
+static QString quotedColumns(const QStringList &columns)
+{
+    QStringList quoted_columns;
+    for (const auto &column : columns)
+        quoted_columns.append(QLatin1Char('"') + column + QLatin1Char('"'));
+    return quoted_columns.join(QLatin1Char(','));
+}
+
+/*!
+ * \brief Returns the FNV-1a hash of a serialised row. Unlike qHash() it is the same on every machine, so that
+ * backups created on different machines place their chunk boundaries identically.
+ */
+static quint64 rowHash(const QVariantList &row)
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << row;
+
+    quint64 hash = 14695981039346656037ULL;
+    for (const char byte : std::as_const(data)) {
+        hash ^= quint8(byte);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/*!
+ * \brief Returns the md5 checksum of the contents of a table in the given schema, or an empty string
+ * if the table can not be read
+ */
+static QString tableChecksum(QSqlDatabase &database, const QString &schema, const QString &table_name,
+                             const QStringList &columns)
+{
+    QSqlQuery query(database);
+    query.setForwardOnly(true);
+    if (!query.exec(QStringLiteral("SELECT %1 FROM %2.\"%3\" ORDER BY rowid")
+                    .arg(quotedColumns(columns), schema, table_name)))
+        return {};
+
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    while (query.next()) {
+        for (int column = 0; column < columns.size(); column++)
+            out << query.value(column);
+    }
+    return Md5Sum(data).hashToHex();
+}
+
+/*!
+ * \brief Attaches the template database bundled with the application as "templates"
+ * \param temp_file - SQLite can not attach a Qt resource, so the template database is extracted to this file
+ */
+static bool attachTemplates(QSqlDatabase &database, QTemporaryFile &temp_file)
+{
+    QFile resource(OPL::Assets::DATABASE_TEMPLATES);
+    if (!resource.open(QIODevice::ReadOnly) || !temp_file.open()
+            || temp_file.write(resource.readAll()) != resource.size())
+        return false;
+    temp_file.close();
+
+    QSqlQuery query(database);
+    query.prepare(QStringLiteral("ATTACH DATABASE ? AS templates"));
+    query.addBindValue(temp_file.fileName());
+    return query.exec();
+}
+
+static QStringList templateTableNames()
+{
+    QStringList table_names;
+    for (const auto table : DB->getTemplateTables())
+        table_names.append(OPL::GLOBALS->getDbTableName(table));
+    return table_names;
+}
+
+bool BackupArchive::write(QSqlDatabase &database, const QString &file_path, QString &error,
+                          const ProgressCallback &progress)
+{
+    const QDir chunk_directory(QFileInfo(file_path).absoluteDir().filePath(CHUNK_DIRECTORY));
+    if (!chunk_directory.exists() && !QDir().mkpath(chunk_directory.absolutePath())) {
+        error = QStringLiteral("Unable to create chunk directory: ") + chunk_directory.absolutePath();
+        return false;
+    }
+
+    Header header;
+    header.summary = DbSummary::databaseSummary(database.databaseName());
+
+    // template tables which still match the bundled templates are only referenced by their checksum
+    QTemporaryFile templates_file;
+    const bool templates_attached = attachTemplates(database, templates_file);
+    if (!templates_attached)
+        LOG << "Unable to attach the bundled template database, template tables are backed up in full.";
+    const QStringList template_table_names = templateTableNames();
+
+    // read all tables from the same snapshot of the database
+    database.transaction();
+    QSqlQuery query(database);
+    query.exec(QStringLiteral("SELECT name FROM main.sqlite_master WHERE type = 'table'"));
+    while (query.next())
+        header.tables.append({query.value(0).toString(), {}, {}, {}});
+
+    for (qsizetype i = 0; i < header.tables.size() && error.isEmpty(); i++) {
+        Table &table = header.tables[i];
+        table.columns = tableColumns(database, table.name);
+
+        if (templates_attached && template_table_names.contains(table.name)) {
+            const QString checksum = tableChecksum(database, QStringLiteral("main"), table.name, table.columns);
+            if (!checksum.isEmpty()
+                    && checksum == tableChecksum(database, QStringLiteral("templates"), table.name, table.columns)) {
+                table.templateChecksum = checksum;
+                if (progress)
+                    progress(i + 1, header.tables.size());
+                continue;
+            }
+        }
+
+        query.setForwardOnly(true);
+        if (!query.exec(QStringLiteral("SELECT %1 FROM main.\"%2\" ORDER BY rowid")
+                        .arg(quotedColumns(table.columns), table.name))) {
+            error = query.lastError().text();
+            break;
+        }
+
+        // Chunk boundaries are defined by the content of the rows rather than by their position, so that inserting
+        // or deleting a row only changes the chunk containing it and all following chunks are shared with older
+        // archives. A boundary is placed after a row if the rolling hash over the last rows has its low bits cleared.
+        QList<QVariantList> rows;
+        quint64 rolling_hash = 0;
+        bool has_next = query.next();
+        while (has_next) {
+            QVariantList row;
+            row.reserve(table.columns.size());
+            for (int column = 0; column < table.columns.size(); column++)
+                row.append(query.value(column));
+            rolling_hash = (rolling_hash << 1) ^ rowHash(row);
+            rows.append(row);
+
+            has_next = query.next();
+            const bool boundary = rows.size() >= MIN_ROWS_PER_CHUNK && (rolling_hash & BOUNDARY_MASK) == 0;
+            if (boundary || rows.size() == MAX_ROWS_PER_CHUNK || (!has_next && !rows.isEmpty())) {
+                const QString checksum = writeChunk(chunk_directory, rows, error);
+                if (checksum.isEmpty())
+                    break;
+                table.chunks.append(checksum);
+                rows.clear();
+            }
+        }
+
+        if (progress)
+            progress(i + 1, header.tables.size());
+    }
+    database.commit();
+    if (templates_attached)
+        query.exec(QStringLiteral("DETACH DATABASE templates"));
+
+    if (!error.isEmpty())
+        return false;
+
+    QSaveFile file(file_path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        error = file.errorString();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << MAGIC << VERSION;
+    QMap<int, QString> summary;
+    for (auto it = header.summary.constBegin(); it != header.summary.constEnd(); ++it)
+        summary.insert(static_cast<int>(it.key()), it.value());
+    out << summary << quint32(header.tables.size());
+    for (const auto &table : std::as_const(header.tables))
+        out << table.name << table.columns << table.chunks << table.templateChecksum;
+
+    if (!file.commit()) {
+        error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool BackupArchive::restore(QSqlDatabase &database, const QString &file_path, QString &error,
+                            const ProgressCallback &progress)
+{
+    Header header;
+    if (!readHeader(file_path, header)) {
+        error = QStringLiteral("Invalid backup archive: ") + file_path;
+        return false;
+    }
+
+    // template tables are restored from the bundled templates, which have to match the referenced checksum
+    QTemporaryFile templates_file;
+    bool templates_attached = false;
+    int total = 0;
+    for (const auto &table : std::as_const(header.tables)) {
+        total += table.chunks.size();
+        if (table.templateChecksum.isEmpty())
+            continue;
+
+        total++;
+        if (!templates_attached) {
+            templates_attached = attachTemplates(database, templates_file);
+            if (!templates_attached) {
+                error = QStringLiteral("Unable to read the template database bundled with this version.");
+                return false;
+            }
+        }
+        if (tableChecksum(database, QStringLiteral("templates"), table.name, table.columns) != table.templateChecksum) {
+            error = QStringLiteral("The template data referenced by the backup archive does not match the templates "
+                                   "bundled with this version: ") + table.name;
+            QSqlQuery(database).exec(QStringLiteral("DETACH DATABASE templates"));
+            return false;
+        }
+    }
+
+    QSqlQuery query(database);
+    QStringList table_names;
+    query.exec(QStringLiteral("SELECT name FROM main.sqlite_master WHERE type = 'table'"));
+    while (query.next())
+        table_names.append(query.value(0).toString());
+
+    // Foreign keys are not enabled on this connection, so the tables can be restored in any order. Tables which are
+    // not present in the archive are cleared, so that no rows of the current database are left behind. Chunks are
+    // verified as they are read, a missing or damaged chunk rolls back the whole restore.
+    if (!database.transaction()) {
+        error = database.lastError().text();
+        if (templates_attached)
+            query.exec(QStringLiteral("DETACH DATABASE templates"));
+        return false;
+    }
+    QStringList archived_table_names;
+    for (const auto &table : std::as_const(header.tables))
+        archived_table_names.append(table.name);
+    for (const auto &table_name : std::as_const(table_names)) {
+        if (archived_table_names.contains(table_name) || table_name.startsWith(QLatin1String("sqlite_")))
+            continue;
+        if (!query.exec(QStringLiteral("DELETE FROM main.\"%1\"").arg(table_name))) {
+            error = query.lastError().text();
+            break;
+        }
+    }
+
+    const QDir chunk_directory(QFileInfo(file_path).absoluteDir().filePath(CHUNK_DIRECTORY));
+    int done = 0;
+    for (const auto &table : std::as_const(header.tables)) {
+        if (!error.isEmpty())
+            break;
+        if (!table_names.contains(table.name)) {
+            done += table.chunks.size() + (table.templateChecksum.isEmpty() ? 0 : 1);
+            continue;
+        }
+
+        // only restore columns present in the current schema
+        const QStringList columns = tableColumns(database, table.name);
+        QList<int> indexes;
+        QStringList common_columns;
+        for (int i = 0; i < table.columns.size(); i++) {
+            if (columns.contains(table.columns[i])) {
+                indexes.append(i);
+                common_columns.append(table.columns[i]);
+            }
+        }
+
+        if (!query.exec(QStringLiteral("DELETE FROM main.\"%1\"").arg(table.name))) {
+            error = query.lastError().text();
+            break;
+        }
+
+        if (!table.templateChecksum.isEmpty()) {
+            if (!query.exec(QStringLiteral("INSERT INTO main.\"%1\" (%2) SELECT %2 FROM templates.\"%1\" ORDER BY rowid")
+                            .arg(table.name, quotedColumns(common_columns)))) {
+                error = query.lastError().text();
+                break;
+            }
+            if (progress)
+                progress(++done, total);
+            continue;
+        }
+
+        QSqlQuery insert(database);
+        insert.prepare(QStringLiteral("INSERT INTO main.\"%1\" (%2) VALUES (%3)")
+                       .arg(table.name, quotedColumns(common_columns),
+                            QStringList(indexes.size(), QStringLiteral("?")).join(QLatin1Char(','))));
+        for (const auto &checksum : table.chunks) {
+            QList<QVariantList> rows;
+            if (!readChunk(chunk_directory, checksum, rows)) {
+                error = QStringLiteral("Missing or damaged chunk in backup archive: ") + checksum;
+                break;
+            }
+            for (const auto &row : std::as_const(rows)) {
+                for (const int index : std::as_const(indexes))
+                    insert.addBindValue(row.value(index));
+                if (!insert.exec()) {
+                    error = insert.lastError().text();
+                    break;
+                }
+            }
+            if (!error.isEmpty())
+                break;
+
+            if (progress)
+                progress(++done, total);
+        }
+    }
+
+    // verify the restored data is consistent
+    if (error.isEmpty() && query.exec(QStringLiteral("PRAGMA foreign_key_check")) && query.next())
+        error = QStringLiteral("Restored data violates a foreign key constraint in table ") + query.value(0).toString();
+
+    if (error.isEmpty() && !database.commit())
+        error = database.lastError().text();
+    if (!error.isEmpty())
+        database.rollback();
+    if (templates_attached)
+        query.exec(QStringLiteral("DETACH DATABASE templates"));
+    return error.isEmpty();
+}
+
+QMap<DbSummaryKey, QString> BackupArchive::readSummary(const QString &file_path)
+{
+    Header header;
+    if (!readHeader(file_path, header))
+        return {};
+    return header.summary;
+}
+
+void BackupArchive::removeUnusedChunks(const QDir &directory)
+{
+    QSet<QString> referenced_chunks;
+    const auto archives = directory.entryInfoList({QLatin1Char('*') + FILE_EXTENSION}, QDir::Files);
+    for (const auto &archive : archives) {
+        Header header;
+        if (!readHeader(archive.absoluteFilePath(), header)) {
+            // rather keep unused chunks than delete chunks of an archive that could not be read
+            LOG << "Unable to read backup archive, keeping all chunks:" << archive.fileName();
+            return;
+        }
+        for (const auto &table : std::as_const(header.tables))
+            for (const auto &checksum : table.chunks)
+                referenced_chunks.insert(checksum);
+    }
+
+    QDir chunk_directory(directory.filePath(CHUNK_DIRECTORY));
+    const auto chunks = chunk_directory.entryList(QDir::Files);
+    for (const auto &chunk : chunks) {
+        if (!referenced_chunks.contains(chunk))
+            chunk_directory.remove(chunk);
+    }
+}
+
+bool BackupArchive::readHeader(const QString &file_path, Header &header)
+{
+    QFile file(file_path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magic, version, table_count;
+    in >> magic >> version;
+    if (magic != MAGIC || version == 0 || version > VERSION)
+        return false;
+
+    QMap<int, QString> summary;
+    in >> summary >> table_count;
+    for (auto it = summary.constBegin(); it != summary.constEnd(); ++it)
+        header.summary.insert(static_cast<DbSummaryKey>(it.key()), it.value());
+
+    for (quint32 i = 0; i < table_count && in.status() == QDataStream::Ok; i++) {
+        Table table;
+        in >> table.name >> table.columns >> table.chunks;
+        if (version >= 2)
+            in >> table.templateChecksum;
+        header.tables.append(table);
+    }
+    return in.status() == QDataStream::Ok;
+}
+
+QString BackupArchive::writeChunk(const QDir &chunk_directory, const QList<QVariantList> &rows, QString &error)
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << rows;
+
+    // identical chunks are only stored once
+    const QString checksum = Md5Sum(data).hashToHex();
+    const QString chunk_path = chunk_directory.filePath(checksum);
+    if (QFileInfo::exists(chunk_path))
+        return checksum;
+
+    QSaveFile file(chunk_path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        error = file.errorString();
+        return {};
+    }
+    file.write(qCompress(data));
+    if (!file.commit()) {
+        error = file.errorString();
+        return {};
+    }
+    return checksum;
+}
+
+bool BackupArchive::readChunk(const QDir &chunk_directory, const QString &checksum, QList<QVariantList> &rows)
+{
+    QFile file(chunk_directory.filePath(checksum));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    const QByteArray data = qUncompress(file.readAll());
+    if (Md5Sum(data).hashToHex() != checksum)
+        return false;
+
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_6_0);
+    in >> rows;
+    return in.status() == QDataStream::Ok;
+}
+
+} // namespace OPL
@@ -0,0 +1,122 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef BACKUPARCHIVE_H
+#define BACKUPARCHIVE_H
+#include <QtCore>
+#include <QSqlDatabase>
+#include "src/database/dbsummary.h"
+
+namespace OPL {
+
+/*!
+ * \brief The BackupArchive class reads and writes compressed, deduplicated backups of the database.
+ *
+ * \details A backup archive does not contain a full copy of the database file. Template tables (aircraft, airports)
+ * whose contents match the template database bundled with the application are not stored at all, the archive only
+ * references them by the md5 checksum of their contents. The contents of all other tables are split into chunks,
+ * which are compressed and stored in the CHUNK_DIRECTORY next to the archive. Chunk boundaries are defined by the
+ * contents of the rows (see MIN_ROWS_PER_CHUNK), so that an edit only affects the chunk containing it. Chunks are
+ * named after the md5 checksum of their contents, so a chunk is only written once and is shared among all archives
+ * that contain it. Since most edits only affect recent flights, consecutive backups share most of their chunks and
+ * the size of the backup directory grows with the amount of changes, not with the number of backups.
+ *
+ * The archive file itself only contains a summary of the database (see DbSummary), the names and columns of the
+ * backed up tables and the checksums of their chunks.
+ *
+ * An archive is restored into an existing database with a valid schema in a single transaction. The checksum of every
+ * chunk is verified as it is read, and the restore is rolled back if a chunk is missing or damaged, the referenced
+ * template data is not bundled with this version, or the restored data violates a foreign key constraint.
+ */
+class BackupArchive
+{
+public:
+    BackupArchive() = delete;
+
+    /*!
+     * \brief Reports the number of processed chunks and the total amount of chunks
+     */
+    using ProgressCallback = std::function<void(int done, int total)>;
+
+    /*!
+     * \brief Write an archive of the database to file_path
+     * \param database - an open connection to the database to be backed up
+     * \param error - contains a description of the error if the archive could not be written
+     */
+    static bool write(QSqlDatabase &database, const QString &file_path, QString &error,
+                      const ProgressCallback &progress = {});
+
+    /*!
+     * \brief Restore the archive at file_path into the database.
+     * \details The contents of all tables present in the archive and the database are replaced in a single transaction,
+     * tables which are not present in the archive are cleared.
+     * \param database - an open connection to the database to be restored
+     * \param error - contains a description of the error if the archive could not be restored
+     */
+    static bool restore(QSqlDatabase &database, const QString &file_path, QString &error,
+                        const ProgressCallback &progress = {});
+
+    /*!
+     * \brief Returns the summary of the database contained in an archive without restoring it
+     */
+    static QMap<DbSummaryKey, QString> readSummary(const QString &file_path);
+
+    /*!
+     * \brief Removes chunks from the chunk directory in directory that are not referenced by any archive.
+     */
+    static void removeUnusedChunks(const QDir &directory);
+
+    /*!
+     * \brief Returns true if file_path has the file extension of a backup archive
+     */
+    static bool isArchive(const QString &file_path) { return file_path.endsWith(FILE_EXTENSION); }
+
+    inline const static QString FILE_EXTENSION  = QStringLiteral(".oplbak");
+    inline const static QString CHUNK_DIRECTORY = QStringLiteral("chunks");
+    /*!
+     * \brief A chunk ends after a row if the rolling hash over the preceding rows has none of the BOUNDARY_MASK bits
+     * set, which gives chunks of a few hundred rows on average. Chunks are at least MIN_ROWS_PER_CHUNK and at most
+     * MAX_ROWS_PER_CHUNK rows long.
+     */
+    static constexpr int MIN_ROWS_PER_CHUNK = 64;
+    static constexpr int MAX_ROWS_PER_CHUNK = 1024;
+    static constexpr quint64 BOUNDARY_MASK = 0xFF;
+
+private:
+    struct Table {
+        QString name;
+        QStringList columns;
+        QStringList chunks;
+        QString templateChecksum;
+    };
+
+    struct Header {
+        QMap<DbSummaryKey, QString> summary;
+        QList<Table> tables;
+    };
+
+    static constexpr quint32 MAGIC = 0x4F504C42; // 'OPLB'
+    static constexpr quint32 VERSION = 2;
+
+    static bool readHeader(const QString &file_path, Header &header);
+    static QString writeChunk(const QDir &chunk_directory, const QList<QVariantList> &rows, QString &error);
+    static bool readChunk(const QDir &chunk_directory, const QString &checksum, QList<QVariantList> &rows);
+};
+
+} // namespace OPL
+
+#endif // BACKUPARCHIVE_H
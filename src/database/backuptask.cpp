@@ -0,0 +1,258 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "backuptask.h"
+#include "src/opl.h"
+#include "src/database/backuparchive.h"
+#include <QSqlQuery>
+#include <QSqlError>
+
+namespace OPL {
+
+BackupTask::BackupTask(Mode mode, const QString &database_path, const QString &file_path, QObject *parent)
+    : QObject(parent), m_mode(mode), m_databasePath(database_path), m_filePath(file_path)
+{}
+
+BackupTask::~BackupTask()
+{
+    if (m_thread != nullptr)
+        m_thread->wait();
+}
+
+void BackupTask::start()
+{
+    m_thread = QThread::create([this]{
+        const bool success = run();
+        emit finished(success);
+    });
+    m_thread->setParent(this);
+    m_thread->start();
+}
+
+bool BackupTask::run()
+{
+    // every thread needs its own connection
+    const QString connection_name = QStringLiteral("backup_connection_%1")
+            .arg(reinterpret_cast<quintptr>(QThread::currentThread()));
+    bool success = false;
+    { // scope for a temporary database connection, ensures proper cleanup when removeDatabase() is called.
+        QSqlDatabase database = QSqlDatabase::addDatabase(SQLITE_DRIVER, connection_name);
+        database.setDatabaseName(m_databasePath);
+        // wait for readers on other connections instead of failing with SQLITE_BUSY
+        database.setConnectOptions(QStringLiteral("QSQLITE_BUSY_TIMEOUT=%1").arg(BUSY_TIMEOUT));
+        if (!database.open()) {
+            m_errorString = database.lastError().text();
+        } else {
+            success = m_mode == Mode::Backup ? backup(database) : restore(database);
+            database.close();
+        }
+    }
+    QSqlDatabase::removeDatabase(connection_name);
+
+    if (!success)
+        LOG << "Backup task failed:" << m_errorString;
+    return success;
+}
+
+bool BackupTask::backup(QSqlDatabase &database)
+{
+    if (BackupArchive::isArchive(m_filePath))
+        return BackupArchive::write(database, m_filePath, m_errorString, [this](int done, int total) {
+            emit progress(done, total);
+        });
+
+    emit progress(0, 1);
+
+    // VACUUM INTO does not overwrite existing files
+    if (QFile::exists(m_filePath) && !QFile::remove(m_filePath)) {
+        m_errorString = QStringLiteral("Unable to overwrite file: ") + m_filePath;
+        return false;
+    }
+
+    QSqlQuery query(database);
+    query.prepare(QStringLiteral("VACUUM INTO ?"));
+    query.addBindValue(m_filePath);
+    if (!query.exec()) {
+        m_errorString = query.lastError().text();
+        return false;
+    }
+
+    emit progress(1, 1);
+    return true;
+}
+
+bool BackupTask::restore(QSqlDatabase &database)
+{
+    if (BackupArchive::isArchive(m_filePath))
+        return BackupArchive::restore(database, m_filePath, m_errorString, [this](int done, int total) {
+            emit progress(done, total);
+        });
+
+    QSqlQuery query(database);
+    query.prepare(QStringLiteral("ATTACH DATABASE ? AS backup"));
+    query.addBindValue(m_filePath);
+    if (!query.exec()) {
+        m_errorString = query.lastError().text();
+        return false;
+    }
+
+    if (!checkSchema(database)) {
+        query.exec(QStringLiteral("DETACH DATABASE backup"));
+        return false;
+    }
+
+    // Restore all tables present in both databases, including the autoincrement counters. Tables which are
+    // not present in the backup are cleared, so that no rows of the current database are left behind.
+    QStringList table_names;
+    query.exec(QStringLiteral("SELECT name FROM main.sqlite_master WHERE type = 'table' "
+                              "AND name IN (SELECT name FROM backup.sqlite_master WHERE type = 'table')"));
+    while (query.next())
+        table_names.append(query.value(0).toString());
+    QStringList cleared_table_names;
+    query.exec(QStringLiteral("SELECT name FROM main.sqlite_master WHERE type = 'table' "
+                              "AND name NOT IN (SELECT name FROM backup.sqlite_master WHERE type = 'table')"));
+    while (query.next())
+        cleared_table_names.append(query.value(0).toString());
+
+    int total = 0;
+    for (const auto &table_name : std::as_const(table_names)) {
+        query.exec(QStringLiteral("SELECT COUNT(*) FROM backup.\"%1\"").arg(table_name));
+        if (query.next())
+            total += query.value(0).toInt();
+    }
+    emit progress(0, total);
+
+    // Foreign keys are not enabled on this connection, so the tables can be restored in any order.
+    if (!database.transaction()) {
+        m_errorString = database.lastError().text();
+        query.exec(QStringLiteral("DETACH DATABASE backup"));
+        return false;
+    }
+    for (const auto &table_name : std::as_const(cleared_table_names)) {
+        if (!query.exec(QStringLiteral("DELETE FROM main.\"%1\"").arg(table_name))) {
+            m_errorString = query.lastError().text();
+            break;
+        }
+    }
+    int done = 0;
+    for (const auto &table_name : std::as_const(table_names)) {
+        if (!m_errorString.isEmpty())
+            break;
+        const QString columns = commonColumns(database, table_name).join(QLatin1Char(','));
+        if (!query.exec(QStringLiteral("DELETE FROM main.\"%1\"").arg(table_name))) {
+            m_errorString = query.lastError().text();
+            break;
+        }
+
+        // Copy the rows in batches, ordered by rowid
+        QSqlQuery batch_end(database);
+        batch_end.prepare(QStringLiteral("SELECT MAX(rowid), COUNT(*) FROM (SELECT rowid FROM backup.\"%1\" "
+                                         "WHERE rowid > ? ORDER BY rowid LIMIT %2)").arg(table_name).arg(BATCH_SIZE));
+        QSqlQuery insert(database);
+        insert.prepare(QStringLiteral("INSERT INTO main.\"%1\" (%2) SELECT %2 FROM backup.\"%1\" "
+                                      "WHERE rowid > ? AND rowid <= ?").arg(table_name, columns));
+        qint64 last_row_id = std::numeric_limits<qint64>::min();
+        while (m_errorString.isEmpty()) {
+            batch_end.addBindValue(last_row_id);
+            batch_end.exec();
+            if (!batch_end.next() || batch_end.value(1).toInt() == 0)
+                break;
+
+            const qint64 batch_last_row_id = batch_end.value(0).toLongLong();
+            insert.addBindValue(last_row_id);
+            insert.addBindValue(batch_last_row_id);
+            if (!insert.exec()) {
+                m_errorString = insert.lastError().text();
+                break;
+            }
+
+            done += batch_end.value(1).toInt();
+            last_row_id = batch_last_row_id;
+            emit progress(done, total);
+        }
+        if (!m_errorString.isEmpty())
+            break;
+    }
+
+    if (m_errorString.isEmpty() && !database.commit())
+        m_errorString = database.lastError().text();
+    const bool success = m_errorString.isEmpty();
+    if (!success)
+        database.rollback();
+
+    query.exec(QStringLiteral("DETACH DATABASE backup"));
+    return success;
+}
+
+bool BackupTask::checkSchema(QSqlDatabase &database)
+{
+    QSqlQuery query(database);
+    query.exec(QStringLiteral("SELECT name FROM backup.sqlite_master WHERE type = 'table' "
+                              "AND name NOT LIKE 'sqlite\\_%' ESCAPE '\\' "
+                              "AND name NOT IN (SELECT name FROM main.sqlite_master WHERE type = 'table')"));
+    if (query.next()) {
+        m_errorString = QStringLiteral("The backup contains the table %1, which is unknown to this version. "
+                                       "It has been created by a newer version of openPilotLog.")
+                .arg(query.value(0).toString());
+        return false;
+    }
+
+    QStringList table_names;
+    query.exec(QStringLiteral("SELECT name FROM main.sqlite_master WHERE type = 'table' "
+                              "AND name IN (SELECT name FROM backup.sqlite_master WHERE type = 'table')"));
+    while (query.next())
+        table_names.append(query.value(0).toString());
+
+    for (const auto &table_name : std::as_const(table_names)) {
+        QStringList columns;
+        query.exec(QStringLiteral("PRAGMA main.table_info(\"%1\")").arg(table_name));
+        while (query.next())
+            columns.append(query.value(1).toString());
+
+        query.exec(QStringLiteral("PRAGMA backup.table_info(\"%1\")").arg(table_name));
+        while (query.next()) {
+            const QString column = query.value(1).toString();
+            if (!columns.contains(column)) {
+                m_errorString = QStringLiteral("The backup contains the column %1.%2, which is unknown to this "
+                                               "version. It has been created by a newer version of openPilotLog.")
+                        .arg(table_name, column);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+QStringList BackupTask::commonColumns(QSqlDatabase &database, const QString &table_name) const
+{
+    QSqlQuery query(database);
+    QStringList backup_columns;
+    query.exec(QStringLiteral("PRAGMA backup.table_info(\"%1\")").arg(table_name));
+    while (query.next())
+        backup_columns.append(query.value(1).toString());
+
+    QStringList columns;
+    query.exec(QStringLiteral("PRAGMA main.table_info(\"%1\")").arg(table_name));
+    while (query.next()) {
+        const QString column = query.value(1).toString();
+        if (backup_columns.contains(column))
+            columns.append(QLatin1Char('"') + column + QLatin1Char('"'));
+    }
+    return columns;
+}
+
+} // namespace OPL
@@ -0,0 +1,120 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef BACKUPTASK_H
+#define BACKUPTASK_H
+#include <QtCore>
+#include <QSqlDatabase>
+
+namespace OPL {
+
+/*!
+ * \brief The BackupTask class creates or restores a backup of the database without closing the active connection.
+ *
+ * \details The task uses its own database connection, so it can be run on a worker thread while the user interface
+ * keeps using the default connection.
+ *
+ * - Creating a backup uses SQLite's <tt>VACUUM INTO</tt> statement, which writes a consistent snapshot of the database
+ * into a new file. Unlike copying the database file, this is safe while the database is in use.
+ * - Restoring a backup attaches the backup file and replaces the contents of all tables that are present in
+ * both databases in a single transaction. Rows are copied in batches of BATCH_SIZE and progress() is emitted
+ * after each batch. The schema of the active database is kept: its views, triggers and indexes are left as they
+ * are, and columns missing from an older backup get their default values. A backup with tables or columns
+ * unknown to the active database is refused, since their contents would be lost.
+ *
+ * If the backup file has the extension of a BackupArchive, a compressed and deduplicated archive is created or
+ * restored instead of a plain database file.
+ *
+ * Since the active connection is never reset, models and views only need to be refreshed after a restore, which
+ * is done by calling Database::contentsReplaced(). Before a restore, Database::prepareContentsReplacement() has to
+ * be called, so that models release the read locks of the active connection.
+ */
+class BackupTask : public QObject
+{
+    Q_OBJECT
+public:
+    enum class Mode {Backup, Restore};
+
+    /*!
+     * \brief Create a new BackupTask
+     * \param mode - determines if a backup is created or restored
+     * \param database_path - the full path to the active database
+     * \param file_path - the full path of the backup file to be created or restored
+     */
+    BackupTask(Mode mode, const QString &database_path, const QString &file_path, QObject *parent = nullptr);
+
+    /*!
+     * \brief Waits for a running task to finish
+     */
+    ~BackupTask();
+
+    /*!
+     * \brief Runs the task on a worker thread. finished() is emitted when the task is done.
+     */
+    void start();
+
+    /*!
+     * \brief Runs the task on the calling thread.
+     * \return true on success, otherwise errorString() contains a description of the error
+     */
+    bool run();
+
+    /*!
+     * \brief A description of the last error that has occurred
+     */
+    const QString &errorString() const { return m_errorString; }
+
+signals:
+    /*!
+     * \brief Emitted after every batch of rows that has been processed.
+     */
+    void progress(int done, int total);
+
+    /*!
+     * \brief Emitted when the task started with start() has finished.
+     */
+    void finished(bool success);
+
+private:
+    Mode m_mode;
+    QString m_databasePath;
+    QString m_filePath;
+    QString m_errorString;
+    QThread *m_thread = nullptr;
+
+    static constexpr int BATCH_SIZE = 1000;
+    static constexpr int BUSY_TIMEOUT = 5000; // milliseconds
+    inline const static QString SQLITE_DRIVER  = QStringLiteral("QSQLITE");
+
+    bool backup(QSqlDatabase &database);
+    bool restore(QSqlDatabase &database);
+
+    /*!
+     * \brief Returns false if the attached backup contains tables or columns which are not present in the active
+     * database, their contents could not be restored.
+     */
+    bool checkSchema(QSqlDatabase &database);
+
+    /*!
+     * \brief Returns the columns of a table that are present in the active database as well as the backup
+     */
+    QStringList commonColumns(QSqlDatabase &database, const QString &table_name) const;
+};
+
+} // namespace OPL
+
+#endif // BACKUPTASK_H
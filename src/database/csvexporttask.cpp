@@ -0,0 +1,171 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "csvexporttask.h"
+#include "src/database/databasecache.h"
+#include "src/functions/csvwriter.h"
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QSqlError>
+
+namespace OPL {
+
+CsvExportTask::CsvExportTask(const QString &database_path, const QString &view_name, const QString &file_path,
+                             QObject *parent)
+    : QObject(parent),
+      m_databasePath(database_path),
+      m_viewName(view_name),
+      m_filePath(file_path),
+      m_pilotNames(DBCache->getPilotNamesMap()),
+      m_types(DBCache->getTypesMap())
+{}
+
+CsvExportTask::~CsvExportTask()
+{
+    if (m_thread != nullptr)
+        m_thread->wait();
+}
+
+void CsvExportTask::start()
+{
+    m_thread = QThread::create([this]{
+        const bool success = run();
+        emit finished(success);
+    });
+    m_thread->setParent(this);
+    m_thread->start();
+}
+
+bool CsvExportTask::run()
+{
+    // every thread needs its own connection
+    const QString connection_name = QStringLiteral("csv_export_connection_%1")
+            .arg(reinterpret_cast<quintptr>(QThread::currentThread()));
+    bool success = false;
+    { // scope for a temporary database connection, ensures proper cleanup when removeDatabase() is called.
+        QSqlDatabase database = QSqlDatabase::addDatabase(SQLITE_DRIVER, connection_name);
+        database.setDatabaseName(m_databasePath);
+        database.setConnectOptions(QStringLiteral("QSQLITE_OPEN_READONLY"));
+        if (!database.open()) {
+            m_errorString = database.lastError().text();
+        } else {
+            success = exportView(database);
+            database.close();
+        }
+    }
+    QSqlDatabase::removeDatabase(connection_name);
+
+    if (!success)
+        LOG << "CSV export failed:" << m_errorString;
+    return success;
+}
+
+bool CsvExportTask::exportView(QSqlDatabase &database)
+{
+    // the view name can not be bound as a parameter
+    const QString escaped_name = QString(m_viewName).replace(QLatin1Char('"'), QLatin1String("\"\""));
+
+    QSqlQuery query(database);
+    query.setForwardOnly(true);
+    int total = 0;
+    if (query.exec(QStringLiteral("SELECT COUNT(*) FROM \"%1\"").arg(escaped_name)) && query.next())
+        total = query.value(0).toInt();
+    query.finish();
+
+    if (!query.exec(QStringLiteral("SELECT * FROM \"%1\"").arg(escaped_name))) {
+        m_errorString = query.lastError().text();
+        return false;
+    }
+
+    CSV::Writer writer(m_filePath);
+    if (!writer.open()) {
+        m_errorString = writer.errorString();
+        return false;
+    }
+
+    // header row
+    const QSqlRecord record = query.record();
+    const int columns = record.count();
+    for (int i = 0; i < columns; i++)
+        writer.writeField(i < m_headers.size() ? m_headers.at(i) : record.fieldName(i));
+    writer.endRow();
+
+    int done = 0;
+    emit progress(done, total);
+    while (query.next()) {
+        if (m_cancelled) {
+            writer.cancel();
+            m_errorString = QStringLiteral("Export cancelled.");
+            return false;
+        }
+        for (int i = 0; i < columns; i++)
+            writeValue(writer, i, query.value(i));
+        writer.endRow();
+
+        if (++done % PROGRESS_INTERVAL == 0)
+            emit progress(done, total);
+    }
+
+    if (query.lastError().isValid()) {
+        writer.cancel();
+        m_errorString = query.lastError().text();
+        return false;
+    }
+
+    if (!writer.close()) {
+        m_errorString = writer.errorString();
+        return false;
+    }
+    emit progress(done, done);
+    return true;
+}
+
+void CsvExportTask::writeValue(CSV::Writer &writer, int column, const QVariant &value) const
+{
+    if (value.isNull()) {
+        writer.writeField(QStringView());
+        return;
+    }
+
+    auto format = m_columnFormats.value(column, ColumnFormat::Raw);
+    bool is_number = true;
+    const int number = format == ColumnFormat::Raw ? 0 : value.toInt(&is_number);
+    if (!is_number)
+        format = ColumnFormat::Raw;
+
+    DateTimeFormatter::Buffer buffer;
+    switch (format) {
+    case ColumnFormat::Date:
+        writer.writeField(m_formatter.formatDate(number, buffer));
+        break;
+    case ColumnFormat::Time:
+        writer.writeField(m_formatter.formatTime(number, buffer));
+        break;
+    case ColumnFormat::PilotName:
+        writer.writeField(m_pilotNames.value(number));
+        break;
+    case ColumnFormat::AircraftType:
+        writer.writeField(m_types.value(number));
+        break;
+    case ColumnFormat::Raw:
+    default:
+        writer.writeField(value.toString());
+        break;
+    }
+}
+
+} // namespace OPL
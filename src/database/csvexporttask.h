@@ -0,0 +1,134 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CSVEXPORTTASK_H
+#define CSVEXPORTTASK_H
+#include <QtCore>
+#include <QSqlDatabase>
+#include "src/opl.h"
+#include "src/classes/datetimeformatter.h"
+
+namespace CSV {
+class Writer;
+}
+
+namespace OPL {
+
+/*!
+ * \brief The CsvExportTask class exports a table or view of the database to a CSV file.
+ *
+ * \details The rows are read with a forward-only cursor and written through a buffered CSV::Writer, so the
+ * export runs in constant memory regardless of the size of the logbook. The task uses its own database
+ * connection and can be run on a worker thread with start(), reporting its progress and supporting
+ * cancellation.
+ *
+ * Database values are formatted for display in the same way the logbook view does it. Use setColumnFormat()
+ * to declare which columns contain dates, times, pilot or aircraft ids.
+ */
+class CsvExportTask : public QObject
+{
+    Q_OBJECT
+public:
+    enum class ColumnFormat {Raw, Date, Time, PilotName, AircraftType};
+
+    /*!
+     * \brief Create a new CsvExportTask
+     * \param database_path - the full path to the database
+     * \param view_name - the name of the table or view to be exported
+     * \param file_path - the full path of the CSV file to be written
+     */
+    CsvExportTask(const QString &database_path, const QString &view_name, const QString &file_path,
+                  QObject *parent = nullptr);
+
+    /*!
+     * \brief Waits for a running task to finish
+     */
+    ~CsvExportTask();
+
+    /*!
+     * \brief Set the headers written in the first row. If no headers are set, the column names are used.
+     */
+    void setHeaders(const QStringList &headers) { m_headers = headers; }
+
+    /*!
+     * \brief Determines how the values of a column are formatted
+     */
+    void setColumnFormat(int column, ColumnFormat format) { m_columnFormats.insert(column, format); }
+
+    /*!
+     * \brief Set the format used for dates and times
+     */
+    void setDateTimeFormat(const DateTimeFormat &format) { m_formatter = DateTimeFormatter(format); }
+
+    /*!
+     * \brief Runs the task on a worker thread. finished() is emitted when the task is done.
+     */
+    void start();
+
+    /*!
+     * \brief Runs the task on the calling thread.
+     * \return true if the file has been written, otherwise errorString() contains a description of the error
+     */
+    bool run();
+
+    /*!
+     * \brief Requests the task to stop. The target file remains untouched.
+     */
+    void cancel() { m_cancelled = true; }
+
+    const QString &errorString() const { return m_errorString; }
+
+signals:
+    /*!
+     * \brief Emitted every PROGRESS_INTERVAL rows
+     */
+    void progress(int done, int total);
+
+    /*!
+     * \brief Emitted when the task started with start() has finished.
+     */
+    void finished(bool success);
+
+private:
+    QString m_databasePath;
+    QString m_viewName;
+    QString m_filePath;
+    QStringList m_headers;
+    QHash<int, ColumnFormat> m_columnFormats;
+    DateTimeFormatter m_formatter;
+    // copies of the cache, which must not be accessed from the worker thread
+    QHash<int, QString> m_pilotNames;
+    QHash<int, QString> m_types;
+    QString m_errorString;
+    std::atomic_bool m_cancelled = false;
+    QThread *m_thread = nullptr;
+
+    static constexpr int PROGRESS_INTERVAL = 500;
+    inline const static QString SQLITE_DRIVER  = QStringLiteral("QSQLITE");
+
+    bool exportView(QSqlDatabase &database);
+    /*!
+     * \brief Formats a database value and appends it to the current row. Dates and times are formatted
+     * into a stack buffer, so no intermediate QString is created for them. Values which are not a number
+     * are written as they are, regardless of the format of their column.
+     */
+    void writeValue(CSV::Writer &writer, int column, const QVariant &value) const;
+};
+
+} // namespace OPL
+
+#endif // CSVEXPORTTASK_H
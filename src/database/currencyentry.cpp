@@ -19,8 +19,8 @@
 
 namespace OPL {
 
-CurrencyEntry::CurrencyEntry(int row_id, const RowData_T &row_data)
-    : Row(DbTable::Currencies, row_id, row_data)
+CurrencyEntry::CurrencyEntry(int row_id, RowData_T row_data)
+    : Row(DbTable::Currencies, row_id, std::move(row_data))
 {}
 
 const QString CurrencyEntry::getTableName() const
@@ -30,9 +30,7 @@ const QString CurrencyEntry::getTableName() const
 
 void CurrencyEntry::setName(const QString &displayName)
 {
-    auto data = getData();
-    data.insert(NAME, displayName);
-    setData(data);
+    setValue(NAME, displayName);
 }
 
 const QString CurrencyEntry::getName() const
@@ -42,14 +40,12 @@ const QString CurrencyEntry::getName() const
 
 void CurrencyEntry::setExpiryDate(const Date &date)
 {
-    auto data = getData();
-    data.insert(EXPIRYDATE, date.toJulianDay());
-    setData(data);
+    setValue(EXPIRYDATE, date.toJulianDay());
 }
 
-const Date CurrencyEntry::getExpiryDate(const OPL::DateTimeFormat &format) const
+const Date CurrencyEntry::getExpiryDate() const
 {
-    return OPL::Date(getData().value(EXPIRYDATE).toInt(), format);
+    return OPL::Date(getData().value(EXPIRYDATE).toInt());
 }
 
 } // namespace OPL
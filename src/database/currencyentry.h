@@ -35,8 +35,8 @@ public:
     enum Currency {Licence = 1, TypeRating = 2, LineCheck = 3, Medical = 4, Custom1 = 5, Custom2 = 6, TakeOffLanding = 7};
 
     CurrencyEntry() = delete;
-    CurrencyEntry(const RowData_T &row_data) = delete;
-    CurrencyEntry(int row_id, const RowData_T &row_data);
+    CurrencyEntry(RowData_T row_data) = delete;
+    CurrencyEntry(int row_id, RowData_T row_data);
 
     const QString getTableName() const override;
 
@@ -44,7 +44,7 @@ public:
     const QString getName() const;
 
     void setExpiryDate(const OPL::Date &date);
-    const OPL::Date getExpiryDate(const OPL::DateTimeFormat &format) const;
+    const OPL::Date getExpiryDate() const;
 
 private:
 
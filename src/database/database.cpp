@@ -18,11 +18,53 @@
 #include "database.h"
 #include "src/opl.h"
 #include "src/classes/jsonhelper.h"
+#include "src/database/backuptask.h"
+#include "src/database/flightstore.h"
+#include "src/database/jsontableloader.h"
+#include "src/functions/metrics.h"
+#include "src/testing/trace.h"
+#include <QTemporaryFile>
 
 namespace OPL {
 
+namespace {
+
+/*!
+ * \brief Returns the counter of queries on a table
+ */
+Metrics::Counter &queryCounter(OPL::DbTable table)
+{
+    static const auto counters = [] {
+        QVector<Metrics::Counter*> result;
+        for (int i = 0; i <= int(DbTable::PreviousExperience); i++)
+            result.append(&Metrics::counter(QLatin1String("database/queries/")
+                                            + (i == 0 ? QStringLiteral("any") : GLOBALS->getDbTableName(DbTable(i)))));
+        return result;
+    }();
+    return *counters.at(int(table));
+}
+
+/*!
+ * \brief Checks that the columns of a table in the database are the columns of its schema descriptor
+ */
+template<typename Table>
+bool matchesSchema(const QHash<QString, QStringList> &table_columns)
+{
+    const QStringList columns = table_columns.value(QLatin1String(Table::TABLE_NAME));
+    if (columns.size() != Table::COLUMN_COUNT)
+        return false;
+    for (int i = 0; i < Table::COLUMN_COUNT; i++)
+        if (columns.at(i) != QLatin1String(Table::COLUMNS[i].name))
+            return false;
+    return true;
+}
+
+} // namespace
+
 bool Database::connect()
 {
+    TRACE_FUNCTION("database");
+    preparedQueries.clear();
     if (!QSqlDatabase::isDriverAvailable(SQLITE_DRIVER)) {
         LOG << "Error: No SQLITE Driver availabe.";
         return false;
@@ -45,11 +87,13 @@ bool Database::connect()
     query.prepare(QStringLiteral("PRAGMA foreign_keys = ON;"));
     query.exec();
     updateLayout();
+    emit connectionReset();
     return true;
 }
 
 void Database::disconnect()
 {
+    preparedQueries.clear();
     QString connection_name;
     {
     auto db = Database::database();
@@ -60,6 +104,17 @@ void Database::disconnect()
     LOG << "Database connection closed.";
 }
 
+void Database::contentsReplaced()
+{
+    updateLayout();
+    emit connectionReset();
+}
+
+void Database::prepareContentsReplacement()
+{
+    emit aboutToReplaceContents();
+}
+
 const QList<OPL::DbTable> &Database::getTemplateTables() const
 {
     return TEMPLATE_TABLES;
@@ -94,6 +149,14 @@ void Database::updateLayout()
         }
         tableColumns.insert(table_name, table_columns);
     }
+
+    // TypedRow relies on the column order generated from the schema
+    if (!tableNames.isEmpty()
+            && !(matchesSchema<Schema::Pilots>(tableColumns) && matchesSchema<Schema::Tails>(tableColumns)
+                 && matchesSchema<Schema::Flights>(tableColumns) && matchesSchema<Schema::Aircraft>(tableColumns)
+                 && matchesSchema<Schema::Airports>(tableColumns)))
+        LOG << "The database layout does not match the database schema this version has been built with.";
+
     emit dataBaseUpdated(DbTable::Any);
 }
 
@@ -112,8 +175,38 @@ QSqlDatabase Database::database()
     return QSqlDatabase::database(QStringLiteral("qt_sql_default_connection"));
 }
 
+QSqlQuery &Database::preparedQuery(const QString &statement)
+{
+    static auto &hits = Metrics::counter(QStringLiteral("database/statementCache/hits"));
+    static auto &misses = Metrics::counter(QStringLiteral("database/statementCache/misses"));
+    static const bool gauge_registered = [] {
+        Metrics::setGauge(QStringLiteral("database/statementCache/hitRate"), [] {
+            const qint64 total = hits.value() + misses.value();
+            return total > 0 ? double(hits.value()) / total : 0.0;
+        });
+        return true;
+    }();
+    Q_UNUSED(gauge_registered)
+
+    auto it = preparedQueries.find(statement);
+    if (it == preparedQueries.end())
+        it = preparedQueries.try_emplace(statement, database()).first;
+    // queries which have failed to prepare or execute are prepared again
+    else if (!it->second.lastError().isValid()) {
+        hits.add();
+        return it->second;
+    }
+
+    misses.add();
+    it->second.prepare(statement);
+    return it->second;
+}
+
 bool Database::commit(const OPL::Row &row)
 {
+    TRACE_FUNCTION("database");
+    static auto &commit_latency = Metrics::histogram(QStringLiteral("database/commit"));
+    const Metrics::LatencyScope latency(commit_latency);
     if (!row.isValid())
         return false;
 
@@ -125,50 +218,30 @@ bool Database::commit(const OPL::Row &row)
 
 bool Database::commit(const QJsonArray &json_arr, const OPL::DbTable table)
 {
-    // create statement
-    const QString table_name = OPL::GLOBALS->getDbTableName(table);
-    QString statement = QLatin1String("INSERT INTO ") + table_name + QLatin1String(" (");
-    QString placeholder = QStringLiteral(") VALUES (");
-    for (const auto &column_name : DB->getTableColumns(table)) {
-        statement += column_name + ',';
-        placeholder.append(QLatin1Char(':') + column_name + QLatin1Char(','));
+    TRACE_FUNCTION("database");
+    JsonTableLoader loader(table, database());
+    if (!loader.begin()) {
+        LOG << "Unable to commit JSON data: " << loader.errorString();
+        return false;
     }
-
-    statement.chop(1);
-    placeholder.chop(1);
-    placeholder.append(')');
-    statement.append(placeholder);
-
-    // Create query and commit
-    QSqlQuery q;
-    q.prepare(QStringLiteral("BEGIN EXCLUSIVE TRANSACTION"));
-    q.exec();
     for (const auto &entry : json_arr) {
-        q.prepare(statement);
-        auto object = entry.toObject();
-        const auto keys = object.keys();
-
-        for (const auto &key : keys){
-//use QMetaType for binding null value in QT >= 6
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-            object.value(key).isNull() ? q.bindValue(key, QVariant(QMetaType(QMetaType::Int))) :
-#else
-            object.value(key).isNull() ? q.bindValue(key, QVariant(QVariant::String)) :
-#endif
-                                         q.bindValue(QLatin1Char(':') + key, object.value(key).toVariant());
-        }
-        q.exec();
+        if (entry.isObject())
+            loader.addRow(entry.toObject());
+        else
+            loader.skipRow(QStringLiteral("Element is not a JSON object."));
     }
-
-    q.prepare(QStringLiteral("COMMIT"));
-    if (q.exec())
-        return true;
-    else
+    if (!loader.finish()) {
+        LOG << "Unable to commit JSON data: " << loader.errorString();
         return false;
+    }
+    for (const auto &error : loader.rowErrors())
+        LOG << "Row" << error.row << "has not been committed:" << error.message;
+    return loader.rowErrors().isEmpty();
 }
 
 bool Database::remove(const OPL::Row &row)
 {
+    TRACE_FUNCTION("database");
     if (!exists(row)) {
         LOG << "Error: Database entry not found.";
         return false;
@@ -179,8 +252,8 @@ bool Database::remove(const OPL::Row &row)
     QString statement = QLatin1String("DELETE FROM ") + table_name
             + QLatin1String(" WHERE ROWID=?");
 
-    QSqlQuery query;
-    query.prepare(statement);
+    queryCounter(row.getTable()).add();
+    QSqlQuery &query = preparedQuery(statement);
     query.addBindValue(row.getRowId());
 
     if (query.exec())
@@ -200,6 +273,7 @@ bool Database::remove(const OPL::Row &row)
 
 bool Database::removeMany(OPL::DbTable table, const QList<int> &row_id_list)
 {
+    TRACE_FUNCTION("database");
     const QString table_name = OPL::GLOBALS->getDbTableName(table);
     int errorCount = 0;
 
@@ -214,6 +288,7 @@ bool Database::removeMany(OPL::DbTable table, const QList<int> &row_id_list)
         query.prepare(statement);
         query.addBindValue(row_id);
 
+        queryCounter(table).add();
         if (!query.exec())
             errorCount++;
     }
@@ -242,14 +317,15 @@ bool Database::removeMany(OPL::DbTable table, const QList<int> &row_id_list)
 
 bool Database::exists(const OPL::Row &row)
 {
+    TRACE_FUNCTION("database");
     if (row.getRowId() == 0)
         return false;
 
     //Check database for row id
     QString statement = QLatin1String("SELECT COUNT(*) FROM ") + OPL::GLOBALS->getDbTableName(row.getTable())
             + QLatin1String(" WHERE ROWID=?");
-    QSqlQuery query;
-    query.prepare(statement);
+    queryCounter(row.getTable()).add();
+    QSqlQuery &query = preparedQuery(statement);
     query.addBindValue(row.getRowId());
     query.setForwardOnly(true);
     query.exec();
@@ -261,6 +337,7 @@ bool Database::exists(const OPL::Row &row)
     }
     query.next();
     int rowId = query.value(0).toInt();
+    query.finish();
     if (rowId) {
         return true;
     } else {
@@ -271,6 +348,7 @@ bool Database::exists(const OPL::Row &row)
 
 bool Database::clear()
 {
+    TRACE_FUNCTION("database");
     QSqlQuery q;
 
     for (const auto &table : USER_TABLES) {
@@ -286,6 +364,7 @@ bool Database::clear()
 
 bool Database::update(const OPL::Row &updated_row)
 {
+    TRACE_FUNCTION("database");
     QString statement = QLatin1String("UPDATE ") + OPL::GLOBALS->getDbTableName(updated_row.getTable()) + QLatin1String(" SET ");
     const auto& data = updated_row.getData();
     for (auto i = data.constBegin(); i != data.constEnd(); ++i) {
@@ -293,8 +372,8 @@ bool Database::update(const OPL::Row &updated_row)
     }
     statement.chop(1);
     statement.append(QLatin1String(" WHERE ROWID=?"));
-    QSqlQuery query;
-    query.prepare(statement);
+    queryCounter(updated_row.getTable()).add();
+    QSqlQuery &query = preparedQuery(statement);
     DEB << "Statement: " << statement;
     for (auto i = data.constBegin(); i != data.constEnd(); ++i) {
 //use QMetaType for binding null value in QT >= 6
@@ -315,7 +394,7 @@ bool Database::update(const OPL::Row &updated_row)
 
     if (query.exec())
     {
-        LOG << QString("Entry successfully committed. %1").arg(updated_row.getPosition());
+        DEB << QString("Entry successfully committed. %1").arg(updated_row.getPosition());
         emit dataBaseUpdated(updated_row.getTable());
         return true;
     } else {
@@ -329,6 +408,7 @@ bool Database::update(const OPL::Row &updated_row)
 
 bool Database::insert(const OPL::Row &new_row)
 {
+    TRACE_FUNCTION("database");
     QString statement = QLatin1String("INSERT INTO ") + OPL::GLOBALS->getDbTableName(new_row.getTable()) + QLatin1String(" (");
     const auto& data = new_row.getData();
     for(auto i = data.cbegin(); i != data.cend(); ++i) {
@@ -343,8 +423,8 @@ bool Database::insert(const OPL::Row &new_row)
     statement.chop(1);
     statement += QLatin1Char(')');
 
-    QSqlQuery query;
-    query.prepare(statement);
+    queryCounter(new_row.getTable()).add();
+    QSqlQuery &query = preparedQuery(statement);
 
     for (auto i = data.constBegin(); i != data.constEnd(); ++i) {
 //use QMetaType for binding null value in QT >= 6
@@ -363,7 +443,7 @@ bool Database::insert(const OPL::Row &new_row)
     //check result.
     if (query.exec())
     {
-        LOG << QString("Entry successfully committed. %1").arg(new_row.getPosition());
+        DEB << QString("Entry successfully committed. %1").arg(new_row.getPosition());
         emit dataBaseUpdated(new_row.getTable());
         return true;
     } else {
@@ -378,10 +458,11 @@ bool Database::insert(const OPL::Row &new_row)
 
 OPL::Row Database::getRow(const OPL::DbTable table, const int row_id)
 {
+    TRACE_FUNCTION("database");
     QString statement = QLatin1String("SELECT * FROM ") + OPL::GLOBALS->getDbTableName(table)
             + QLatin1String(" WHERE ROWID=?");
-    QSqlQuery q;
-    q.prepare(statement);
+    queryCounter(table).add();
+    QSqlQuery &q = preparedQuery(statement);
     q.addBindValue(row_id);
     q.setForwardOnly(true);
 
@@ -395,6 +476,7 @@ OPL::Row Database::getRow(const OPL::DbTable table, const int row_id)
     RowData_T entry_data;
     if(q.next()) {
         auto r = q.record(); // retreive record
+        q.finish();
         if (r.count() == 0)  // row is empty
             return {};
 
@@ -404,16 +486,18 @@ OPL::Row Database::getRow(const OPL::DbTable table, const int row_id)
             }
         }
     }
+    q.finish();
 
-    return OPL::Row(table, row_id, entry_data);
+    return OPL::Row(table, row_id, std::move(entry_data));
 }
 
 RowData_T Database::getRowData(const OPL::DbTable table, const int row_id)
 {
+    TRACE_FUNCTION("database");
     QString statement = QLatin1String("SELECT * FROM ") + OPL::GLOBALS->getDbTableName(table)
             + QLatin1String(" WHERE ROWID=?");
-    QSqlQuery q;
-    q.prepare(statement);
+    queryCounter(table).add();
+    QSqlQuery &q = preparedQuery(statement);
     q.addBindValue(row_id);
     q.setForwardOnly(true);
 
@@ -427,6 +511,7 @@ RowData_T Database::getRowData(const OPL::DbTable table, const int row_id)
     RowData_T entry_data;
     if(q.next()) {
         auto r = q.record(); // retreive record
+        q.finish();
         if (r.count() == 0)  // row is empty
             return {};
 
@@ -436,6 +521,7 @@ RowData_T Database::getRowData(const OPL::DbTable table, const int row_id)
             }
         }
     }
+    q.finish();
 
     return entry_data;
 }
@@ -455,43 +541,52 @@ int Database::getLastEntry(OPL::DbTable table)
 
 const RowData_T Database::getTotals(bool includePreviousExperience)
 {
-    QString statement = "SELECT"
-        " SUM(tblk) AS tblk,"
-        " SUM(tSPSE) AS tSPSE,"
-        " SUM(tSPME) AS tSPME,"
-        " SUM(tMP) AS tMP,"
-        " SUM(tPIC) AS tPIC,"
-        " SUM(tSIC) AS tSIC,"
-        " SUM(tDUAL) AS tDUAL,"
-        " SUM(tFI) AS tFI,"
-        " SUM(tPICUS) AS tPICUS,"
-        " SUM(tNIGHT) AS tNIGHT,"
-        " SUM(tIFR) AS tIFR,"
-        " SUM(tSIM) AS tSIM,"
-        " SUM(toDay) AS toDay,"
-        " SUM(toNight) AS toNight,"
-        " SUM(ldgDay) AS ldgDay,"
-        " SUM(ldgNight) AS ldgNight"
-        " FROM flights";
-
+    TRACE_FUNCTION("database");
+    RowData_T entry_data;
     QSqlQuery query;
-    query.prepare(statement);
-    if (!query.exec()) {
-        DEB << "SQL error: " << query.lastError().text();
-        DEB << "Statement: " << query.lastQuery();
-        lastError = query.lastError();
-        return {}; // return invalid Row
-    }
+    QString statement;
 
-    RowData_T entry_data;
-    if(query.next()) {
-        auto r = query.record(); // retreive record
-        if (r.count() == 0)  // row is empty
-            return {};
+    // the flight store answers from memory if it is enabled
+    const auto store = FlightStore::instance();
+    if (store->isEnabled()) {
+        entry_data = store->totals();
+    } else {
+        statement = "SELECT"
+            " SUM(tblk) AS tblk,"
+            " SUM(tSPSE) AS tSPSE,"
+            " SUM(tSPME) AS tSPME,"
+            " SUM(tMP) AS tMP,"
+            " SUM(tPIC) AS tPIC,"
+            " SUM(tSIC) AS tSIC,"
+            " SUM(tDUAL) AS tDUAL,"
+            " SUM(tFI) AS tFI,"
+            " SUM(tPICUS) AS tPICUS,"
+            " SUM(tNIGHT) AS tNIGHT,"
+            " SUM(tIFR) AS tIFR,"
+            " SUM(tSIM) AS tSIM,"
+            " SUM(toDay) AS toDay,"
+            " SUM(toNight) AS toNight,"
+            " SUM(ldgDay) AS ldgDay,"
+            " SUM(ldgNight) AS ldgNight"
+            " FROM flights";
 
-        for (int i = 0; i < r.count(); i++){ // iterate through fields to get key:value map
-            if(!r.value(i).isNull()) {
-                entry_data.insert(r.fieldName(i), r.value(i));
+        query.prepare(statement);
+        if (!query.exec()) {
+            DEB << "SQL error: " << query.lastError().text();
+            DEB << "Statement: " << query.lastQuery();
+            lastError = query.lastError();
+            return {}; // return invalid Row
+        }
+
+        if(query.next()) {
+            auto r = query.record(); // retreive record
+            if (r.count() == 0)  // row is empty
+                return {};
+
+            for (int i = 0; i < r.count(); i++){ // iterate through fields to get key:value map
+                if(!r.value(i).isNull()) {
+                    entry_data.insert(r.fieldName(i), r.value(i));
+                }
             }
         }
     }
@@ -555,6 +650,7 @@ const RowData_T Database::getTotals(bool includePreviousExperience)
 
 QList<int> Database::getForeignKeyConstraints(int foreign_row_id, OPL::DbTable table)
 {
+    TRACE_FUNCTION("database");
     QString statement = QLatin1String("SELECT ROWID FROM flights WHERE ");
 
     switch (table) {
@@ -592,6 +688,7 @@ QList<int> Database::getForeignKeyConstraints(int foreign_row_id, OPL::DbTable t
 
 QVector<QVariant> Database::customQuery(QString statement, int return_values)
 {
+    TRACE_FUNCTION("database");
     QSqlQuery query(statement);
     if(!query.exec()) {
         lastError = query.lastError();
@@ -620,8 +717,10 @@ QVector<QVariant> Database::customQuery(QString statement, int return_values)
 
 QVector<RowData_T> Database::getTable(OPL::DbTable table)
 {
+    TRACE_FUNCTION("database");
     const QString query_str = QStringLiteral("SELECT * FROM ") + GLOBALS->getDbTableName(table);
 
+    queryCounter(table).add();
     QSqlQuery q;
     q.prepare(query_str);
     q.setForwardOnly(true);
@@ -650,51 +749,45 @@ QVector<RowData_T> Database::getTable(OPL::DbTable table)
 
 bool Database::createBackup(const QString& dest_file)
 {
+    TRACE_FUNCTION("database");
     LOG << "Backing up current database to: " << dest_file;
-    Database::disconnect();
-    QFile db_file(QDir::toNativeSeparators(databaseFile.absoluteFilePath()));
-
-    if (!db_file.copy(QDir::toNativeSeparators(dest_file))) {
-        LOG << "Unable to backup old database:" << db_file.errorString();
+    BackupTask task(BackupTask::Mode::Backup, databaseFile.absoluteFilePath(), dest_file);
+    if (!task.run()) {
+        LOG << "Unable to backup database:" << task.errorString();
         return false;
     }
 
-    LOG << "Backed up old database as:" << dest_file;
-    Database::connect();
-    emit connectionReset();
+    LOG << "Backed up database as:" << dest_file;
     return true;
 }
 
 bool Database::restoreBackup(const QString& backup_file)
 {
-    Database::disconnect();
+    TRACE_FUNCTION("database");
     LOG << "Restoring backup from file:" << backup_file;
 
-    QString databaseFilePath = QDir::toNativeSeparators(databaseFile.absoluteFilePath());
-    DEB << "DB File Path: " << databaseFilePath;
-    QString backupFilePath = QDir::toNativeSeparators(backup_file);
-
-    QFile dbFile(databaseFilePath);
-    if(dbFile.exists())
-        if(!dbFile.remove()) {
-            LOG << dbFile.errorString() << "Unable to remove current db file";
-            return false;
-        }
+    // The backup is restored into the existing database, which requires a valid schema
+    if (!database().isOpen() && !connect())
+        return false;
+    if (tableNames.isEmpty() && !createSchema())
+        return false;
 
-    QFile backupFile(backupFilePath);
-    if(!backupFile.copy(databaseFilePath)) {
-        LOG << backupFile.errorString() << "Could not copy" << backupFile.fileName() << " to " << databaseFilePath;
+    prepareContentsReplacement();
+    BackupTask task(BackupTask::Mode::Restore, databaseFile.absoluteFilePath(), backup_file);
+    if (!task.run()) {
+        LOG << "Unable to restore backup:" << task.errorString();
         return false;
     }
 
     LOG << "Backup successfully restored!";
-    Database::connect();
-    emit connectionReset();
+    contentsReplaced();
     return true;
 }
 
 bool Database::createSchema()
 {
+    TRACE_FUNCTION("database");
+    preparedQueries.clear();
     // Read Database layout from sql file
     QFile f(OPL::Assets::DATABASE_SCHEMA);
     if(!f.open(QIODevice::ReadOnly)) {
@@ -736,6 +829,10 @@ bool Database::createSchema()
 
 bool Database::importTemplateData(bool use_local_ressources)
 {
+    TRACE_FUNCTION("database");
+    if (use_local_ressources)
+        return importTemplateDatabase(OPL::Assets::DATABASE_TEMPLATES);
+
     for (const auto& table : DB->getTemplateTables()) {
         const QString table_name = OPL::GLOBALS->getDbTableName(table);
 
@@ -747,35 +844,93 @@ bool Database::importTemplateData(bool use_local_ressources)
             return false;
         }
 
-        //Prepare data
-        QJsonArray data_to_commit;
-        QString error_message("Error importing data ");
-
-        if (use_local_ressources) {
-            data_to_commit = JsonHelper::readFileToDoc(QLatin1String(":database/templates/")
-                                      + table_name + QLatin1String(".json")).array();
-            error_message.append(QLatin1String(" (ressource) "));
-        } else {
-            const QString file_path = OPL::Paths::filePath(OPL::Paths::Templates,
-                                                           table_name + QLatin1String(".json"));
-            data_to_commit = JsonHelper::readFileToDoc(file_path).array();
-            //data_to_commit = AJson::readFileToDoc(AStandardPaths::directory(
-            //                              AStandardPaths::Templates).absoluteFilePath(
-            //                              table_name + QLatin1String(".json"))).array();
-            error_message.append(QLatin1String(" (downloaded) "));
-        }
-
-        // commit Data from Array
-        if (!DB->commit(data_to_commit, table)) {
-            LOG << error_message;
+        // stream the downloaded file into the table
+        const QString file_path = OPL::Paths::filePath(OPL::Paths::Templates,
+                                                       table_name + QLatin1String(".json"));
+        JsonTableLoader loader(table, database());
+        if (!loader.loadFile(file_path) || !loader.rowErrors().isEmpty()) {
+            LOG << "Error importing data (downloaded) " << loader.errorString();
+            for (const auto &error : loader.rowErrors())
+                LOG << "Row" << error.row << "of" << table_name << ":" << error.message;
             return false;
         }
     } // for table_name
     return true;
 }
 
+bool Database::importTemplateDatabase(const QString &file_path)
+{
+    TRACE_FUNCTION("database");
+    // SQLite can not attach a Qt resource, so bundled databases are copied to a temporary file first
+    QTemporaryFile temp_file;
+    QString attach_path = file_path;
+    if (file_path.startsWith(QLatin1Char(':'))) {
+        QFile resource(file_path);
+        if (!resource.open(QIODevice::ReadOnly) || !temp_file.open()
+                || temp_file.write(resource.readAll()) != resource.size()) {
+            LOG << "Unable to extract template database: " << resource.errorString() << temp_file.errorString();
+            return false;
+        }
+        temp_file.close();
+        attach_path = temp_file.fileName();
+    }
+
+    QSqlDatabase db = database();
+    QSqlQuery query(db);
+    query.prepare(QStringLiteral("ATTACH DATABASE ? AS templates"));
+    query.addBindValue(attach_path);
+    if (!query.exec()) {
+        lastError = query.lastError();
+        LOG << "Unable to attach template database: " << lastError.text();
+        return false;
+    }
+
+    // Replace the contents of all template tables in one transaction. Only columns present in both
+    // the current schema and the template database are copied, so older template databases remain usable.
+    bool ok = db.transaction();
+    if (!ok) {
+        lastError = db.lastError();
+        LOG << "Unable to begin transaction: " << lastError.text();
+    }
+    for (const auto& table : std::as_const(TEMPLATE_TABLES)) {
+        if (!ok)
+            break;
+        const QString table_name = OPL::GLOBALS->getDbTableName(table);
+        QStringList template_columns;
+        query.exec(QStringLiteral("PRAGMA templates.table_info(%1)").arg(table_name));
+        while (query.next())
+            template_columns.append(query.value(1).toString());
+        QStringList common_columns;
+        for (const auto &column : getTableColumns(table)) {
+            if (template_columns.contains(column))
+                common_columns.append(column);
+        }
+        const QString columns = common_columns.join(QLatin1Char(','));
+
+        ok = query.exec(QStringLiteral("DELETE FROM main.%1").arg(table_name))
+                && query.exec(QStringLiteral("INSERT INTO main.%1 (%2) SELECT %2 FROM templates.%1")
+                              .arg(table_name, columns));
+        if (!ok) {
+            lastError = query.lastError();
+            LOG << "Error importing template data into " << table_name << ": " << lastError.text();
+            break;
+        }
+    }
+    if (ok && !db.commit()) {
+        lastError = db.lastError();
+        LOG << "Unable to commit template data: " << lastError.text();
+        ok = false;
+    }
+    if (!ok)
+        db.rollback();
+
+    query.exec(QStringLiteral("DETACH DATABASE templates"));
+    return ok;
+}
+
 bool Database::resetUserData()
 {
+    TRACE_FUNCTION("database");
     QSqlQuery query;
     for (const auto& table : DB->getUserTables()) {
         query.prepare(QLatin1String("DELETE FROM ") + OPL::GLOBALS->getDbTableName(table));
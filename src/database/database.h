@@ -41,6 +41,8 @@
 #include "src/database/tailentry.h"
 #include "src/opl.h"
 #include "src/database/row.h"
+#include "src/database/typedrow.h"
+#include <unordered_map>
 
 
 
@@ -82,6 +84,18 @@ private:
         OPL::DbTable::Airports,
     };
 
+    // Prepared queries keyed by their statement. The nodes of an unordered_map are stable, so a
+    // reference to a query remains valid while other statements are added.
+    std::unordered_map<QString, QSqlQuery> preparedQueries;
+
+    /*!
+     * \brief Returns a query for statement which has been prepared on the default connection.
+     * \details The queries are cached and reused, they must not be kept active after use, call
+     * finish() once the results of a SELECT statement have been read. The cache is cleared when the
+     * connection changes.
+     */
+    QSqlQuery &preparedQuery(const QString &statement);
+
 
 public:
     Database(const Database&) = delete;
@@ -117,6 +131,18 @@ public:
      */
     void updateLayout();
 
+    /*!
+     * \brief Updates the layout and emits connectionReset() after the contents of the database have been replaced
+     * underneath the open connection, for example by restoring a backup.
+     */
+    void contentsReplaced();
+
+    /*!
+     * \brief Emits aboutToReplaceContents(). Call before the contents of the database are replaced underneath the
+     * open connection, so that no read lock of the open connection keeps the replacement from being committed.
+     */
+    void prepareContentsReplacement();
+
     /*!
      * \brief Database::sqliteVersion returns the database sqlite version. See also dbRevision()
      * \return sqlite version string
@@ -167,6 +193,9 @@ public:
      * \brief commits data imported from JSON
      * \details This function is used to import values to the databases which are held in JSON documents.
      * These entries are pre-filled data used for providing completion data, such as Airport or Aircraft Type Data.
+     * The rows are inserted in batches by a JsonTableLoader. Use the JsonTableLoader directly to stream large
+     * files instead of reading them into a QJsonArray first.
+     * \return true if all rows have been committed
      */
     bool commit(const QJsonArray &json_arr, const OPL::DbTable table);
 
@@ -177,6 +206,8 @@ public:
 
     /*!
      * \brief Updates entry in database from existing entry tweaked by the user.
+     * \details Only the columns contained in the row are written, so a row which holds only the modified
+     * columns updates an entry in place without having to read and copy it first.
      */
     bool update(const OPL::Row &updated_row);
 
@@ -206,8 +237,7 @@ public:
      */
     inline OPL::PilotEntry getPilotEntry(int row_id)
     {
-        const auto data = getRowData(OPL::DbTable::Pilots, row_id);
-        return OPL::PilotEntry(row_id, data);
+        return OPL::PilotEntry(row_id, getRowData(OPL::DbTable::Pilots, row_id));
     }
 
     /*!
@@ -217,7 +247,7 @@ public:
     {
         auto data = getRowData(OPL::DbTable::Pilots, 1);
         data.insert(OPL::PilotEntry::ROWID, 1);
-        return OPL::PilotEntry(1, data);
+        return OPL::PilotEntry(1, std::move(data));
     }
 
     /*!
@@ -239,8 +269,7 @@ public:
      */
     inline OPL::TailEntry getTailEntry(int row_id)
     {
-        const auto data = getRowData(OPL::DbTable::Tails, row_id);
-        return OPL::TailEntry(row_id, data);
+        return OPL::TailEntry(row_id, getRowData(OPL::DbTable::Tails, row_id));
     }
 
     /*!
@@ -248,8 +277,7 @@ public:
      */
     inline OPL::AircraftEntry getAircraftEntry(int row_id)
     {
-        const auto data = getRowData(OPL::DbTable::Aircraft, row_id);
-        return OPL::AircraftEntry(row_id, data);
+        return OPL::AircraftEntry(row_id, getRowData(OPL::DbTable::Aircraft, row_id));
     }
 
     /*!
@@ -257,8 +285,7 @@ public:
      */
     inline OPL::FlightEntry getFlightEntry(int row_id)
     {
-        const auto data = getRowData(OPL::DbTable::Flights, row_id);
-        return OPL::FlightEntry(row_id, data);
+        return OPL::FlightEntry(row_id, getRowData(OPL::DbTable::Flights, row_id));
     }
 
     /*!
@@ -266,8 +293,7 @@ public:
      */
     inline OPL::SimulatorEntry getSimEntry(int row_id)
     {
-        const auto data = getRowData(OPL::DbTable::Simulators, row_id);
-        return OPL::SimulatorEntry(row_id, data);
+        return OPL::SimulatorEntry(row_id, getRowData(OPL::DbTable::Simulators, row_id));
     }
 
     /*!
@@ -275,8 +301,7 @@ public:
      */
     inline OPL::CurrencyEntry getCurrencyEntry(OPL::CurrencyEntry::Currency currency)
     {
-        const auto data = getRowData(OPL::DbTable::Currencies, currency);
-        return OPL::CurrencyEntry(currency, data);
+        return OPL::CurrencyEntry(currency, getRowData(OPL::DbTable::Currencies, currency));
     }
 
     /*!
@@ -284,8 +309,7 @@ public:
      */
     inline OPL::AirportEntry getAirportEntry(int row_id)
     {
-        const auto data = getRowData(OPL::DbTable::Airports, row_id);
-        return OPL::AirportEntry(row_id, data);
+        return OPL::AirportEntry(row_id, getRowData(OPL::DbTable::Airports, row_id));
     }
 
     /*!
@@ -305,6 +329,16 @@ public:
      */
     QVector<RowData_T> getTable(OPL::DbTable table);
 
+    /*!
+     * \brief returns all rows of a table in the fixed layout of a TypedRow
+     * \details Table is one of the descriptors in OPL::Schema. Prefer this over getTable() when
+     * reading many rows, a TypedRow needs a fraction of the memory of a RowData_T and its columns
+     * are accessed by index. The text of the rows is held by the returned TypedTable. The rows are
+     * read-only, modified rows are committed as a Row.
+     */
+    template<typename Table>
+    TypedTable<Table> getTypedTable();
+
     /*!
      * \brief getUserTables returns a list of the of the tables that contain user-created data
      * (flights, pilots,..)
@@ -327,14 +361,21 @@ public:
     bool createSchema();
     /*!
      * \brief importTemplateData fills an empty database with the template
-     * data (Aircraft, Airports) as read from the JSON
-     * templates.
-     * \param use_local_ressources determines whether the included ressource files
-     * or a previously downloaded file should be used.
+     * data (Aircraft, Airports).
+     * \param use_local_ressources determines whether the template database bundled as a
+     * ressource or previously downloaded JSON templates should be used.
      * \return
      */
     bool importTemplateData(bool use_local_ressources);
 
+    /*!
+     * \brief Replace the template tables with the contents of an SQLite template database
+     * \details The template database is generated from the JSON templates at build time (see opl_templatedb)
+     * and attached to the current connection, so that each table is filled by a single INSERT ... SELECT.
+     * \param file_path - path to the template database, may be a ressource path
+     */
+    bool importTemplateDatabase(const QString &file_path);
+
     /*!
      * \brief Delete all rows from the user data tables (flights, pliots, tails)
      */
@@ -343,12 +384,16 @@ public:
     /*!
      * \brief Database::createBackup copies the currently used database to an external backup location provided by the user
      * \param dest_file This is the full path and filename of where the backup will be created, e.g. 'home/Sully/myBackups/backupFromOpl.db'
+     * \details The backup is created with a BackupTask, the active connection remains open. Use a BackupTask
+     * directly to create the backup on a worker thread.
      */
     bool createBackup(const QString& dest_file);
 
     /*!
      * \brief Database::restoreBackup restores the database from a given backup file and replaces the currently active database.
      * \param backup_file This is the full path and filename of the backup, e.g. 'home/Sully/myBackups/backupFromOpl.db'
+     * \details The contents of the backup are copied into the active database by a BackupTask, so the
+     * connection remains open and dataBaseUpdated() is emitted once the backup has been restored.
      */
     bool restoreBackup(const QString& backup_file);
 
@@ -370,12 +415,35 @@ signals:
      */
     void dataBaseUpdated(const OPL::DbTable table);
     /*!
-     * \brief connectionReset is emitted whenever the database connection is reset, for
-     * example when creating or restoring a backup.
+     * \brief connectionReset is emitted whenever the database connection is reset or the contents of the
+     * database have been replaced as a whole. Anything derived from the database contents has to be re-read.
      */
     void connectionReset();
+    /*!
+     * \brief aboutToReplaceContents is emitted before the contents of the database are replaced as a whole. Models
+     * have to finish their queries: a model which fetches its rows lazily keeps its query open, which holds a
+     * read lock on the database.
+     */
+    void aboutToReplaceContents();
 };
 
+template<typename Table>
+TypedTable<Table> Database::getTypedTable()
+{
+    TypedTable<Table> rows;
+    QSqlQuery query(database());
+    query.setForwardOnly(true);
+    if (!query.exec(TypedRow<Table>::selectStatement())) {
+        LOG << "SQL error: " << query.lastError().text();
+        lastError = query.lastError();
+        return rows;
+    }
+
+    while (query.next())
+        rows.append(query);
+    return rows;
+}
+
 } // namespace OPL
 
 #endif // DATABASE_H
@@ -18,12 +18,15 @@
 #include "databasecache.h"
 #include "src/database/database.h"
 #include "src/opl.h"
+#include "src/functions/metrics.h"
+#include "src/testing/trace.h"
 #include <QSqlQuery>
 
 namespace OPL{
 
 void DatabaseCache::init()
 {
+    TRACE_FUNCTION("cache");
     LOG << "Initialising database cache...";
 
     updateTails();
@@ -34,12 +37,14 @@ void DatabaseCache::init()
 
     // Listen to database for updates, reload cache if needed
     QObject::connect(DB,   		   &OPL::Database::dataBaseUpdated,
-                     this,         &OPL::DatabaseCache::onDatabaseUpdated);
+                     this,         &OPL::DatabaseCache::onDatabaseUpdated,
+                     Qt::UniqueConnection);
 
 }
 
 const IdMap DatabaseCache::fetchMap(CompleterTarget target)
 {
+    TRACE_FUNCTION("cache");
     QString statement;
 
     switch (target) {
@@ -85,6 +90,7 @@ const IdMap DatabaseCache::fetchMap(CompleterTarget target)
 
 const QStringList DatabaseCache::fetchList(CompleterTarget target)
 {
+    TRACE_FUNCTION("cache");
     QString statement;
 
     switch (target) {
@@ -126,8 +132,25 @@ const QStringList DatabaseCache::fetchList(CompleterTarget target)
     return completer_list;
 }
 
+const CoordinateMap DatabaseCache::fetchCoordinates()
+{
+    TRACE_FUNCTION("cache");
+    QSqlQuery query;
+    query.setForwardOnly(true);
+    query.prepare(QStringLiteral("SELECT ROWID, lat, long FROM airports WHERE lat NOT NULL AND long NOT NULL"));
+    query.exec();
+
+    CoordinateMap coordinate_map;
+    while (query.next())
+        coordinate_map.insert(query.value(0).toInt(), {query.value(1).toDouble(), query.value(2).toDouble()});
+    return coordinate_map;
+}
+
 void DatabaseCache::updateTails()
 {
+    TRACE_FUNCTION("cache");
+    static auto &rebuilds = Metrics::counter(QStringLiteral("cache/rebuilds/tails"));
+    rebuilds.add();
     tailsMap = fetchMap(Tails);
     tailsList = fetchList(Tails);
     for (auto &reg : tailsList) {
@@ -142,20 +165,28 @@ void DatabaseCache::updateTails()
 
 void DatabaseCache::updateAirports()
 {
+    TRACE_FUNCTION("cache");
+    static auto &rebuilds = Metrics::counter(QStringLiteral("cache/rebuilds/airports"));
+    rebuilds.add();
     airportsMapIATA  = fetchMap(AirportsIATA);
     airportsMapICAO  = fetchMap(AirportsICAO);
     airportsMapNames = fetchMap(AirportNames);
+    airportCoordinatesMap = fetchCoordinates();
     airportList      = fetchList(AirportsAny);
 }
 
 void DatabaseCache::updateSimulators()
 {
+    TRACE_FUNCTION("cache");
     TODO << "Simulators map not yet cached";
     Q_UNIMPLEMENTED();
 }
 
 void DatabaseCache::updatePilots()
 {
+    TRACE_FUNCTION("cache");
+    static auto &rebuilds = Metrics::counter(QStringLiteral("cache/rebuilds/pilots"));
+    rebuilds.add();
     pilotNamesMap  = fetchMap(PilotNames);
     pilotNamesList = fetchList(PilotNames);
     companiesList  = fetchList(Companies);
@@ -163,12 +194,16 @@ void DatabaseCache::updatePilots()
 
 void DatabaseCache::updateAircraft()
 {
+    TRACE_FUNCTION("cache");
+    static auto &rebuilds = Metrics::counter(QStringLiteral("cache/rebuilds/aircraft"));
+    rebuilds.add();
     aircraftList = fetchList(AircraftTypes);
     aircraftMap = fetchMap(AircraftTypes);
 }
 
 void DatabaseCache::onDatabaseUpdated(const OPL::DbTable table)
 {
+    TRACE_FUNCTION("cache");
     LOG << "Updating Database Cache...";
     switch (table) {
     case DbTable::Pilots:
@@ -241,6 +276,11 @@ const IdMap &DatabaseCache::getAirportsMapNames() const
     return airportsMapNames;
 }
 
+const CoordinateMap &DatabaseCache::getAirportCoordinatesMap() const
+{
+    return airportCoordinatesMap;
+}
+
 const IdMap &DatabaseCache::getTailsMap() const
 {
     return tailsMap;
@@ -23,6 +23,15 @@
 namespace OPL{
 
 using IdMap = QHash<int, QString>;
+
+/*!
+ * \brief The position of an airport in decimal degrees, latitude -90:90 S(-) N(+), longitude -180:180 W(-) E(+)
+ */
+struct Coordinates {
+    double lat = 0;
+    double lon = 0;
+};
+using CoordinateMap = QHash<int, Coordinates>;
 #define DBCache OPL::DatabaseCache::instance()
 
 /*!
@@ -66,6 +75,11 @@ public:
 
     const IdMap &getAirportsMapNames() const;
 
+    /*!
+     * \brief key: airport_id / value: the coordinates of the airport. Airports without coordinates are omitted.
+     */
+    const CoordinateMap &getAirportCoordinatesMap() const;
+
 private:
     Q_OBJECT
     DatabaseCache() {};
@@ -74,6 +88,7 @@ private:
     IdMap airportsMapICAO;
     IdMap airportsMapIATA;
     IdMap airportsMapNames;
+    CoordinateMap airportCoordinatesMap;
     IdMap pilotNamesMap;
     /*!
      * \brief key: tail_id / value: registration
@@ -93,6 +108,7 @@ private:
 
     const IdMap fetchMap(CompleterTarget target);
     const QStringList fetchList(CompleterTarget target);
+    const CoordinateMap fetchCoordinates();
 
 
     void updateTails();
@@ -16,66 +16,50 @@
  *along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 #include "dbsummary.h"
+#include "src/database/backuparchive.h"
 #include "QtCore/qstringliteral.h"
 #include "QtSql/qsqldatabase.h"
 #include "QtSql/qsqlquery.h"
+#include <QThread>
 
 namespace OPL {
 
 const QMap<DbSummaryKey, QString> DbSummary::databaseSummary(const QString &db_path)
 {
-    const QString connection_name = QStringLiteral("summary_connection");
+    // archives contain a summary of the database at the time of backup
+    if (BackupArchive::isArchive(db_path))
+        return BackupArchive::readSummary(db_path);
+
+    // Summaries can be created concurrently on worker threads, so every thread needs its own connection
+    const QString connection_name = QStringLiteral("summary_connection_%1")
+            .arg(reinterpret_cast<quintptr>(QThread::currentThread()));
     QMap<DbSummaryKey, QString> return_values;
     { // scope for a temporary database connection, ensures proper cleanup when removeDatabase() is called.
         //DEB << "Adding temporary connection to database:" << db_path;
         QSqlDatabase temp_database = QSqlDatabase::addDatabase(SQLITE_DRIVER, connection_name); // Don't use default connection
         temp_database.setDatabaseName(db_path);
-        if (!temp_database.open())
-            return {};
-
-        QSqlQuery query(temp_database); // Query object using the temporary connection
-        DbSummaryKey key;  // Used among the queries for verbosity... and sanity
-
-        const QVector<QPair<DbSummaryKey, QString>> key_table_pairs = {
-            {DbSummaryKey::total_flights, QStringLiteral("flights")},
-            {DbSummaryKey::total_tails, QStringLiteral("tails")},
-            {DbSummaryKey::total_pilots, QStringLiteral("pilots")}
-        };
-        // retreive amount of flights, tails and pilots
-        for (const auto & pair : key_table_pairs) {
-            query.prepare(QLatin1String("SELECT COUNT (*) FROM ") + pair.second);
-            query.exec();
-            key = pair.first;
-            if (query.first()){
-                return_values[key] = query.value(0).toString();
-            }
-            else{
-                return_values[key] = QString();
+        temp_database.setConnectOptions(QStringLiteral("QSQLITE_OPEN_READONLY"));
+        if (temp_database.open()) {
+            QSqlQuery query(temp_database); // Query object using the temporary connection
+            // retreive amount of flights, tails and pilots, the date of the last flight and
+            // the total flight time as a string "hh:mm" in a single round trip
+            query.prepare(QStringLiteral("SELECT "
+                                         "(SELECT COUNT (*) FROM flights), "
+                                         "(SELECT COUNT (*) FROM tails), "
+                                         "(SELECT COUNT (*) FROM pilots), "
+                                         "(SELECT MAX(doft) FROM flights), "
+                                         "(SELECT printf(\"%02d\",CAST(SUM(tblk) AS INT)/60)"
+                                         "||':'||"
+                                         "printf(\"%02d\",CAST(SUM(tblk) AS INT)%60) FROM flights)"));
+            // an empty summary tells the caller that the file could not be read
+            if (query.exec() && query.first()) {
+                return_values[DbSummaryKey::total_flights] = query.value(0).toString();
+                return_values[DbSummaryKey::total_tails]   = query.value(1).toString();
+                return_values[DbSummaryKey::total_pilots]  = query.value(2).toString();
+                return_values[DbSummaryKey::last_flight]   = query.value(3).toString();
+                return_values[DbSummaryKey::total_time]    = query.value(4).toString();
             }
         }
-        // retreive date of last flight
-        query.prepare(QStringLiteral("SELECT MAX(doft) FROM flights"));
-        query.exec();
-        key = DbSummaryKey::last_flight;
-        if (query.first()){
-            return_values[key] = query.value(0).toString();
-        }
-        else {
-            return_values[key] = QString();
-        }
-        // retreive total flight time as a string "hh:mm"
-        query.prepare(QStringLiteral("SELECT "
-                                     "printf(\"%02d\",CAST(SUM(tblk) AS INT)/60)"
-                                     "||':'||"
-                                     "printf(\"%02d\",CAST(SUM(tblk) AS INT)%60) FROM flights"));
-        key = DbSummaryKey::total_time;
-        query.exec();
-        if (query.first()){
-            return_values[key] = query.value(0).toString();
-        }
-        else {
-            return_values[key] = QString();
-        }
     }
 
     QSqlDatabase::removeDatabase(connection_name); // cleanly removes temp connection without leaks since query+db are out of scope
@@ -52,6 +52,8 @@ public:
      * Total Flight Time, Number of unique aircraft and pilots, as well as the date of last flight. Uses a temporary
      * database connection separate from the default connection in order to not tamper with the currently active
      * database connection. The full path to the database to be summarized has to be provided.
+     *
+     * The function can be called from worker threads, each thread uses its own read-only connection.
      */
     static const QMap<DbSummaryKey, QString> databaseSummary(const QString& db_path);
 
@@ -0,0 +1,166 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "dbsummarycache.h"
+#include "src/opl.h"
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+namespace OPL {
+
+// keys used in the index file
+const static QHash<DbSummaryKey, QString> SUMMARY_KEY_NAMES = {
+    {DbSummaryKey::total_flights, QStringLiteral("total_flights")},
+    {DbSummaryKey::total_tails,   QStringLiteral("total_tails")},
+    {DbSummaryKey::total_pilots,  QStringLiteral("total_pilots")},
+    {DbSummaryKey::last_flight,   QStringLiteral("last_flight")},
+    {DbSummaryKey::total_time,    QStringLiteral("total_time")},
+};
+
+DbSummaryCache::DbSummaryCache(const QString &index_file_path, QObject *parent)
+    : QObject(parent), m_indexFilePath(index_file_path)
+{
+    readIndex();
+}
+
+DbSummaryCache::~DbSummaryCache()
+{
+    // queued results of workers that are still running are discarded when this object is destroyed
+    m_threadPool.clear();
+    m_threadPool.waitForDone();
+    writeIndex();
+}
+
+void DbSummaryCache::request(const QFileInfoList &files)
+{
+    for (const auto &file : files) {
+        const auto cached = cachedSummary(file);
+        if (!cached.isEmpty()) {
+            emit summaryReady(file.absoluteFilePath(), cached);
+            continue;
+        }
+
+        m_pending++;
+        m_threadPool.start([this, file]{
+            const auto summary = DbSummary::databaseSummary(file.absoluteFilePath());
+            QMetaObject::invokeMethod(this, [this, file, summary]{
+                onSummaryCreated(file, summary);
+            }, Qt::QueuedConnection);
+        });
+    }
+
+    if (m_pending == 0)
+        emit finished();
+}
+
+QMap<DbSummaryKey, QString> DbSummaryCache::cachedSummary(const QFileInfo &file) const
+{
+    const auto it = m_entries.constFind(file.absoluteFilePath());
+    if (it == m_entries.constEnd()
+            || it->size != file.size()
+            || it->lastModified != file.lastModified().toMSecsSinceEpoch())
+        return {};
+
+    return it->summary;
+}
+
+void DbSummaryCache::remove(const QString &file_path)
+{
+    if (m_entries.remove(QFileInfo(file_path).absoluteFilePath()) == 0)
+        return;
+
+    m_dirty = true;
+    writeIndex();
+}
+
+void DbSummaryCache::onSummaryCreated(const QFileInfo &file, const QMap<DbSummaryKey, QString> &summary)
+{
+    // don't cache files that could not be opened, they might be readable later on
+    if (!summary.isEmpty()) {
+        m_entries.insert(file.absoluteFilePath(),
+                         {file.size(), file.lastModified().toMSecsSinceEpoch(), summary});
+        m_dirty = true;
+    }
+    emit summaryReady(file.absoluteFilePath(), summary);
+
+    m_pending--;
+    if (m_pending == 0) {
+        writeIndex();
+        emit finished();
+    }
+}
+
+void DbSummaryCache::readIndex()
+{
+    QFile file(m_indexFilePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    const QJsonObject index = QJsonDocument::fromJson(file.readAll()).object();
+    for (auto it = index.constBegin(); it != index.constEnd(); ++it) {
+        // backups deleted outside of the application are dropped from the index
+        if (!QFileInfo::exists(it.key())) {
+            m_dirty = true;
+            continue;
+        }
+        const QJsonObject entry = it.value().toObject();
+        const QJsonObject summary_object = entry.value(QLatin1String("summary")).toObject();
+
+        CacheEntry cache_entry{entry.value(QLatin1String("size")).toVariant().toLongLong(),
+                               entry.value(QLatin1String("modified")).toVariant().toLongLong(),
+                               {}};
+        for (auto key = SUMMARY_KEY_NAMES.constBegin(); key != SUMMARY_KEY_NAMES.constEnd(); ++key)
+            cache_entry.summary.insert(key.key(), summary_object.value(key.value()).toString());
+
+        m_entries.insert(it.key(), cache_entry);
+    }
+}
+
+void DbSummaryCache::writeIndex()
+{
+    if (!m_dirty)
+        return;
+
+    QJsonObject index;
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        // remove entries of backups that have been deleted
+        if (!QFileInfo::exists(it.key()))
+            continue;
+
+        QJsonObject summary_object;
+        for (auto key = SUMMARY_KEY_NAMES.constBegin(); key != SUMMARY_KEY_NAMES.constEnd(); ++key)
+            summary_object.insert(key.value(), it->summary.value(key.key()));
+
+        index.insert(it.key(), QJsonObject{
+                         {QLatin1String("size"), it->size},
+                         {QLatin1String("modified"), it->lastModified},
+                         {QLatin1String("summary"), summary_object},
+                     });
+    }
+
+    QSaveFile file(m_indexFilePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        LOG << "Unable to write backup index file:" << m_indexFilePath;
+        return;
+    }
+    file.write(QJsonDocument(index).toJson(QJsonDocument::Compact));
+    if (file.commit())
+        m_dirty = false;
+}
+
+} // namespace OPL
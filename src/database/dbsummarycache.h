@@ -0,0 +1,104 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef DBSUMMARYCACHE_H
+#define DBSUMMARYCACHE_H
+#include "src/database/dbsummary.h"
+#include <QtCore>
+
+namespace OPL {
+
+/*!
+ * \brief The DbSummaryCache class creates summaries of backup files asynchronously and caches them.
+ *
+ * \details Creating a DbSummary requires opening the database file and running several queries on it,
+ * which is slow for users who keep a large number of backups. The DbSummaryCache creates the summaries
+ * in parallel on a thread pool, each worker using its own database connection, and notifies the caller
+ * with summaryReady() as soon as a summary is available.
+ *
+ * Finished summaries are stored in a sidecar index file in the backup directory. An entry of the index is keyed
+ * by the absolute file path and is only re-used if the size and modification time of the file are unchanged,
+ * so that unchanged backups never have to be opened again.
+ */
+class DbSummaryCache : public QObject
+{
+    Q_OBJECT
+public:
+    /*!
+     * \brief Create a DbSummaryCache which uses the index file at index_file_path
+     */
+    explicit DbSummaryCache(const QString &index_file_path, QObject *parent = nullptr);
+
+    /*!
+     * \brief Waits for running workers to finish and writes the index to disk.
+     */
+    ~DbSummaryCache();
+
+    /*!
+     * \brief Request summaries for the given files.
+     * \details Cached summaries are emitted immediately, all others are created on the thread pool and emitted
+     * when ready. finished() is emitted once all requested summaries are available.
+     */
+    void request(const QFileInfoList &files);
+
+    /*!
+     * \brief Returns the cached summary of a file or an empty map if there is no valid cache entry.
+     */
+    QMap<DbSummaryKey, QString> cachedSummary(const QFileInfo &file) const;
+
+    /*!
+     * \brief Removes the cache entry of a file that has been deleted and updates the index file
+     */
+    void remove(const QString &file_path);
+
+    /*!
+     * \brief the file name of the index file, relative to the backup directory.
+     */
+    const static inline QString INDEX_FILE_NAME = QStringLiteral(".backup_index.json");
+
+signals:
+    /*!
+     * \brief Emitted when the summary of the database file at file_path is available
+     */
+    void summaryReady(const QString &file_path, const QMap<OPL::DbSummaryKey, QString> &summary);
+
+    /*!
+     * \brief Emitted when all pending summaries have been created
+     */
+    void finished();
+
+private:
+    struct CacheEntry {
+        qint64 size;
+        qint64 lastModified;
+        QMap<DbSummaryKey, QString> summary;
+    };
+
+    QString m_indexFilePath;
+    QHash<QString, CacheEntry> m_entries;
+    QThreadPool m_threadPool;
+    int m_pending = 0;
+    bool m_dirty = false;
+
+    void readIndex();
+    void writeIndex();
+    void onSummaryCreated(const QFileInfo &file, const QMap<DbSummaryKey, QString> &summary);
+};
+
+} // namespace OPL
+
+#endif // DBSUMMARYCACHE_H
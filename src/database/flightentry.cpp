@@ -17,8 +17,7 @@
  */
 #include "flightentry.h"
 #include "src/opl.h"
-#include "src/classes/date.h"
-#include "src/classes/time.h"
+#include "src/classes/datetimeformatter.h"
 
 namespace OPL {
 
@@ -34,20 +33,23 @@ FlightEntry::FlightEntry()
 }
 
 
-FlightEntry::FlightEntry(const RowData_T &row_data)
-    : Row(DbTable::Flights, NEW_ENTRY, row_data)
+FlightEntry::FlightEntry(RowData_T row_data)
+    : Row(DbTable::Flights, NEW_ENTRY, std::move(row_data))
 {
+    // only fill in the fields that have not been provided
     for(const QString &item : allFields) {
-        rowData.insert(item, QVariant(QMetaType(QMetaType::Int)));
+        if (!rowData.contains(item))
+            rowData.insert(item, QVariant(QMetaType(QMetaType::Int)));
     }
     for(const QString &item : mandatoryFields) {
-        rowData.insert(item, -1);
+        if (!rowData.contains(item))
+            rowData.insert(item, -1);
     }
 
 }
 
-FlightEntry::FlightEntry(int row_id, const RowData_T &row_data)
-    : Row(DbTable::Flights, row_id, row_data) {}
+FlightEntry::FlightEntry(int row_id, RowData_T row_data)
+    : Row(DbTable::Flights, row_id, std::move(row_data)) {}
 
 const QString FlightEntry::getTableName() const
 {
@@ -60,15 +62,14 @@ QString FlightEntry::getFlightSummary() const
     if(!isValid())
         return QString();
 
-    auto tableData = getData();
+    const auto &tableData = getData();
+    const DateTimeFormatter formatter;
     QString flight_summary;
     constexpr auto space = QLatin1Char(' ');
-    flight_summary.append(OPL::Date(tableData.value(FlightEntry::DOFT).toInt(), DateTimeFormat()).toString() + space);
+    flight_summary.append(formatter.dateString(tableData.value(FlightEntry::DOFT).toInt()) + space);
     flight_summary.append(tableData.value(FlightEntry::DEPT).toString() + space);
-    flight_summary.append(Time(tableData.value(FlightEntry::TOFB).toInt(), DateTimeFormat()).toString()
-                          + space);
-    flight_summary.append(Time(tableData.value(FlightEntry::TONB).toInt(), DateTimeFormat()).toString()
-                          + space);
+    flight_summary.append(formatter.timeString(tableData.value(FlightEntry::TOFB).toInt()) + space);
+    flight_summary.append(formatter.timeString(tableData.value(FlightEntry::TONB).toInt()) + space);
     flight_summary.append(tableData.value(FlightEntry::DEST).toString());
 
     return flight_summary;
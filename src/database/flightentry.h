@@ -34,8 +34,8 @@ class FlightEntry : public Row
 {
 public:
     FlightEntry();
-    FlightEntry(const RowData_T &row_data);
-    FlightEntry(int row_id, const RowData_T &row_data);
+    FlightEntry(RowData_T row_data);
+    FlightEntry(int row_id, RowData_T row_data);
 
     /*!
      * \brief return a QStringList of invalid mandatory fields.
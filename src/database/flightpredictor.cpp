@@ -0,0 +1,268 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "flightpredictor.h"
+#include "src/database/database.h"
+#include "src/functions/metrics.h"
+#include "src/testing/trace.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <algorithm>
+
+namespace OPL {
+
+void FlightPredictor::init()
+{
+    TRACE_FUNCTION("cache");
+    LOG << "Initialising flight predictor...";
+    m_enabled = true;
+    m_stale = true;
+
+    // Listen to database for updates, add new flights or mark the index as stale
+    QObject::connect(DB,   		   &OPL::Database::dataBaseUpdated,
+                     this,         &OPL::FlightPredictor::onDatabaseUpdated,
+                     Qt::UniqueConnection);
+    QObject::connect(DB,   		   &OPL::Database::connectionReset,
+                     this,         &OPL::FlightPredictor::onConnectionReset,
+                     Qt::UniqueConnection);
+}
+
+FlightPredictor::Prediction FlightPredictor::predict(int julian_day, const QString &departure, const QString &destination)
+{
+    TRACE_FUNCTION("cache");
+    static auto &latency = Metrics::histogram(QStringLiteral("predictor/predict"));
+    Metrics::LatencyScope scope(latency);
+    ensureBuilt();
+
+    Prediction prediction;
+    if (m_count == 0)
+        return prediction;
+
+    prediction.departure = departure.isEmpty() ? m_airports.value(m_latest.dest) : departure;
+    const qint32 departure_code = m_airportCodes.value(prediction.departure, -1);
+
+    prediction.destination = destination;
+    if (destination.isEmpty()) {
+        const Route *best = nullptr;
+        qint32 best_destination = -1;
+        for (const auto code : m_destinations.value(departure_code)) {
+            const Route &route = m_routes[routeKey(departure_code, code)];
+            if (best == nullptr || route.count > best->count
+                    || (route.count == best->count && route.lastFlown > best->lastFlown)) {
+                best = &route;
+                best_destination = code;
+            }
+        }
+        prediction.destination = m_airports.value(best_destination);
+    }
+    const qint32 destination_code = m_airportCodes.value(prediction.destination, -1);
+    const auto route = m_routes.constFind(routeKey(departure_code, destination_code));
+
+    if (m_latest.doft == julian_day) {
+        // the same duty, keep aircraft and crew
+        prediction.registrationId = m_latest.acft;
+        prediction.firstPilotId = m_latest.pic;
+        prediction.secondPilotId = m_latest.secondPilot;
+        prediction.thirdPilotId = m_latest.thirdPilot;
+    } else {
+        if (route != m_routes.constEnd())
+            prediction.registrationId = mostFrequent(route->tails);
+        const int pic = mostFrequent(m_pics);
+        if (m_pics.value(pic) * 2 > m_count)
+            prediction.firstPilotId = pic;
+    }
+
+    if (route != m_routes.constEnd()) {
+        prediction.flightNumber = mostFrequent(route->flightNumbers);
+        prediction.blockMinutes = medianBlockTime(*route);
+    }
+    return prediction;
+}
+
+void FlightPredictor::build()
+{
+    TRACE_FUNCTION("cache");
+    static auto &builds = Metrics::counter(QStringLiteral("predictor/builds"));
+    static auto &latency = Metrics::histogram(QStringLiteral("predictor/build"));
+    Metrics::LatencyScope scope(latency);
+    builds.add();
+
+    m_count = 0;
+    m_lastFlightId = 0;
+    m_latest = Flight();
+    m_airports.clear();
+    m_airportCodes.clear();
+    m_routes.clear();
+    m_destinations.clear();
+    m_pics.clear();
+
+    QVector<Flight> flights;
+    if (fetchFlights(0, flights) < 0)
+        return;
+    for (const auto &flight : std::as_const(flights))
+        addFlight(flight);
+    m_stale = false;
+}
+
+void FlightPredictor::ensureBuilt()
+{
+    if (m_stale)
+        build();
+}
+
+/*!
+ * \brief Adds the flights which have been inserted since the index was last updated
+ * \details Inserted flights get a higher row id than all existing flights. If the flights with a higher row id
+ * than the last one in the index do not account for the new number of flights, or if there are none, an
+ * existing flight has been modified or deleted.
+ * \return true if the index is up to date, false if it needs to be rebuilt
+ */
+bool FlightPredictor::appendNewFlights()
+{
+    QSqlQuery query(DB->database());
+    query.setForwardOnly(true);
+    if (!query.exec(QStringLiteral("SELECT COUNT(*) FROM flights")) || !query.next())
+        return false;
+    const int count = query.value(0).toInt();
+
+    QVector<Flight> flights;
+    const int appended = fetchFlights(m_lastFlightId, flights);
+    if (appended <= 0 || m_count + appended != count)
+        return false;
+
+    static auto &appends = Metrics::counter(QStringLiteral("predictor/appends"));
+    appends.add(appended);
+    for (const auto &flight : std::as_const(flights))
+        addFlight(flight);
+    return true;
+}
+
+/*!
+ * \brief Fetches the flights with a row id greater than after_id in chronological order
+ * \return the number of flights fetched or -1 if the query failed
+ */
+int FlightPredictor::fetchFlights(int after_id, QVector<Flight> &flights)
+{
+    QSqlQuery query(DB->database());
+    query.setForwardOnly(true);
+    query.prepare(QStringLiteral("SELECT flight_id, doft, tofb, tblk, dept, dest, acft, pic, secondPilot, thirdPilot, "
+                                 "flightNumber FROM flights WHERE flight_id > ? ORDER BY doft, tofb, flight_id"));
+    query.addBindValue(after_id);
+    if (!query.exec()) {
+        LOG << "Unable to load flights for predictions: " << query.lastError().text();
+        return -1;
+    }
+
+    while (query.next()) {
+        Flight flight;
+        flight.id          = query.value(0).toInt();
+        flight.doft        = query.value(1).toInt();
+        flight.tofb        = query.value(2).toInt();
+        flight.tblk        = query.value(3).toInt();
+        flight.dept        = airportCode(query.value(4).toString());
+        flight.dest        = airportCode(query.value(5).toString());
+        flight.acft        = query.value(6).toInt();
+        flight.pic         = query.value(7).toInt();
+        flight.secondPilot = query.value(8).toInt();
+        flight.thirdPilot  = query.value(9).toInt();
+        flight.flightNumber = query.value(10).toString();
+        flights.append(flight);
+    }
+    return flights.size();
+}
+
+void FlightPredictor::addFlight(const Flight &flight)
+{
+    m_count++;
+    m_lastFlightId = std::max(m_lastFlightId, flight.id);
+    const qint64 flown = flight.chronologicalKey();
+    if (m_count == 1 || flown >= m_latest.chronologicalKey())
+        m_latest = flight;
+
+    Route &route = m_routes[routeKey(flight.dept, flight.dest)];
+    if (route.count++ == 0)
+        m_destinations[flight.dept].append(flight.dest);
+    route.lastFlown = std::max(route.lastFlown, flown);
+    if (flight.acft != 0)
+        route.tails[flight.acft]++;
+    if (!flight.flightNumber.isEmpty())
+        route.flightNumbers[flight.flightNumber]++;
+    if (flight.tblk > 0)
+        route.blockTimes[route.blockTimeCount++ % BLOCK_TIME_SAMPLES] = flight.tblk;
+
+    if (flight.pic != 0)
+        m_pics[flight.pic]++;
+}
+
+qint32 FlightPredictor::airportCode(const QString &airport)
+{
+    const auto it = m_airportCodes.constFind(airport);
+    if (it != m_airportCodes.constEnd())
+        return it.value();
+
+    const qint32 code = m_airports.size();
+    m_airports.append(airport);
+    m_airportCodes.insert(airport, code);
+    return code;
+}
+
+quint64 FlightPredictor::routeKey(qint32 departure, qint32 destination)
+{
+    return (quint64(quint32(departure)) << 32) | quint32(destination);
+}
+
+int FlightPredictor::medianBlockTime(const Route &route)
+{
+    const int count = std::min(route.blockTimeCount, BLOCK_TIME_SAMPLES);
+    if (count == 0)
+        return -1;
+    auto samples = route.blockTimes;
+    std::nth_element(samples.begin(), samples.begin() + count / 2, samples.begin() + count);
+    return samples[count / 2];
+}
+
+template<typename Key>
+Key FlightPredictor::mostFrequent(const QHash<Key, int> &counts)
+{
+    Key best = Key();
+    int best_count = 0;
+    for (auto it = counts.cbegin(); it != counts.cend(); ++it) {
+        // break ties by key, the order of a QHash is arbitrary
+        if (it.value() > best_count || (it.value() == best_count && it.key() < best)) {
+            best = it.key();
+            best_count = it.value();
+        }
+    }
+    return best;
+}
+
+void FlightPredictor::onDatabaseUpdated(const DbTable table)
+{
+    if (m_stale || (table != DbTable::Flights && table != DbTable::Any))
+        return;
+
+    TRACE_FUNCTION("cache");
+    if (table == DbTable::Any || !appendNewFlights())
+        m_stale = true;
+}
+
+void FlightPredictor::onConnectionReset()
+{
+    m_stale = true;
+}
+
+} // namespace OPL
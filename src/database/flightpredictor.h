@@ -0,0 +1,159 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef FLIGHTPREDICTOR_H
+#define FLIGHTPREDICTOR_H
+#include "src/opl.h"
+#include <QtCore>
+#include <array>
+
+namespace OPL {
+
+/*!
+ * \brief The FlightPredictor class predicts the likely contents of a new flight from the past flights
+ *
+ * \details Pilots fly the same rotations with the same aircraft and crews over and over again. The FlightPredictor keeps
+ * an index of the past flights from which it predicts the following values without querying the database:
+ * <ul>
+ * <li> Departure: the destination of the latest flight </li>
+ * <li> Destination: the destination flown to most often from the departure, the most recent one on a tie </li>
+ * <li> Registration and crew: those of the latest flight if it took place on the same day. Otherwise the registration
+ *      used most often on the route and the PIC of more than half of all flights, which is usually self. </li>
+ * <li> Flight number: the flight number used most often on the route </li>
+ * <li> Block time: the median of the last BLOCK_TIME_SAMPLES block times on the route </li>
+ * </ul>
+ *
+ * The index is built on the first prediction, usually when a new flight is entered for the first time, and then
+ * kept up to date incrementally. New flights are appended to the
+ * flights table and are added to the index as soon as they have been committed. Edits and deletions cannot be applied
+ * incrementally, they mark the index as stale and it is rebuilt lazily on the next prediction.
+ *
+ * \note The predictor is only accessed from the GUI thread and is not thread-safe.
+ */
+class FlightPredictor : public QObject
+{
+    Q_OBJECT
+public:
+    /*!
+     * \brief The predicted values of a new flight. Values which could not be predicted are empty or 0,
+     * the block time is -1 if it is unknown.
+     */
+    struct Prediction {
+        QString departure;
+        QString destination;
+        QString flightNumber;
+        int registrationId = 0;
+        int firstPilotId = 0;
+        int secondPilotId = 0;
+        int thirdPilotId = 0;
+        int blockMinutes = -1;
+    };
+
+    static FlightPredictor* instance() {
+        static FlightPredictor instance;
+        return &instance;
+    }
+
+    FlightPredictor(FlightPredictor const&) = delete;
+    void operator=(FlightPredictor const&) = delete;
+
+    /*!
+     * \brief Enables the predictor and listens to the database for updates. The index is built on the first prediction.
+     */
+    void init();
+
+    /*!
+     * \brief Returns true if init() has been called
+     */
+    bool isEnabled() const { return m_enabled; }
+
+    /*!
+     * \brief Predicts a new flight on the given date
+     * \param julian_day - the date of the new flight
+     * \param departure - the departure if it is already known, otherwise it is predicted
+     * \param destination - the destination if it is already known, otherwise it is predicted
+     */
+    Prediction predict(int julian_day, const QString &departure = QString(), const QString &destination = QString());
+
+private:
+    FlightPredictor() {};
+
+    static constexpr int BLOCK_TIME_SAMPLES = 16;
+
+    /*!
+     * \brief The columns of a flight that are used for predictions
+     */
+    struct Flight {
+        int id = 0;
+        qint32 doft = 0;
+        qint32 tofb = 0;
+        qint32 tblk = 0;
+        qint32 dept = -1;
+        qint32 dest = -1;
+        int acft = 0;
+        int pic = 0;
+        int secondPilot = 0;
+        int thirdPilot = 0;
+        QString flightNumber;
+
+        qint64 chronologicalKey() const { return qint64(doft) * 24 * 60 + tofb; }
+    };
+
+    /*!
+     * \brief What has been flown between a departure and a destination
+     */
+    struct Route {
+        int count = 0;
+        qint64 lastFlown = std::numeric_limits<qint64>::min();
+        QHash<int, int> tails;
+        QHash<QString, int> flightNumbers;
+        std::array<qint32, BLOCK_TIME_SAMPLES> blockTimes = {};
+        int blockTimeCount = 0;
+    };
+
+    bool m_enabled = false;
+    bool m_stale = true;
+    int m_count = 0;
+    int m_lastFlightId = 0;
+    Flight m_latest;
+
+    QStringList m_airports;
+    QHash<QString, qint32> m_airportCodes;
+    QHash<quint64, Route> m_routes;
+    QHash<qint32, QVector<qint32>> m_destinations;
+    QHash<int, int> m_pics;
+
+    void build();
+    void ensureBuilt();
+    bool appendNewFlights();
+    int fetchFlights(int after_id, QVector<Flight> &flights);
+    void addFlight(const Flight &flight);
+    qint32 airportCode(const QString &airport);
+
+    static quint64 routeKey(qint32 departure, qint32 destination);
+    static int medianBlockTime(const Route &route);
+    template<typename Key>
+    static Key mostFrequent(const QHash<Key, int> &counts);
+
+public slots:
+    void onDatabaseUpdated(const OPL::DbTable table);
+    void onConnectionReset();
+};
+
+} // namespace OPL
+
+#endif // FLIGHTPREDICTOR_H
@@ -0,0 +1,214 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "flightstore.h"
+#include "src/database/database.h"
+#include "src/functions/metrics.h"
+#include "src/testing/trace.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <algorithm>
+
+namespace OPL {
+
+using Flights = Schema::Flights;
+
+void FlightStore::init()
+{
+    TRACE_FUNCTION("cache");
+    LOG << "Initialising flight store...";
+    m_enabled = true;
+    m_stale = true;
+
+    // Listen to database for updates, mark the snapshot as stale if needed
+    QObject::connect(DB,   		   &OPL::Database::dataBaseUpdated,
+                     this,         &OPL::FlightStore::onDatabaseUpdated,
+                     Qt::UniqueConnection);
+    QObject::connect(DB,   		   &OPL::Database::connectionReset,
+                     this,         &OPL::FlightStore::onConnectionReset,
+                     Qt::UniqueConnection);
+}
+
+bool FlightStore::isStored(Column column)
+{
+    return Flights::COLUMNS[column].type == Schema::ColumnType::Integer
+            || column == Flights::DEPT
+            || column == Flights::DEST;
+}
+
+qint32 FlightStore::airportCode(const QString &airport)
+{
+    const auto it = m_airportCodes.constFind(airport);
+    if (it != m_airportCodes.constEnd())
+        return it.value();
+
+    const qint32 code = m_airports.size();
+    m_airports.append(airport);
+    m_airportCodes.insert(airport, code);
+    return code;
+}
+
+void FlightStore::load()
+{
+    TRACE_FUNCTION("cache");
+    static auto &loads = Metrics::counter(QStringLiteral("flightstore/loads"));
+    static auto &latency = Metrics::histogram(QStringLiteral("flightstore/load"));
+    Metrics::LatencyScope scope(latency);
+    loads.add();
+
+    for (auto &column : m_columns)
+        column.clear();
+    m_airports.clear();
+    m_airportCodes.clear();
+    m_count = 0;
+
+    QList<Column> columns;
+    QStringList column_names;
+    for (int i = 0; i < Flights::COLUMN_COUNT; i++) {
+        const auto column = static_cast<Column>(i);
+        if (!isStored(column))
+            continue;
+        columns.append(column);
+        column_names.append(QString::fromLatin1(Flights::COLUMNS[i].name));
+    }
+
+    QSqlQuery query(DB->database());
+    query.setForwardOnly(true);
+    const QString statement = QLatin1String("SELECT ") + column_names.join(QLatin1Char(','))
+            + QLatin1String(" FROM ") + QLatin1String(Flights::TABLE_NAME)
+            + QLatin1String(" ORDER BY doft, flight_id");
+    if (!query.exec(statement)) {
+        LOG << "Unable to load flight store: " << query.lastError().text();
+        return;
+    }
+
+    // reserve the arrays once if the driver knows the size of the result
+    const int size = query.size();
+    if (size > 0) {
+        for (const auto column : std::as_const(columns))
+            m_columns[column].reserve(size);
+    }
+
+    while (query.next()) {
+        for (int i = 0; i < columns.size(); i++) {
+            const Column column = columns[i];
+            if (column == Flights::DEPT || column == Flights::DEST)
+                m_columns[column].append(airportCode(query.value(i).toString()));
+            else
+                m_columns[column].append(query.value(i).toInt());
+        }
+        m_count++;
+    }
+    m_stale = false;
+}
+
+void FlightStore::ensureLoaded()
+{
+    if (m_stale)
+        load();
+}
+
+int FlightStore::flightCount()
+{
+    ensureLoaded();
+    return m_count;
+}
+
+const QVector<qint32> &FlightStore::column(Column column)
+{
+    ensureLoaded();
+    return m_columns[column];
+}
+
+qsizetype FlightStore::firstIndexFrom(qint32 from_doft) const
+{
+    const auto &doft = m_columns[Flights::DOFT];
+    return std::lower_bound(doft.cbegin(), doft.cend(), from_doft) - doft.cbegin();
+}
+
+qint64 FlightStore::sum(Column column, qint32 from_doft)
+{
+    ensureLoaded();
+    const auto &values = m_columns[column];
+    if (values.isEmpty())
+        return 0;
+
+    const qint32 *data = values.constData();
+    qint64 total = 0;
+    for (qsizetype i = firstIndexFrom(from_doft); i < m_count; i++)
+        total += data[i];
+    return total;
+}
+
+QPair<int, int> FlightStore::takeOffsAndLandings(qint32 from_doft)
+{
+    const int take_offs = sum(Flights::TODAY, from_doft) + sum(Flights::TONIGHT, from_doft);
+    const int landings  = sum(Flights::LDGDAY, from_doft) + sum(Flights::LDGNIGHT, from_doft);
+    return {take_offs, landings};
+}
+
+QDate FlightStore::takeOffLandingExpiry(int expiration_days, int required)
+{
+    ensureLoaded();
+    const qint32 today = QDate::currentDate().toJulianDay();
+    const qint32 *doft     = m_columns[Flights::DOFT].constData();
+    const qint32 *to_day   = m_columns[Flights::TODAY].constData();
+    const qint32 *to_night = m_columns[Flights::TONIGHT].constData();
+    const qint32 *ldg_day  = m_columns[Flights::LDGDAY].constData();
+    const qint32 *ldg_night= m_columns[Flights::LDGNIGHT].constData();
+
+    // walk back from the latest flight until enough take-offs and landings have been accumulated
+    int take_offs = 0;
+    int landings = 0;
+    for (qsizetype i = m_count - 1; i >= 0 && doft[i] >= today - expiration_days; i--) {
+        take_offs += to_day[i] + to_night[i];
+        landings  += ldg_day[i] + ldg_night[i];
+        if (take_offs >= required && landings >= required)
+            return QDate::fromJulianDay(std::min(doft[i], today)).addDays(expiration_days);
+    }
+
+    return QDate::currentDate();
+}
+
+RowData_T FlightStore::totals()
+{
+    ensureLoaded();
+    RowData_T totals;
+    if (m_count == 0)
+        return totals;
+
+    for (const auto column : {Flights::TBLK,   Flights::TSPSE, Flights::TSPME, Flights::TMP,
+                              Flights::TPIC,   Flights::TSIC,  Flights::TDUAL, Flights::TFI,
+                              Flights::TPICUS, Flights::TNIGHT,Flights::TIFR,  Flights::TSIM,
+                              Flights::TODAY,  Flights::TONIGHT, Flights::LDGDAY, Flights::LDGNIGHT})
+        totals.insert(QString::fromLatin1(Flights::COLUMNS[column].name), sum(column));
+
+    return totals;
+}
+
+void FlightStore::onDatabaseUpdated(const DbTable table)
+{
+    if (table == DbTable::Flights || table == DbTable::Any)
+        m_stale = true;
+}
+
+void FlightStore::onConnectionReset()
+{
+    m_stale = true;
+}
+
+} // namespace OPL
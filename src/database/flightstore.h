@@ -0,0 +1,139 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef FLIGHTSTORE_H
+#define FLIGHTSTORE_H
+#include "src/opl.h"
+#include "opl_schema.h"
+#include <QtCore>
+#include <array>
+
+namespace OPL {
+
+/*!
+ * \brief The FlightStore class holds a columnar in-memory snapshot of the flights table for analytics
+ *
+ * \details Totals, currencies and flight time limitations only ever look at a handful of columns of all flights,
+ * but used to run an SQL query for every question. The FlightStore loads the flights table once in a single scan
+ * and keeps every integer column (doft, tofb, tonb, tblk, the function times, take-offs and landings, pic, acft,...)
+ * in its own contiguous array of int32, sorted by date of flight. Departure and destination are dictionary-encoded
+ * into the same array layout, the airport codes are kept in airportDictionary(). NULL values are stored as 0,
+ * matching SUM() in SQL. pic and acft are foreign keys and therefore already dense integer codes.
+ *
+ * Aggregations are plain loops over contiguous memory which the compiler can vectorise, and a time frame is
+ * selected with a binary search on the sorted date column, so answering a question takes microseconds.
+ *
+ * The store is optional. It is enabled by calling init(), which connects it to the database so that the snapshot
+ * is marked as stale whenever the flights change or the connection is reset. The flights are not loaded before the
+ * first access, so enabling the store does not slow down start up. A stale snapshot is re-loaded lazily on
+ * the next access, so that bulk imports which emit many updates only cause a single reload. As long as the store
+ * is not enabled, the functions in OPL::Statistics and Database::getTotals() fall back to SQL.
+ *
+ * \note The store is only accessed from the GUI thread and is not thread-safe.
+ */
+class FlightStore : public QObject
+{
+    Q_OBJECT
+public:
+    using Column = Schema::Flights::Column;
+
+    static FlightStore* instance() {
+        static FlightStore instance;
+        return &instance;
+    }
+
+    FlightStore(FlightStore const&) = delete;
+    void operator=(FlightStore const&) = delete;
+
+    /*!
+     * \brief Enables the store and listens to the database for updates. The flights are loaded on first access.
+     */
+    void init();
+
+    /*!
+     * \brief Returns true if init() has been called and the store can be used instead of SQL
+     */
+    bool isEnabled() const { return m_enabled; }
+
+    /*!
+     * \brief Returns the number of flights in the snapshot
+     */
+    int flightCount();
+
+    /*!
+     * \brief Returns the values of a column, sorted by date of flight.
+     * \details Text columns other than dept and dest are not held in the store and return an empty vector.
+     */
+    const QVector<qint32> &column(Column column);
+
+    /*!
+     * \brief Returns the airport codes referenced by the dept and dest columns
+     */
+    const QStringList &airportDictionary() const { return m_airports; }
+
+    /*!
+     * \brief Returns the sum of a column over all flights on or after the julian day from_doft
+     */
+    qint64 sum(Column column, qint32 from_doft = std::numeric_limits<qint32>::min());
+
+    /*!
+     * \brief Returns the number of take-offs and landings on or after the julian day from_doft
+     */
+    QPair<int, int> takeOffsAndLandings(qint32 from_doft);
+
+    /*!
+     * \brief Returns the date at which the take-off and landing currency expires
+     * \details Walks back from the latest flight until the required number of take-offs and landings have
+     * been accumulated. Returns today's date if this is not the case within the last expiration_days.
+     */
+    QDate takeOffLandingExpiry(int expiration_days, int required = 3);
+
+    /*!
+     * \brief Returns the total times, take-offs and landings keyed by their column names,
+     * equivalent to the flights part of Database::getTotals()
+     */
+    RowData_T totals();
+
+private:
+    FlightStore() {};
+
+    bool m_enabled = false;
+    bool m_stale = true;
+    int m_count = 0;
+
+    std::array<QVector<qint32>, Schema::Flights::COLUMN_COUNT> m_columns;
+    QStringList m_airports;
+    QHash<QString, qint32> m_airportCodes;
+
+    /*!
+     * \brief Loads all flights in a single scan, replacing the current snapshot
+     */
+    void load();
+    void ensureLoaded();
+    qint32 airportCode(const QString &airport);
+    qsizetype firstIndexFrom(qint32 from_doft) const;
+
+    static bool isStored(Column column);
+
+public slots:
+    void onDatabaseUpdated(const OPL::DbTable table);
+    void onConnectionReset();
+};
+
+} // namespace OPL
+
+#endif // FLIGHTSTORE_H
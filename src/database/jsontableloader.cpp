@@ -0,0 +1,185 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "jsontableloader.h"
+#include "src/database/database.h"
+#include "src/functions/jsonreader.h"
+#include <QSqlError>
+
+namespace OPL {
+
+JsonTableLoader::JsonTableLoader(DbTable table, const QSqlDatabase &database)
+    : m_database(database),
+      m_tableName(GLOBALS->getDbTableName(table)),
+      m_columns(DB->getTableColumns(table)),
+      m_batchQuery(database),
+      m_rowQuery(database)
+{}
+
+bool JsonTableLoader::loadFile(const QString &file_path)
+{
+    JSON::ArrayReader reader(file_path);
+    if (!reader.open()) {
+        m_errorString = reader.errorString();
+        return false;
+    }
+    if (!begin())
+        return false;
+
+    QJsonValue value;
+    while (reader.readElement(value)) {
+        if (value.isObject())
+            addRow(value.toObject());
+        else
+            skipRow(QStringLiteral("Element is not a JSON object."));
+    }
+
+    // A syntax error ends the file early, discard the rows read so far rather than importing part of the file
+    if (reader.hasError()) {
+        cancel();
+        m_errorString = reader.errorString();
+        return false;
+    }
+    return finish();
+}
+
+bool JsonTableLoader::begin()
+{
+    m_rowsInserted = 0;
+    m_rowErrors.clear();
+    m_errorString.clear();
+    m_pendingValues.clear();
+    m_firstPendingRow = m_nextRow = 0;
+
+    if (m_columns.isEmpty()) {
+        m_errorString = QStringLiteral("Table %1 does not exist.").arg(m_tableName);
+        return false;
+    }
+
+    m_rowsPerStatement = qBound(1, MAX_VARIABLES / int(m_columns.size()), m_batchSize);
+    m_pendingValues.reserve(m_rowsPerStatement * m_columns.size());
+    if (!m_batchQuery.prepare(insertStatement(m_rowsPerStatement))
+            || !m_rowQuery.prepare(insertStatement(1))) {
+        m_errorString = m_rowQuery.lastError().text();
+        return false;
+    }
+
+    if (!m_database.transaction()) {
+        m_errorString = m_database.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+void JsonTableLoader::addRow(const QJsonObject &object)
+{
+    for (const auto &column : std::as_const(m_columns)) {
+        const QJsonValue value = object.value(column);
+        // use QMetaType for binding null value in QT >= 6
+        m_pendingValues.append(value.isNull() || value.isUndefined() ? QVariant(QMetaType(QMetaType::Int))
+                                                                    : value.toVariant());
+    }
+    m_nextRow++;
+
+    if (m_pendingValues.size() == m_rowsPerStatement * m_columns.size())
+        flush();
+}
+
+void JsonTableLoader::skipRow(const QString &message)
+{
+    // rows before the skipped one are written first to keep the row indexes of the batch contiguous
+    flush();
+    m_rowErrors.append({m_nextRow, message});
+    m_nextRow++;
+    m_firstPendingRow = m_nextRow;
+}
+
+bool JsonTableLoader::finish()
+{
+    flush();
+    if (!m_database.commit()) {
+        m_errorString = m_database.lastError().text();
+        m_database.rollback();
+        return false;
+    }
+
+    if (!m_rowErrors.isEmpty())
+        LOG << m_rowErrors.size() << "rows could not be imported into" << m_tableName;
+    return true;
+}
+
+void JsonTableLoader::cancel()
+{
+    m_pendingValues.clear();
+    m_rowsInserted = 0;
+    m_database.rollback();
+}
+
+QString JsonTableLoader::insertStatement(int rows) const
+{
+    const QString row_placeholders = QLatin1Char('(')
+            + QStringList(m_columns.size(), QStringLiteral("?")).join(QLatin1Char(','))
+            + QLatin1Char(')');
+    return QStringLiteral("INSERT INTO %1 (%2) VALUES %3").arg(
+                m_tableName,
+                m_columns.join(QLatin1Char(',')),
+                QStringList(rows, row_placeholders).join(QLatin1Char(',')));
+}
+
+void JsonTableLoader::flush()
+{
+    if (m_pendingValues.isEmpty())
+        return;
+
+    const int column_count = m_columns.size();
+    const int row_count = m_pendingValues.size() / column_count;
+
+    // A batch is written with one statement, a failing statement leaves no rows behind.
+    // The last batch of a load is usually smaller and needs a statement of its own.
+    QSqlQuery partial_batch_query(m_database);
+    QSqlQuery *batch_query = &m_batchQuery;
+    if (row_count < m_rowsPerStatement) {
+        batch_query = &partial_batch_query;
+        if (row_count == 1 || !partial_batch_query.prepare(insertStatement(row_count)))
+            batch_query = nullptr;
+    }
+
+    if (batch_query != nullptr) {
+        for (int i = 0; i < m_pendingValues.size(); i++)
+            batch_query->bindValue(i, m_pendingValues.at(i));
+        if (batch_query->exec()) {
+            m_rowsInserted += row_count;
+            m_pendingValues.clear();
+            m_firstPendingRow = m_nextRow;
+            return;
+        }
+    }
+
+    // failed batches are inserted row by row to find the offending rows
+    for (int row = 0; row < row_count; row++) {
+        for (int column = 0; column < column_count; column++)
+            m_rowQuery.bindValue(column, m_pendingValues.at(row * column_count + column));
+        if (m_rowQuery.exec())
+            m_rowsInserted++;
+        else
+            m_rowErrors.append({m_firstPendingRow + row, m_rowQuery.lastError().text()});
+    }
+    m_pendingValues.clear();
+    m_firstPendingRow = m_nextRow;
+}
+
+} // namespace OPL
@@ -0,0 +1,118 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef JSONTABLELOADER_H
+#define JSONTABLELOADER_H
+#include <QtCore>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include "src/opl.h"
+
+namespace OPL {
+
+/*!
+ * \brief The JsonTableLoader class inserts JSON objects into a table of the database.
+ *
+ * \details The values of each object are bound positionally in the column order of the table, objects
+ * are collected into batches which are written with a single multi-row <tt>INSERT ... VALUES</tt> statement.
+ * The statements are prepared once per load. If a batch fails, its rows are inserted one by one, so that
+ * the failing rows can be reported with their index in rowErrors() while the valid rows are still imported.
+ *
+ * Keys which are not columns of the table are ignored, missing keys are inserted as NULL.
+ *
+ * Use loadFile() to stream a JSON array from a file in constant memory, or begin(), addRow() and finish()
+ * to insert rows from another source. All rows of a load are inserted in one transaction.
+ */
+class JsonTableLoader
+{
+public:
+    struct RowError {
+        qsizetype row;
+        QString message;
+    };
+
+    JsonTableLoader(OPL::DbTable table, const QSqlDatabase &database = QSqlDatabase::database());
+
+    /*!
+     * \brief Set the maximum number of rows inserted per statement (default: 256)
+     */
+    void setBatchSize(int rows) { m_batchSize = qMax(1, rows); }
+
+    /*!
+     * \brief Read a JSON array from file_path and insert each of its objects into the table
+     * \return false if the file could not be read or the transaction has failed. If the file is not valid
+     * JSON, no rows are inserted. Rows which could not be inserted do not fail the load, they are reported
+     * in rowErrors().
+     */
+    bool loadFile(const QString &file_path);
+
+    /*!
+     * \brief Start a new load, preparing the statements and opening a transaction
+     */
+    bool begin();
+
+    /*!
+     * \brief Add a row to the current batch, the batch is written to the database once it is full
+     */
+    void addRow(const QJsonObject &object);
+
+    /*!
+     * \brief Report a row that could not be read from its source and has been skipped
+     */
+    void skipRow(const QString &message);
+
+    /*!
+     * \brief Write the remaining rows and commit the transaction
+     */
+    bool finish();
+
+    /*!
+     * \brief Discard the rows of the current load and roll back the transaction
+     */
+    void cancel();
+
+    int rowsInserted() const { return m_rowsInserted; }
+    const QList<RowError> &rowErrors() const { return m_rowErrors; }
+    const QString &errorString() const { return m_errorString; }
+
+private:
+    // SQLite versions before 3.32 limit the number of host parameters per statement to 999
+    static constexpr int MAX_VARIABLES = 999;
+
+    QSqlDatabase m_database;
+    QString m_tableName;
+    QStringList m_columns;
+    int m_batchSize = 256;
+    int m_rowsPerStatement = 0;
+
+    QSqlQuery m_batchQuery;
+    QSqlQuery m_rowQuery;
+    QVariantList m_pendingValues;
+    qsizetype m_firstPendingRow = 0;
+    qsizetype m_nextRow = 0;
+
+    int m_rowsInserted = 0;
+    QList<RowError> m_rowErrors;
+    QString m_errorString;
+
+    QString insertStatement(int rows) const;
+    void flush();
+};
+
+} // namespace OPL
+
+#endif // JSONTABLELOADER_H
@@ -23,12 +23,12 @@ PilotEntry::PilotEntry()
     : Row(DbTable::Pilots, 0)
 {}
 
-PilotEntry::PilotEntry(const RowData_T &row_data)
-    : Row(DbTable::Pilots, 0, row_data)
+PilotEntry::PilotEntry(RowData_T row_data)
+    : Row(DbTable::Pilots, 0, std::move(row_data))
 {}
 
-PilotEntry::PilotEntry(int row_id, const RowData_T &row_data)
-    : Row(DbTable::Pilots, row_id, row_data)
+PilotEntry::PilotEntry(int row_id, RowData_T row_data)
+    : Row(DbTable::Pilots, row_id, std::move(row_data))
 {}
 
 const QString PilotEntry::getTableName() const
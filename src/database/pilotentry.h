@@ -29,8 +29,8 @@ class PilotEntry : public Row
     const static inline QString TABLE_NAME = QStringLiteral("pilots");
 public:
     PilotEntry();
-    PilotEntry(const RowData_T &row_data);
-    PilotEntry(int row_id, const RowData_T &row_data);
+    PilotEntry(RowData_T row_data);
+    PilotEntry(int row_id, RowData_T row_data);
     const QString getTableName() const override;
 
     /*!
@@ -23,12 +23,12 @@ PreviousExperienceEntry::PreviousExperienceEntry()
     : Row(DbTable::PreviousExperience, 0)
 {}
 
-PreviousExperienceEntry::PreviousExperienceEntry(const RowData_T &row_data)
-    : Row(DbTable::PreviousExperience, 0, row_data)
+PreviousExperienceEntry::PreviousExperienceEntry(RowData_T row_data)
+    : Row(DbTable::PreviousExperience, 0, std::move(row_data))
 {}
 
-PreviousExperienceEntry::PreviousExperienceEntry(int row_id, const RowData_T &row_data)
-    : Row(DbTable::PreviousExperience, row_id, row_data)
+PreviousExperienceEntry::PreviousExperienceEntry(int row_id, RowData_T row_data)
+    : Row(DbTable::PreviousExperience, row_id, std::move(row_data))
 {}
 
 const QString PreviousExperienceEntry::getTableName() const
@@ -30,8 +30,8 @@ class PreviousExperienceEntry : public Row
     const static inline QString TABLE_NAME = QStringLiteral("previousExperience");
 public:
     PreviousExperienceEntry();
-    PreviousExperienceEntry(const RowData_T &row_data);
-    PreviousExperienceEntry(int row_id, const RowData_T &row_data);
+    PreviousExperienceEntry(RowData_T row_data);
+    PreviousExperienceEntry(int row_id, RowData_T row_data);
     const QString getTableName() const override;
 
     // these literals already exist in the FlightEntry class, so we can just copy them
@@ -0,0 +1,109 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "routemetricscache.h"
+#include "src/database/database.h"
+#include "src/functions/calc.h"
+#include "src/functions/metrics.h"
+#include "src/testing/trace.h"
+
+namespace OPL {
+
+RouteMetrics RouteMetricsCache::metrics(const QString &dept, const QString &dest)
+{
+    static auto &hits = Metrics::counter(QStringLiteral("routemetrics/hits"));
+    static auto &misses = Metrics::counter(QStringLiteral("routemetrics/misses"));
+    ensureCoordinates();
+
+    const auto departure = m_coordinates.constFind(dept);
+    const auto destination = m_coordinates.constFind(dest);
+    if (departure == m_coordinates.constEnd() || destination == m_coordinates.constEnd())
+        return RouteMetrics();
+
+    const CityPair city_pair(dept, dest);
+    if (isCurrent(city_pair, *departure, *destination)) {
+        hits.add();
+        return m_entries.value(city_pair).metrics;
+    }
+
+    misses.add();
+    const CacheEntry entry{*departure, *destination, compute(*departure, *destination)};
+    m_entries.insert(city_pair, entry);
+    return entry.metrics;
+}
+
+void RouteMetricsCache::ensureCoordinates()
+{
+    if (!m_coordinatesStale)
+        return;
+
+    TRACE_FUNCTION("cache");
+    // Listen for updates on first use, re-read the coordinates if the airports have changed
+    QObject::connect(DBCache,      &OPL::DatabaseCache::databaseCacheUpdated,
+                     this,         &OPL::RouteMetricsCache::onDatabaseCacheUpdated,
+                     Qt::UniqueConnection);
+    QObject::connect(DB,           &OPL::Database::connectionReset,
+                     this,         &OPL::RouteMetricsCache::onConnectionReset,
+                     Qt::UniqueConnection);
+
+    const auto &icao_codes = DBCache->getAirportsMapICAO();
+    const auto &coordinates = DBCache->getAirportCoordinatesMap();
+    m_coordinates.clear();
+    m_coordinates.reserve(coordinates.size());
+    for (auto it = coordinates.cbegin(); it != coordinates.cend(); ++it) {
+        const auto icao = icao_codes.constFind(it.key());
+        if (icao != icao_codes.constEnd())
+            m_coordinates.insert(icao.value(), it.value());
+    }
+    m_coordinatesStale = false;
+}
+
+/*!
+ * \brief Returns true if the city pair is cached and has been computed from the given coordinates
+ */
+bool RouteMetricsCache::isCurrent(const CityPair &city_pair, const Coordinates &departure, const Coordinates &destination) const
+{
+    const auto it = m_entries.constFind(city_pair);
+    return it != m_entries.constEnd()
+            && it->departure.lat == departure.lat && it->departure.lon == departure.lon
+            && it->destination.lat == destination.lat && it->destination.lon == destination.lon;
+}
+
+RouteMetrics RouteMetricsCache::compute(const Coordinates &departure, const Coordinates &destination)
+{
+    RouteMetrics metrics;
+    metrics.distance = Calc::radToNauticalMiles(
+                Calc::greatCircleDistance(departure.lat, departure.lon, destination.lat, destination.lon));
+    metrics.initialBearing = Calc::initialBearing(departure.lat, departure.lon, destination.lat, destination.lon);
+    const auto midpoint = Calc::greatCircleMidpoint(departure.lat, departure.lon, destination.lat, destination.lon);
+    metrics.midpoint = {midpoint[0], midpoint[1]};
+    return metrics;
+}
+
+void RouteMetricsCache::onDatabaseCacheUpdated(const DbTable table)
+{
+    if (table == DbTable::Airports)
+        m_coordinatesStale = true;
+}
+
+void RouteMetricsCache::onConnectionReset()
+{
+    m_coordinatesStale = true;
+    m_entries.clear();
+}
+
+} // namespace OPL
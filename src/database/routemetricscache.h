@@ -0,0 +1,105 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef ROUTEMETRICSCACHE_H
+#define ROUTEMETRICSCACHE_H
+#include "src/opl.h"
+#include "src/database/databasecache.h"
+#include <QtCore>
+
+namespace OPL {
+
+/*!
+ * \brief The great circle metrics of a route between two airports
+ */
+struct RouteMetrics {
+    /*!
+     * \brief Great circle distance in nautical miles, -1 if the route is unknown
+     */
+    double distance = -1;
+    /*!
+     * \brief Initial true course in degrees 0:360
+     */
+    double initialBearing = 0;
+    /*!
+     * \brief The point halfway along the great circle track
+     */
+    Coordinates midpoint;
+
+    bool isValid() const { return distance >= 0; }
+};
+
+/*!
+ * \brief The RouteMetricsCache class caches the great circle metrics of every city pair
+ *
+ * \details Distances are not stored with the flights, so any statistic involving distances used to look up the
+ * coordinates of both airports and evaluate the great circle formulas for every flight. Pilots fly a small number of
+ * city pairs over and over again though. The RouteMetricsCache computes the metrics of a city pair once and keeps them
+ * keyed by departure and destination, so that aggregating distances only costs a hash lookup per flight.
+ *
+ * Nothing is done at start up. The airport coordinates are read from the DatabaseCache on the first lookup and the
+ * metrics of a city pair are computed when it is first looked up. Every entry keeps the coordinates it was computed
+ * from and is re-computed if the coordinates of one of its airports have changed since.
+ *
+ * \note The cache is only accessed from the GUI thread and is not thread-safe.
+ */
+class RouteMetricsCache : public QObject
+{
+    Q_OBJECT
+public:
+    static RouteMetricsCache* instance() {
+        static RouteMetricsCache instance;
+        return &instance;
+    }
+
+    RouteMetricsCache(RouteMetricsCache const&) = delete;
+    void operator=(RouteMetricsCache const&) = delete;
+
+    /*!
+     * \brief Returns the metrics of the route from dept to dest. The metrics are invalid if one of the
+     * airports is unknown or has no coordinates.
+     */
+    RouteMetrics metrics(const QString &dept, const QString &dest);
+
+private:
+    RouteMetricsCache() {};
+
+    using CityPair = QPair<QString, QString>;
+
+    struct CacheEntry {
+        Coordinates departure;
+        Coordinates destination;
+        RouteMetrics metrics;
+    };
+
+    bool m_coordinatesStale = true;
+    QHash<QString, Coordinates> m_coordinates;
+    QHash<CityPair, CacheEntry> m_entries;
+
+    void ensureCoordinates();
+    bool isCurrent(const CityPair &city_pair, const Coordinates &departure, const Coordinates &destination) const;
+
+    static RouteMetrics compute(const Coordinates &departure, const Coordinates &destination);
+
+public slots:
+    void onDatabaseCacheUpdated(const OPL::DbTable table);
+    void onConnectionReset();
+};
+
+} // namespace OPL
+
+#endif // ROUTEMETRICSCACHE_H
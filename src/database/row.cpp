@@ -16,6 +16,7 @@
  *along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 #include "row.h"
+#include <utility>
 
 namespace OPL {
 
@@ -28,8 +29,8 @@ Row::Row(DbTable table_name)
     rowId = 0; // new entry
 };
 
-Row::Row(OPL::DbTable table_name, int row_id, const RowData_T &row_data)
-    : table(table_name), rowId(row_id), rowData(row_data) {}
+Row::Row(OPL::DbTable table_name, int row_id, RowData_T row_data)
+    : table(table_name), rowId(row_id), rowData(std::move(row_data)) {}
 
 const RowData_T &Row::getData() const
 {
@@ -41,6 +42,26 @@ void Row::setData(const RowData_T &value)
     rowData = value;
 }
 
+void Row::setData(RowData_T &&value)
+{
+    rowData = std::move(value);
+}
+
+RowData_T Row::takeData()
+{
+    return std::exchange(rowData, RowData_T());
+}
+
+void Row::setValue(const QString &column, const QVariant &value)
+{
+    rowData.insert(column, value);
+}
+
+void Row::removeValue(const QString &column)
+{
+    rowData.remove(column);
+}
+
 int Row::getRowId() const
 {
     return rowId;
@@ -39,6 +39,10 @@ namespace OPL {
  * The Row Object holds all the necessary information the Database class needs to commit (create or update) it.
  * The Identifying information can be accessed with getRowId and getTable() / getTableName().
  *
+ * The row data is passed by value to the constructors, so temporaries are moved into the row instead of being copied.
+ * Use takeData() to move the data out of a row that is no longer needed and setValue() / removeValue() to modify
+ * single columns in place, instead of copying the data, modifying the copy and passing it back with setData().
+ *
  * For convenience and readabilty, subclasses exist that have the table property pre-set. These rows are then
  * referred to as entries. See AircraftEntry, FlightEntry etc. These subclasses have public static members which
  * hold the column names used in the sql database. These can be used to access the data held in the row by column.
@@ -54,7 +58,7 @@ public:
     /*!
      * \brief Create a row entry specifying its table, row id and row data.
      */
-    Row(OPL::DbTable table_name, int row_id, const RowData_T &row_data);
+    Row(OPL::DbTable table_name, int row_id, RowData_T row_data);
     /*!
      * \brief Create a row entry specifying its table and row id.
      */
@@ -68,6 +72,9 @@ public:
 
     Row(const Row&) = default;
     Row& operator=(const Row&) = default;
+    Row(Row&&) noexcept = default;
+    Row& operator=(Row&&) noexcept = default;
+    virtual ~Row() = default;
 
     /*!
      * \brief get the Row Data contained in the Row
@@ -76,6 +83,22 @@ public:
     const RowData_T& getData() const;
 
     void setData(const RowData_T &value);
+    void setData(RowData_T &&value);
+
+    /*!
+     * \brief moves the row data out of the row, leaving the row empty and invalid.
+     */
+    RowData_T takeData();
+
+    /*!
+     * \brief set the value of a single column in place
+     */
+    void setValue(const QString &column, const QVariant &value);
+
+    /*!
+     * \brief remove a single column from the row data in place
+     */
+    void removeValue(const QString &column);
 
     /*!
      * \brief Get the entries row id in the database
@@ -23,12 +23,12 @@ SimulatorEntry::SimulatorEntry()
     : Row(DbTable::Simulators, 0)
 {}
 
-SimulatorEntry::SimulatorEntry(const RowData_T &row_data)
-    : Row(DbTable::Simulators, 0, row_data)
+SimulatorEntry::SimulatorEntry(RowData_T row_data)
+    : Row(DbTable::Simulators, 0, std::move(row_data))
 {}
 
-SimulatorEntry::SimulatorEntry(int row_id, const RowData_T &row_data)
-    : Row(DbTable::Simulators, row_id, row_data)
+SimulatorEntry::SimulatorEntry(int row_id, RowData_T row_data)
+    : Row(DbTable::Simulators, row_id, std::move(row_data))
 {}
 
 const QString SimulatorEntry::getTableName() const
@@ -29,8 +29,8 @@ class SimulatorEntry : public Row
     const static inline QString TABLE_NAME = QStringLiteral("simulators");
 public:
     SimulatorEntry();
-    SimulatorEntry(const RowData_T &row_data);
-    SimulatorEntry(int row_id, const RowData_T &row_data);
+    SimulatorEntry(RowData_T row_data);
+    SimulatorEntry(int row_id, RowData_T row_data);
 
     const QString getTableName() const override;
 
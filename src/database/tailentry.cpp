@@ -23,12 +23,12 @@ TailEntry::TailEntry()
     : Row(DbTable::Tails, 0)
 {}
 
-TailEntry::TailEntry(const RowData_T &row_data)
-    : Row(DbTable::Tails, 0, row_data)
+TailEntry::TailEntry(RowData_T row_data)
+    : Row(DbTable::Tails, 0, std::move(row_data))
 {}
 
-TailEntry::TailEntry(int row_id, const RowData_T &row_data)
-    : Row(DbTable::Tails, row_id, row_data)
+TailEntry::TailEntry(int row_id, RowData_T row_data)
+    : Row(DbTable::Tails, row_id, std::move(row_data))
 {}
 
 const QString TailEntry::getTableName() const
@@ -59,9 +59,7 @@ const QString TailEntry::getTypeString() const {
 
 void TailEntry::setTypeString()
 {
-    auto data = getData();
-    data.insert(TailEntry::TYPE_STRING, getTypeString());
-    setData(data);
+    setValue(TailEntry::TYPE_STRING, getTypeString());
 }
 
 } // namespace OPL
@@ -34,8 +34,8 @@ class TailEntry : public Row
     const static inline QString TABLE_NAME = QStringLiteral("tails");
 public:
     TailEntry();
-    TailEntry(const RowData_T &row_data);
-    TailEntry(int row_id, const RowData_T &row_data);
+    TailEntry(RowData_T row_data);
+    TailEntry(int row_id, RowData_T row_data);
     const QString getTableName() const override;
 
     /*!
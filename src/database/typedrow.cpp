@@ -0,0 +1,34 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "typedrow.h"
+
+namespace OPL {
+
+quint32 StringPool::intern(const QString &string)
+{
+    const auto it = m_ids.constFind(string);
+    if (it != m_ids.cend())
+        return it.value();
+
+    const quint32 id = m_strings.size();
+    m_strings.append(string);
+    m_ids.insert(string, id);
+    return id;
+}
+
+} // namespace OPL
@@ -0,0 +1,180 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef TYPEDROW_H
+#define TYPEDROW_H
+#include "src/opl.h"
+#include "opl_schema.h"
+#include <QSqlQuery>
+#include <array>
+
+namespace OPL {
+
+/*!
+ * \brief The StringPool class interns the strings held by the typed rows of a TypedTable
+ * \details Text values which occur in many rows (airports, approach types, names) are stored only once,
+ * a row holds a 32 bit id instead. Every TypedTable owns its pool, so the strings are released together
+ * with the rows. A pool is filled while its table is read and not synchronised, reading it concurrently
+ * is safe once the table has been read.
+ */
+class StringPool
+{
+public:
+    quint32 intern(const QString &string);
+    QString string(quint32 id) const { return m_strings.value(id); }
+    void clear() { m_strings.clear(); m_ids.clear(); }
+
+private:
+    QVector<QString> m_strings;
+    QHash<QString, quint32> m_ids;
+};
+
+/*!
+ * \brief The TypedRow class holds a row of a database table in a fixed layout
+ *
+ * \details The layout is given by the table's descriptor in OPL::Schema, which is generated from the
+ * database schema at build time. Every column occupies 8 bytes, integers and reals are stored in place,
+ * text is interned in the StringPool of the TypedTable holding the row, which is passed to the methods
+ * reading or writing text. A bitmap records which columns are not NULL. A flight takes 256 bytes instead
+ * of the several kilobytes of a RowData_T with its hash nodes, column name keys and QVariants, and a
+ * column is accessed by its index.
+ *
+ * Typed rows are read-only and meant for scanning whole tables, as Calc::updateNightTimes() does. Row,
+ * its subclasses and getTable() keep using RowData_T, changes are committed with them. A table is read
+ * like this:
+ *
+ * \code
+ * const auto flights = DB->getTypedTable<OPL::Schema::Flights>();
+ * for (const auto &flight : flights)
+ *     total += flight.integer(OPL::Schema::Flights::TBLK);
+ * \endcode
+ */
+template<typename Table>
+class TypedRow
+{
+public:
+    using Column = typename Table::Column;
+    static_assert(Table::COLUMN_COUNT <= 64, "The null bitmap holds up to 64 columns");
+
+    bool isNull(Column column) const { return !(m_present & bit(column)); }
+
+    qint64 integer(Column column) const { return isNull(column) ? 0 : m_values[column].integer; }
+    double real(Column column) const { return isNull(column) ? 0.0 : m_values[column].real; }
+    QString text(Column column, const StringPool &strings) const
+    {
+        return isNull(column) ? QString() : strings.string(m_values[column].string);
+    }
+
+    void setInteger(Column column, qint64 value) { m_values[column].integer = value; m_present |= bit(column); }
+    void setReal(Column column, double value) { m_values[column].real = value; m_present |= bit(column); }
+    void setText(Column column, const QString &value, StringPool &strings)
+    {
+        m_values[column].string = strings.intern(value);
+        m_present |= bit(column);
+    }
+    void setNull(Column column) { m_present &= ~bit(column); }
+
+    /*!
+     * \brief Sets column from a QVariant. Null or empty values set the column to NULL.
+     */
+    void setValue(Column column, const QVariant &value, StringPool &strings)
+    {
+        if (value.isNull() || (value.typeId() == QMetaType::QString && value.toString().isEmpty())) {
+            setNull(column);
+            return;
+        }
+        switch (Table::COLUMNS[column].type) {
+        case Schema::ColumnType::Integer:
+            setInteger(column, value.toLongLong());
+            break;
+        case Schema::ColumnType::Real:
+            setReal(column, value.toDouble());
+            break;
+        case Schema::ColumnType::Text:
+            setText(column, value.toString(), strings);
+            break;
+        }
+    }
+
+    /*!
+     * \brief Reads the current record of a query which selects all columns of the table in schema order
+     */
+    static TypedRow fromQuery(const QSqlQuery &query, StringPool &strings)
+    {
+        TypedRow row;
+        for (int i = 0; i < Table::COLUMN_COUNT; i++)
+            row.setValue(Column(i), query.value(i), strings);
+        return row;
+    }
+
+    /*!
+     * \brief Returns a statement selecting all columns of the table in schema order
+     */
+    static QString selectStatement()
+    {
+        QStringList columns;
+        for (const auto &column : Table::COLUMNS)
+            columns.append(QString::fromLatin1(column.name));
+        return QLatin1String("SELECT ") + columns.join(QLatin1Char(','))
+                + QLatin1String(" FROM ") + QLatin1String(Table::TABLE_NAME);
+    }
+
+private:
+    union Value {
+        qint64 integer;
+        double real;
+        quint32 string;
+    };
+
+    static constexpr quint64 bit(Column column) { return quint64(1) << column; }
+
+    std::array<Value, Table::COLUMN_COUNT> m_values = {};
+    quint64 m_present = 0;
+};
+
+/*!
+ * \brief The TypedTable class holds the typed rows read from a table together with the StringPool of their text
+ * \details The strings are released together with the rows, reading the table again starts with an empty pool.
+ */
+template<typename Table>
+class TypedTable
+{
+public:
+    using Row = TypedRow<Table>;
+    using Column = typename Table::Column;
+
+    qsizetype size() const { return m_rows.size(); }
+    bool isEmpty() const { return m_rows.isEmpty(); }
+    auto begin() const { return m_rows.cbegin(); }
+    auto end() const { return m_rows.cend(); }
+
+    /*!
+     * \brief Appends the current record of a query which selects all columns of the table in schema order
+     */
+    void append(const QSqlQuery &query) { m_rows.append(Row::fromQuery(query, m_strings)); }
+    void clear() { m_rows.clear(); m_strings.clear(); }
+
+    QString text(const Row &row, Column column) const { return row.text(column, m_strings); }
+
+private:
+    QVector<Row> m_rows;
+    StringPool m_strings;
+};
+
+} // namespace OPL
+
+#endif // TYPEDROW_H
@@ -17,8 +17,10 @@
  */
 #include "calc.h"
 #include "src/database/database.h"
+#include "src/database/routemetricscache.h"
 #include "src/classes/settings.h"
 #include "src/opl.h"
+#include "src/testing/trace.h"
 
 /*!
  * \brief OPL::Calc::formatTimeInput verifies user input and formats to hh:mm
@@ -102,31 +104,43 @@ double OPL::Calc::greatCircleDistance(double lat1, double lon1, double lat2, dou
 
 double OPL::Calc::greatCircleDistanceBetweenAirports(const QString &dept, const QString &dest)
 {
-    QString statement = QLatin1String("SELECT lat, long FROM airports WHERE icao = '")
-            + dept
-            + QLatin1String("' OR icao = '")
-            + dest
-            + QLatin1String("'");
-    auto lat_lon = DB->customQuery(statement, 2);
-
-    if (lat_lon.length() != 4) {
+    const auto metrics = RouteMetricsCache::instance()->metrics(dept, dest);
+    if (!metrics.isValid()) {
         DEB << "Invalid input. Aborting.";
         return 0;
     }
+    return metrics.distance;
+}
 
-    double dept_lat = degToRad(lat_lon[0].toDouble());
-    double dept_lon = degToRad(lat_lon[1].toDouble());
-    double dest_lat = degToRad(lat_lon[2].toDouble());
-    double dest_lon = degToRad(lat_lon[3].toDouble());
 
-    // Haversine Formula
-    double delta_lon = dest_lon - dept_lon;
-    double delta_lat = dest_lat - dept_lat;
+double OPL::Calc::initialBearing(double lat1, double lon1, double lat2, double lon2)
+{
+    lat1 = degToRad(lat1);
+    lon1 = degToRad(lon1);
+    lat2 = degToRad(lat2);
+    lon2 = degToRad(lon2);
 
-    double result = pow(sin(delta_lat / 2), 2) +
-                    cos(dept_lat) * cos(dest_lat) * pow(sin(delta_lon / 2), 2);
-    result = 2 * asin(sqrt(result));
-    return radToNauticalMiles(result);
+    double delta_lon = lon2 - lon1;
+    double y = sin(delta_lon) * cos(lat2);
+    double x = cos(lat1) * sin(lat2) - sin(lat1) * cos(lat2) * cos(delta_lon);
+    return fmod(radToDeg(atan2(y, x)) + 360, 360);
+}
+
+
+QVector<double> OPL::Calc::greatCircleMidpoint(double lat1, double lon1, double lat2, double lon2)
+{
+    lat1 = degToRad(lat1);
+    lon1 = degToRad(lon1);
+    lat2 = degToRad(lat2);
+    lon2 = degToRad(lon2);
+
+    double delta_lon = lon2 - lon1;
+    double bx = cos(lat2) * cos(delta_lon);
+    double by = cos(lat2) * sin(delta_lon);
+    double lat = atan2(sin(lat1) + sin(lat2), sqrt(pow(cos(lat1) + bx, 2) + pow(by, 2)));
+    double lon = lon1 + atan2(by, cos(lat1) + bx);
+    // normalise to -180:180
+    return {radToDeg(lat), fmod(radToDeg(lon) + 540, 360) - 180};
 }
 
 
@@ -225,44 +239,49 @@ double OPL::Calc::solarElevation(const QDateTime &utc_time_point, double lat, do
 
 int OPL::Calc::calculateNightTime(const QString &dept, const QString &dest, const QDateTime &departureTime, int tblk, int night_angle)
 {
+    TRACE_FUNCTION("calc");
 
+    // order the result so that the departure airport comes first
     const QString statement = QLatin1String("SELECT lat, long FROM airports WHERE icao = '")
             + dept
             + QLatin1String("' OR icao = '") + dest
+            + QLatin1String("' ORDER BY icao = '") + dest
             + QLatin1String("'");
     auto lat_lon = DB->customQuery(statement, 2);
 
-    double dept_lat;
-    double dept_lon;
-    double dest_lat;
-    double dest_lon;
-    int night_time = 0;
-
     if (lat_lon.length() == 4) { // normal flight from A to B
-        dept_lat = lat_lon[0].toDouble();
-        dept_lon = lat_lon[1].toDouble();
-        dest_lat = lat_lon[2].toDouble();
-        dest_lon = lat_lon[3].toDouble();
+        return calculateNightTime(lat_lon[0].toDouble(), lat_lon[1].toDouble(),
+                                  lat_lon[2].toDouble(), lat_lon[3].toDouble(),
+                                  departureTime, tblk, night_angle);
     } else if (lat_lon.length() == 2 ) { // Dept == Dest, i.e. local flight
+        return calculateNightTime(lat_lon[0].toDouble(), lat_lon[1].toDouble(),
+                                  lat_lon[0].toDouble(), lat_lon[1].toDouble(),
+                                  departureTime, tblk, night_angle);
+    } else {
+        DEB << "Invalid input. Aborting.";
+        return 0;
+    }
+}
+
+int OPL::Calc::calculateNightTime(double dept_lat, double dept_lon, double dest_lat, double dest_lon,
+                                  const QDateTime &departureTime, int tblk, int night_angle)
+{
+    int night_time = 0;
+    if (dept_lat == dest_lat && dept_lon == dest_lon) { // local flight
         for (int i = 0; i < tblk; i++) {
-            dept_lat = lat_lon[0].toDouble();
-            dept_lon = lat_lon[1].toDouble();
             if (solarElevation(departureTime.addSecs(60 * i), dept_lat, dept_lon) < night_angle)
-
                 night_time++;
         }
         return night_time;
-    } else {
-        DEB << "Invalid input. Aborting.";
-        return 0;
     }
 
+    // the intermediate points are ordered from destination to departure
     QVector<QVector<double>> route = intermediatePointsOnGreatCircle(dept_lat, dept_lon,
                                                                      dest_lat, dest_lon,
                                                                      tblk);
     for (int i = 0; i < tblk ; i++) {
-        if (solarElevation(departureTime.addSecs(60 * i), route[i][0],
-                           route[i][1]) < night_angle) {
+        if (solarElevation(departureTime.addSecs(60 * i), route[tblk - i][0],
+                           route[tblk - i][1]) < night_angle) {
             night_time ++;
         }
     }
@@ -271,6 +290,7 @@ int OPL::Calc::calculateNightTime(const QString &dept, const QString &dest, cons
 
 bool OPL::Calc::isNight(const QString &icao, const QDateTime &event_time, int night_angle)
 {
+    TRACE_FUNCTION("calc");
     const QString statement = QLatin1String("SELECT lat, long FROM airports WHERE icao = '")
             + icao
             + QLatin1String("'");
@@ -300,40 +320,41 @@ bool OPL::Calc::isNight(const QString &icao, const QDateTime &event_time, int ni
  */
 void OPL::Calc::updateAutoTimes(int acft_id)
 {
-    //find all flights for aircraft
-    const QString statement = QStringLiteral("SELECT flight_id FROM flights WHERE acft = ") + QString::number(acft_id);
-    const auto flight_list = DB->customQuery(statement, 1);
+    TRACE_FUNCTION("calc");
+    //find all flights for aircraft, the flight id and block time of each flight are returned in turn
+    const QString statement = QStringLiteral("SELECT flight_id, tblk FROM flights WHERE acft = ") + QString::number(acft_id);
+    const auto flight_list = DB->customQuery(statement, 2);
     if (flight_list.isEmpty()) {
         DEB << "No flights for this tail found.";
         return;
     }
-    DEB << "Updating " << flight_list.length() << " flights with this aircraft.";
+    DEB << "Updating " << flight_list.length() / 2 << " flights with this aircraft.";
 
-    auto acft = DB->getTailEntry(acft_id);
-    auto acft_data = acft.getData();
-    for (const auto& item : flight_list) {
-        auto flight = DB->getFlightEntry(item.toInt());
-        auto flight_data = flight.getData();
+    const auto acft = DB->getTailEntry(acft_id);
+    const auto &acft_data = acft.getData();
+    for (qsizetype i = 0; i + 1 < flight_list.size(); i += 2) {
+        const int flight_id = flight_list.at(i).toInt();
+        const QVariant &tblk = flight_list.at(i + 1);
 
+        // only the category times are updated, the rest of the flight is left untouched
+        OPL::FlightEntry flight(flight_id, {});
         if(acft_data.value(OPL::TailEntry::MULTI_PILOT).toInt() == 0
             && acft_data.value(OPL::TailEntry::MULTI_ENGINE) == 0) {
-            DEB << "SPSE";
-            flight_data.insert(OPL::FlightEntry::TSPSE, flight_data.value(OPL::FlightEntry::TBLK));
-            flight_data.insert(OPL::FlightEntry::TSPME, QString());
-            flight_data.insert(OPL::FlightEntry::TMP, QString());
+            flight.setValue(OPL::FlightEntry::TSPSE, tblk);
+            flight.setValue(OPL::FlightEntry::TSPME, QString());
+            flight.setValue(OPL::FlightEntry::TMP, QString());
         } else if ((acft_data.value(OPL::TailEntry::MULTI_PILOT) == 0
-                    && acft.getData().value(OPL::TailEntry::MULTI_ENGINE) == 1)) {
-            DEB << "SPME";
-            flight_data.insert(OPL::FlightEntry::TSPME, flight_data.value(OPL::FlightEntry::TBLK));
-            flight_data.insert(OPL::FlightEntry::TSPSE, QString());
-            flight_data.insert(OPL::FlightEntry::TMP, QString());
+                    && acft_data.value(OPL::TailEntry::MULTI_ENGINE) == 1)) {
+            flight.setValue(OPL::FlightEntry::TSPME, tblk);
+            flight.setValue(OPL::FlightEntry::TSPSE, QString());
+            flight.setValue(OPL::FlightEntry::TMP, QString());
         } else if ((acft_data.value(OPL::TailEntry::MULTI_PILOT) == 1)) {
-            DEB << "MPME";
-            flight_data.insert(OPL::FlightEntry::TMP, flight_data.value(OPL::FlightEntry::TBLK));
-            flight_data.insert(OPL::FlightEntry::TSPSE, QString());
-            flight_data.insert(OPL::FlightEntry::TSPME, QString());
+            flight.setValue(OPL::FlightEntry::TMP, tblk);
+            flight.setValue(OPL::FlightEntry::TSPSE, QString());
+            flight.setValue(OPL::FlightEntry::TSPME, QString());
+        } else {
+            continue;
         }
-        flight.setData(flight_data);
         DB->commit(flight);
     }
 }
@@ -343,32 +364,29 @@ void OPL::Calc::updateAutoTimes(int acft_id)
  */
 void OPL::Calc::updateNightTimes()
 {
+    TRACE_FUNCTION("calc");
+    using Flights = OPL::Schema::Flights;
     int night_angle = Settings::getNightAngle();
 
-    //find all flights for aircraft
-    auto statement = QStringLiteral("SELECT ROWID FROM flights");
-    auto flight_list = DB->customQuery(statement, 1);
+    // read all flights in a single query
+    auto flight_list = DB->getTypedTable<Flights>();
 
     if (flight_list.isEmpty()) {
         DEB << "No flights found.";
         return;
     }
-    DEB << "Updating " << flight_list.length() << " flights in the database.";
-
-    for (const auto& item : std::as_const(flight_list)) {
-
-        auto flt = DB->getFlightEntry(item.toInt());
-        auto data = flt.getData();
-        auto dateTime = QDateTime(QDate::fromString(data.value(OPL::FlightEntry::DOFT).toString(), Qt::ISODate),
-                                  QTime().addSecs(data.value(OPL::FlightEntry::TOFB).toInt() * 60),
-                                  QTimeZone::UTC);
-        data.insert(OPL::FlightEntry::TNIGHT,
-                    calculateNightTime(data.value(OPL::FlightEntry::DEPT).toString(),
-                                       data.value(OPL::FlightEntry::DEST).toString(),
-                                       dateTime,
-                                       data.value(OPL::FlightEntry::TBLK).toInt(),
-                                       night_angle));
-        flt.setData(data);
-        DB->commit(flt);
+    DEB << "Updating " << flight_list.size() << " flights in the database.";
+
+    for (const auto& flight : flight_list) {
+        auto dateTime = QDateTime(QDate::fromJulianDay(flight.integer(Flights::DOFT)),
+                                  QTime(0, 0).addSecs(flight.integer(Flights::TOFB) * 60),
+                                  QTimeZone::utc());
+        const int night_time = calculateNightTime(flight_list.text(flight, Flights::DEPT),
+                                                  flight_list.text(flight, Flights::DEST),
+                                                  dateTime,
+                                                  flight.integer(Flights::TBLK),
+                                                  night_angle);
+        // update only the night time instead of writing back the whole row
+        DB->commit(OPL::FlightEntry(flight.integer(Flights::FLIGHT_ID), {{OPL::FlightEntry::TNIGHT, night_time}}));
     }
 }
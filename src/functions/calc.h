@@ -63,6 +63,16 @@ inline double radToNauticalMiles(double rad)
     return rad * 3440.06479482;
 }
 
+/*!
+ * \brief nauticalMilesToRad Convert nautical miles to Radians
+ * \param nautical miles
+ * \return rad
+ */
+inline double nauticalMilesToRad(double nautical_miles)
+{
+    return nautical_miles / 3440.06479482;
+}
+
 /*!
  * \brief greatCircleDistance Calculates Great Circle distance between two coordinates, return in Radians.
  * \param lat1 Location Latitude in degrees -90:90 ;S(-) N(+)
@@ -82,6 +92,26 @@ double greatCircleDistance(double lat1, double lon1, double lat2, double lon2);
  */
 double greatCircleDistanceBetweenAirports(const QString &dept, const QString &dest);
 
+/*!
+ * \brief initialBearing Calculates the initial true course of the Great Circle track from the first to the second coordinate
+ * \param lat1 Location Latitude in degrees -90:90 ;S(-) N(+)
+ * \param lon1 Location Longitude in degrees -180:180 W(-) E(+)
+ * \param lat2 Location Latitude in degrees -90:90 ;S(-) N(+)
+ * \param lon2 Location Longitude in degrees -180:180 W(-) E(+)
+ * \return bearing in degrees 0:360
+ */
+double initialBearing(double lat1, double lon1, double lat2, double lon2);
+
+/*!
+ * \brief greatCircleMidpoint Calculates the point halfway along the Great Circle track between two coordinates
+ * \param lat1 Location Latitude in degrees -90:90 ;S(-) N(+)
+ * \param lon1 Location Longitude in degrees -180:180 W(-) E(+)
+ * \param lat2 Location Latitude in degrees -90:90 ;S(-) N(+)
+ * \param lon2 Location Longitude in degrees -180:180 W(-) E(+)
+ * \return coordinate {lat,lon} of the midpoint
+ */
+QVector<double> greatCircleMidpoint(double lat1, double lon1, double lat2, double lon2);
+
 /*!
  * \brief  Calculates a list of points (lat,lon) along the Great Circle between two points.
  * The points are spaced equally, one minute of block time apart.
@@ -127,6 +157,14 @@ double solarElevation(const QDateTime& utc_time_point, double lat, double lon);
  */
 int calculateNightTime(const QString &dept, const QString &dest, const QDateTime& departureTime, int tblk, int nightAngle);
 
+/*!
+ * \brief Calculates which portion of a flight was conducted in night conditions from the coordinates of
+ * the departure and destination airport (in degrees). Use this overload if the coordinates are already known
+ * to avoid looking them up in the database.
+ */
+int calculateNightTime(double dept_lat, double dept_lon, double dest_lat, double dest_lon,
+                       const QDateTime& departureTime, int tblk, int nightAngle);
+
 bool isNight(const QString &icao, const QDateTime &event_time, int night_angle);
 
 QString formatTimeInput(QString user_input);
@@ -144,9 +182,6 @@ struct NightTimeValues{
     {
         nightMinutes = calculateNightTime(dept, dest, departure_time, block_minutes, night_angle);
 
-        OPL::Time nightTime = OPL::Time(nightMinutes, DateTimeFormat());
-        OPL::Time totalTime = OPL::Time(block_minutes, DateTimeFormat());
-
         if (nightMinutes == 0) { // all day
             takeOffNight = false;
             landingNight  = false;
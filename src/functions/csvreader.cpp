@@ -0,0 +1,197 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "csvreader.h"
+#include <array>
+#include <algorithm>
+
+namespace CSV {
+
+QString Reader::Row::toString(qsizetype index) const
+{
+    const QByteArrayView field = operator[](index);
+    return m_latin1 ? QString::fromLatin1(field) : QString::fromUtf8(field);
+}
+
+QStringList Reader::Row::toStringList() const
+{
+    QStringList fields;
+    fields.reserve(m_fields.size());
+    for (qsizetype i = 0; i < m_fields.size(); i++)
+        fields.append(toString(i));
+    return fields;
+}
+
+Reader::Reader(const QString &file_name)
+    : m_file(file_name)
+{}
+
+bool Reader::open()
+{
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+
+    if (m_file.size() > 0) {
+        const uchar *mapped = m_file.map(0, m_file.size());
+        if (mapped != nullptr) {
+            m_data = QByteArrayView(reinterpret_cast<const char *>(mapped), m_file.size());
+        } else {
+            m_buffer = m_file.readAll();
+            m_data = m_buffer;
+        }
+    }
+
+    m_position = 0;
+    detectEncoding();
+    detectDelimiter();
+    return true;
+}
+
+void Reader::detectEncoding()
+{
+    // UTF-16 and UTF-32 are identified by their byte order mark and converted to UTF-8
+    const auto encoding = QStringConverter::encodingForData(m_data);
+    if (encoding && *encoding != QStringConverter::Utf8) {
+        QStringDecoder decoder(*encoding);
+        m_buffer = QString(decoder(m_data)).toUtf8();
+        m_data = m_buffer;
+        m_encoding = *encoding;
+        return;
+    }
+
+    // skip the UTF-8 byte order mark
+    if (m_data.startsWith("\xEF\xBB\xBF")) {
+        m_position = 3;
+        return;
+    }
+
+    // Without a byte order mark, the input is treated as UTF-8 unless it contains invalid sequences
+    QStringDecoder decoder(QStringConverter::Utf8);
+    const QString sample = decoder.decode(m_data.first(qMin<qsizetype>(m_data.size(), 64 * 1024)));
+    if (decoder.hasError())
+        m_encoding = QStringConverter::Latin1;
+}
+
+void Reader::detectDelimiter()
+{
+    // count the candidates outside of quoted fields in the first line
+    static constexpr std::array<char, 4> candidates = {',', ';', '\t', '|'};
+    std::array<int, 4> counts = {};
+    bool quoted = false;
+    for (qsizetype i = m_position; i < m_data.size(); i++) {
+        const char c = m_data[i];
+        if (c == '"') {
+            quoted = !quoted;
+        } else if (!quoted) {
+            if (c == '\n' || c == '\r')
+                break;
+            for (size_t j = 0; j < candidates.size(); j++)
+                if (c == candidates[j])
+                    counts[j]++;
+        }
+    }
+
+    const auto max = std::max_element(counts.cbegin(), counts.cend());
+    if (*max > 0)
+        m_delimiter = candidates[std::distance(counts.cbegin(), max)];
+}
+
+bool Reader::readRow(Row &row)
+{
+    row.m_fields.clear();
+    row.m_unescapedFields.clear();
+    row.m_latin1 = m_encoding == QStringConverter::Latin1;
+
+    const char *data = m_data.data();
+    const qsizetype end = m_data.size();
+
+    // skip empty lines
+    while (m_position < end && (data[m_position] == '\n' || data[m_position] == '\r'))
+        m_position++;
+    if (m_position >= end)
+        return false;
+
+    qsizetype pos = m_position;
+    while (true) {
+        if (pos < end && data[pos] == '"') {
+            // quoted field, may contain delimiters, line breaks and escaped quotes
+            const qsizetype start = ++pos;
+            bool escaped = false;
+            while (pos < end) {
+                if (data[pos] == '"') {
+                    if (pos + 1 < end && data[pos + 1] == '"') {
+                        escaped = true;
+                        pos += 2;
+                        continue;
+                    }
+                    break;
+                }
+                pos++;
+            }
+
+            const QByteArrayView field(data + start, pos - start);
+            if (escaped) {
+                QByteArray unescaped = field.toByteArray();
+                unescaped.replace("\"\"", "\"");
+                row.m_unescapedFields.append(unescaped);
+                row.m_fields.append(QByteArrayView(row.m_unescapedFields.last()));
+            } else {
+                row.m_fields.append(field);
+            }
+
+            // skip the closing quote and anything up to the next delimiter (malformed input)
+            while (pos < end && data[pos] != m_delimiter && data[pos] != '\n' && data[pos] != '\r')
+                pos++;
+        } else {
+            const qsizetype start = pos;
+            while (pos < end && data[pos] != m_delimiter && data[pos] != '\n' && data[pos] != '\r')
+                pos++;
+            row.m_fields.append(QByteArrayView(data + start, pos - start));
+        }
+
+        if (pos < end && data[pos] == m_delimiter) {
+            pos++;
+            // a trailing delimiter at the end of the file is followed by an empty field
+            if (pos >= end)
+                row.m_fields.append(QByteArrayView());
+            else
+                continue;
+        }
+        break;
+    }
+
+    // consume the line break
+    if (pos < end && data[pos] == '\r')
+        pos++;
+    if (pos < end && data[pos] == '\n')
+        pos++;
+
+    m_position = pos;
+    return true;
+}
+
+void Reader::forEachRow(const std::function<bool (const Row &)> &callback)
+{
+    Row row;
+    while (readRow(row))
+        if (!callback(row))
+            return;
+}
+
+} // namespace CSV
@@ -0,0 +1,131 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CSVREADER_H
+#define CSVREADER_H
+
+#include <QtCore>
+#include <QStringConverter>
+#include <functional>
+
+namespace CSV {
+
+/*!
+ * \brief The Reader class is a streaming, RFC 4180 compliant CSV tokenizer.
+ *
+ * \details The input file is memory-mapped and parsed one row at a time, so that large files can be read
+ * in constant memory. The fields of a row are returned as views into the mapped file. Only fields containing
+ * escaped quotes (<tt>""</tt>) are copied, since they need to be unescaped.
+ *
+ * The Reader supports
+ * - quoted fields, which may contain delimiters, line breaks and escaped quotes
+ * - LF and CRLF line endings
+ * - UTF-8 and UTF-16 input (detected by the byte order mark) as well as Latin-1, which is assumed if the
+ * input is not valid UTF-8. UTF-16 input is converted to UTF-8 before parsing.
+ * - automatic detection of the delimiter (comma, semicolon, tab or pipe) from the first line of the file
+ *
+ * Use readRow() to iterate over the rows of the file or forEachRow() to process every row with a callback.
+ */
+class Reader
+{
+public:
+    /*!
+     * \brief A single row of the CSV file.
+     * \details The fields are views into the file and are only valid until the next row is read
+     * or the Reader is destroyed. Use toString() to create a decoded copy of a field.
+     */
+    class Row
+    {
+    public:
+        qsizetype size() const { return m_fields.size(); }
+        bool isEmpty() const { return m_fields.isEmpty(); }
+
+        /*!
+         * \brief Returns a view of the raw field. Out of range indexes return an empty view.
+         */
+        QByteArrayView operator[](qsizetype index) const
+        { return index < m_fields.size() ? m_fields[index] : QByteArrayView(); }
+
+        /*!
+         * \brief Returns the decoded field at index. Out of range indexes return an empty string.
+         */
+        QString toString(qsizetype index) const;
+
+        /*!
+         * \brief Returns all fields of the row as decoded strings
+         */
+        QStringList toStringList() const;
+
+    private:
+        friend class Reader;
+        QVarLengthArray<QByteArrayView, 128> m_fields;
+        QList<QByteArray> m_unescapedFields;
+        bool m_latin1 = false;
+    };
+
+    explicit Reader(const QString &file_name);
+
+    /*!
+     * \brief Maps the file into memory and detects its encoding and delimiter.
+     * \return true if the file could be opened, otherwise errorString() contains a description of the error
+     */
+    bool open();
+
+    /*!
+     * \brief Parses the next row of the file into row
+     * \return false if the end of the file has been reached
+     */
+    bool readRow(Row &row);
+
+    /*!
+     * \brief Calls callback for every remaining row of the file until the callback returns false.
+     */
+    void forEachRow(const std::function<bool(const Row &row)> &callback);
+
+    char delimiter() const { return m_delimiter; }
+
+    /*!
+     * \brief Overrides the automatically detected delimiter
+     */
+    void setDelimiter(char delimiter) { m_delimiter = delimiter; }
+
+    QStringConverter::Encoding encoding() const { return m_encoding; }
+
+    /*!
+     * \brief The number of bytes that have been parsed, can be used to report progress together with size()
+     */
+    qsizetype position() const { return m_position; }
+    qsizetype size() const { return m_data.size(); }
+
+    const QString &errorString() const { return m_errorString; }
+
+private:
+    QFile m_file;
+    QByteArray m_buffer;    // holds the file contents if the file can not be mapped or has been converted
+    QByteArrayView m_data;
+    qsizetype m_position = 0;
+    char m_delimiter = ',';
+    QStringConverter::Encoding m_encoding = QStringConverter::Utf8;
+    QString m_errorString;
+
+    void detectEncoding();
+    void detectDelimiter();
+};
+
+} // namespace CSV
+
+#endif // CSVREADER_H
@@ -0,0 +1,94 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "csvwriter.h"
+
+namespace CSV {
+
+Writer::Writer(const QString &file_name, char delimiter)
+    : m_file(file_name), m_delimiter(delimiter)
+{
+    m_buffer.reserve(BUFFER_SIZE);
+}
+
+bool Writer::open()
+{
+    return m_file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+}
+
+void Writer::writeField(QStringView field)
+{
+    if (!m_firstField)
+        m_buffer.append(m_delimiter);
+    m_firstField = false;
+
+    const QByteArray data = field.toUtf8();
+    const bool needs_quotes = data.contains(m_delimiter) || data.contains('"')
+            || data.contains('\n') || data.contains('\r');
+    if (needs_quotes) {
+        m_buffer.append('"');
+        for (const char c : data) {
+            if (c == '"')
+                m_buffer.append('"');
+            m_buffer.append(c);
+        }
+        m_buffer.append('"');
+    } else {
+        m_buffer.append(data);
+    }
+}
+
+void Writer::endRow()
+{
+    m_buffer.append("\r\n", 2);
+    m_firstField = true;
+    if (m_buffer.size() >= BUFFER_SIZE)
+        flush();
+}
+
+void Writer::writeRow(const QStringList &fields)
+{
+    for (const auto &field : fields)
+        writeField(field);
+    endRow();
+}
+
+bool Writer::close()
+{
+    flush();
+    if (m_error) {
+        m_file.cancelWriting();
+        return false;
+    }
+    return m_file.commit();
+}
+
+void Writer::cancel()
+{
+    m_buffer.resize(0);
+    m_file.cancelWriting();
+    m_file.commit();
+}
+
+void Writer::flush()
+{
+    if (m_file.write(m_buffer) != m_buffer.size())
+        m_error = true;
+    m_buffer.resize(0); // keeps the allocated capacity
+}
+
+} // namespace CSV
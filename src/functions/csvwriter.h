@@ -0,0 +1,88 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CSVWRITER_H
+#define CSVWRITER_H
+
+#include <QtCore>
+#include <QSaveFile>
+
+namespace CSV {
+
+/*!
+ * \brief The Writer class writes RFC 4180 compliant CSV files through a buffer.
+ *
+ * \details Fields containing the delimiter, quotes or line breaks are quoted and quotes are escaped. Rows are
+ * terminated with CRLF and the output is encoded as UTF-8. Data is buffered in memory and written to disk in
+ * blocks of BUFFER_SIZE bytes, so arbitrarily large files can be written in constant memory.
+ *
+ * The output is written to a temporary file, which replaces the target file when close() is called. If
+ * writing is cancelled or fails, the target file remains untouched.
+ */
+class Writer
+{
+public:
+    explicit Writer(const QString &file_name, char delimiter = ',');
+
+    /*!
+     * \brief Opens the temporary output file
+     */
+    bool open();
+
+    /*!
+     * \brief Appends a field to the current row
+     */
+    void writeField(QStringView field);
+
+    /*!
+     * \brief Terminates the current row
+     */
+    void endRow();
+
+    /*!
+     * \brief Writes a complete row
+     */
+    void writeRow(const QStringList &fields);
+
+    /*!
+     * \brief Flushes the buffer and replaces the target file with the written data
+     * \return true if all data has been written successfully
+     */
+    bool close();
+
+    /*!
+     * \brief Discards all data that has been written, the target file remains untouched.
+     */
+    void cancel();
+
+    QString errorString() const { return m_file.errorString(); }
+
+private:
+    QSaveFile m_file;
+    QByteArray m_buffer;
+    char m_delimiter;
+    bool m_firstField = true;
+    bool m_error = false;
+
+    static constexpr qsizetype BUFFER_SIZE = 64 * 1024;
+
+    void flush();
+};
+
+} // namespace CSV
+
+#endif // CSVWRITER_H
@@ -0,0 +1,224 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef DATETIMEPARSER_H
+#define DATETIMEPARSER_H
+#include <QtCore>
+
+namespace OPL {
+
+/*!
+ * \brief The DateTimeParser class parses dates and times in fixed layouts without allocating memory.
+ *
+ * \details QDate::fromString() and QTime::fromString() interpret a format string on every call and allocate
+ * while doing so, which is noticeable when parsing thousands of values, for example during an import. The
+ * functions of this class support a small set of fixed layouts and convert directly to the database
+ * format, i.e. julian days and minutes.
+ *
+ * All functions return INVALID if the input does not match the expected layout or is out of range.
+ */
+class DateTimeParser
+{
+public:
+    DateTimeParser() = delete;
+
+    /*!
+     * \brief The supported date layouts. Day and month may have one or two digits, the year has four digits.
+     * Any of '/', '.' or '-' is accepted as separator.
+     */
+    enum class DateLayout {
+        DayMonthYear,   // dd/MM/yyyy, dd.MM.yyyy
+        MonthDayYear,   // MM/dd/yyyy
+        YearMonthDay    // yyyy-MM-dd (ISO 8601)
+    };
+
+    static constexpr int INVALID = -1;
+
+    /*!
+     * \brief Returns the layout matching a Qt date format string, or std::nullopt if the format is not supported
+     */
+    static std::optional<DateLayout> layoutFromFormat(QStringView format)
+    {
+        if (format == u"dd/MM/yyyy" || format == u"dd.MM.yyyy" || format == u"d/M/yyyy" || format == u"d.M.yyyy")
+            return DateLayout::DayMonthYear;
+        if (format == u"MM/dd/yyyy" || format == u"M/d/yyyy")
+            return DateLayout::MonthDayYear;
+        if (format == u"yyyy-MM-dd")
+            return DateLayout::YearMonthDay;
+        return std::nullopt;
+    }
+
+    /*!
+     * \brief Parses a date and returns its julian day
+     */
+    static constexpr int julianDay(QStringView text, DateLayout layout)
+    {
+        qsizetype pos = 0;
+        int first = 0, second = 0, third = 0;
+        const int first_digits = layout == DateLayout::YearMonthDay ? 4 : 2;
+        const int third_digits = layout == DateLayout::YearMonthDay ? 2 : 4;
+        if (!readNumber(text, pos, first_digits, first) || !readSeparator(text, pos)
+                || !readNumber(text, pos, 2, second) || !readSeparator(text, pos)
+                || !readNumber(text, pos, third_digits, third) || pos != text.size())
+            return INVALID;
+
+        switch (layout) {
+        case DateLayout::DayMonthYear:
+            return toJulianDay(third, second, first);
+        case DateLayout::MonthDayYear:
+            return toJulianDay(third, first, second);
+        case DateLayout::YearMonthDay:
+            return toJulianDay(first, second, third);
+        }
+        return INVALID;
+    }
+
+    /*!
+     * \brief Parses a time of day in the h:mm, hh:mm or hhmm layout and returns the minutes since midnight
+     */
+    static constexpr int minutesOfDay(QStringView text)
+    {
+        const int minutes = hoursAndMinutes(text);
+        return minutes < MINUTES_PER_DAY ? minutes : INVALID;
+    }
+
+    /*!
+     * \brief Parses a duration in the h:mm layout, where the hours are not limited, and returns the minutes.
+     * The hhmm layout is accepted as well.
+     */
+    static constexpr int durationMinutes(QStringView text)
+    {
+        return hoursAndMinutes(text);
+    }
+
+    /*!
+     * \brief Parses a duration given in decimal hours, e.g. 1.5, and returns the rounded minutes
+     * \details Both '.' and ',' are accepted as decimal separator.
+     */
+    static constexpr int decimalHoursToMinutes(QStringView text)
+    {
+        qsizetype pos = 0;
+        int hours = 0;
+        const bool has_hours = readNumber(text, pos, 6, hours);
+        if (pos == text.size())
+            return has_hours ? hours * 60 : INVALID;
+        if (text[pos] != u'.' && text[pos] != u',')
+            return INVALID;
+        pos++;
+
+        // scale the fraction to 1/10000 of an hour, further digits only affect rounding
+        int fraction = 0;
+        int scale = 1000;
+        int digits = 0;
+        for (; pos < text.size(); pos++, digits++) {
+            const int digit = text[pos].unicode() - u'0';
+            if (digit < 0 || digit > 9)
+                return INVALID;
+            if (scale > 0) {
+                fraction += digit * scale;
+                scale /= 10;
+            }
+        }
+        if (!has_hours && digits == 0)
+            return INVALID;
+        return hours * 60 + (fraction * 60 + 5000) / 10000;
+    }
+
+    /*!
+     * \brief Converts a gregorian calendar date to a julian day
+     * \return the julian day or INVALID if the date does not exist
+     */
+    static constexpr int toJulianDay(int year, int month, int day)
+    {
+        if (month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month))
+            return INVALID;
+        // see https://en.wikipedia.org/wiki/Julian_day#Converting_Gregorian_calendar_date_to_Julian_Day_Number
+        const int a = (14 - month) / 12;
+        const int y = year + 4800 - a;
+        const int m = month + 12 * a - 3;
+        return day + (153 * m + 2) / 5 + 365 * y + y / 4 - y / 100 + y / 400 - 32045;
+    }
+
+private:
+    static constexpr int MINUTES_PER_DAY = 24 * 60;
+
+    static constexpr bool isLeapYear(int year)
+    {
+        return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    }
+
+    static constexpr int daysInMonth(int year, int month)
+    {
+        constexpr int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        return month == 2 && isLeapYear(year) ? 29 : days[month - 1];
+    }
+
+    /*!
+     * \brief Reads between one and max_digits digits starting at pos
+     */
+    static constexpr bool readNumber(QStringView text, qsizetype &pos, int max_digits, int &value)
+    {
+        const qsizetype start = pos;
+        value = 0;
+        while (pos < text.size() && pos - start < max_digits) {
+            const int digit = text[pos].unicode() - u'0';
+            if (digit < 0 || digit > 9)
+                break;
+            value = value * 10 + digit;
+            pos++;
+        }
+        return pos > start;
+    }
+
+    static constexpr bool readSeparator(QStringView text, qsizetype &pos)
+    {
+        if (pos >= text.size())
+            return false;
+        const QChar c = text[pos++];
+        return c == u'/' || c == u'.' || c == u'-';
+    }
+
+    static constexpr int hoursAndMinutes(QStringView text)
+    {
+        qsizetype colon = -1;
+        for (qsizetype i = 0; i < text.size() && colon == -1; i++)
+            if (text[i] == u':')
+                colon = i;
+        qsizetype pos = 0;
+        int hours = 0, minutes = 0;
+        if (colon == -1) {
+            // hhmm
+            if (text.size() < 3 || text.size() > 4)
+                return INVALID;
+            if (!readNumber(text, pos, text.size() - 2, hours) || !readNumber(text, pos, 2, minutes)
+                    || pos != text.size())
+                return INVALID;
+        } else {
+            if (!readNumber(text, pos, 6, hours) || pos != colon)
+                return INVALID;
+            pos++;
+            const qsizetype minutes_start = pos;
+            if (!readNumber(text, pos, 2, minutes) || pos != text.size() || pos - minutes_start != 2)
+                return INVALID;
+        }
+        return minutes < 60 ? hours * 60 + minutes : INVALID;
+    }
+};
+
+} // namespace OPL
+
+#endif // DATETIMEPARSER_H
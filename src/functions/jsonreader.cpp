@@ -0,0 +1,161 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "jsonreader.h"
+
+namespace JSON {
+
+ArrayReader::ArrayReader(const QString &file_name)
+    : m_file(file_name)
+{}
+
+bool ArrayReader::open()
+{
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+
+    if (m_file.size() > 0) {
+        const uchar *mapped = m_file.map(0, m_file.size());
+        if (mapped != nullptr) {
+            m_data = QByteArrayView(reinterpret_cast<const char *>(mapped), m_file.size());
+        } else {
+            m_buffer = m_file.readAll();
+            m_data = m_buffer;
+        }
+    }
+
+    m_position = m_data.startsWith("\xEF\xBB\xBF") ? 3 : 0;
+    m_index = -1;
+    m_atEnd = false;
+
+    skipWhitespace();
+    if (m_position >= m_data.size() || m_data[m_position] != '[') {
+        setError(QStringLiteral("The file does not contain a JSON array."));
+        return false;
+    }
+    m_position++;
+    skipWhitespace();
+    if (m_position < m_data.size() && m_data[m_position] == ']')
+        m_atEnd = true;
+    return true;
+}
+
+bool ArrayReader::readElement(QJsonValue &value)
+{
+    if (m_atEnd || hasError())
+        return false;
+
+    skipWhitespace();
+    const qsizetype end = elementEnd();
+    if (end < 0) {
+        setError(QStringLiteral("Unexpected end of file."));
+        return false;
+    }
+    if (end == m_position) {
+        setError(QStringLiteral("Missing element."));
+        return false;
+    }
+
+    // QJsonDocument only parses objects and arrays, so the element is wrapped in an array of its own
+    QByteArray element;
+    element.reserve(end - m_position + 2);
+    element.append('[').append(m_data.sliced(m_position, end - m_position)).append(']');
+
+    QJsonParseError parse_error;
+    const QJsonDocument doc = QJsonDocument::fromJson(element, &parse_error);
+    if (parse_error.error != QJsonParseError::NoError) {
+        setError(parse_error.errorString());
+        return false;
+    }
+
+    value = doc.array().first();
+    m_index++;
+    m_position = end;
+
+    // the element has to be followed by a separator or the end of the array
+    skipWhitespace();
+    if (m_position < m_data.size() && m_data[m_position] == ',') {
+        m_position++;
+    } else if (m_position < m_data.size() && m_data[m_position] == ']') {
+        m_position++;
+        m_atEnd = true;
+    } else {
+        setError(QStringLiteral("Expected ',' or ']' after element."));
+    }
+    return true;
+}
+
+void ArrayReader::skipWhitespace()
+{
+    while (m_position < m_data.size()) {
+        const char c = m_data[m_position];
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t')
+            break;
+        m_position++;
+    }
+}
+
+qsizetype ArrayReader::elementEnd() const
+{
+    // Track nesting outside of strings, the element ends at the first separator on the top level.
+    // Validation of the element itself is left to the JSON parser.
+    int depth = 0;
+    bool in_string = false;
+    for (qsizetype i = m_position; i < m_data.size(); i++) {
+        const char c = m_data[i];
+        if (in_string) {
+            if (c == '\\')
+                i++;
+            else if (c == '"')
+                in_string = false;
+            continue;
+        }
+
+        switch (c) {
+        case '"':
+            in_string = true;
+            break;
+        case '{':
+        case '[':
+            depth++;
+            break;
+        case '}':
+        case ']':
+            if (depth == 0)
+                return i; // closing bracket of the array
+            if (--depth == 0)
+                return i + 1;
+            break;
+        case ',':
+            if (depth == 0)
+                return i;
+            break;
+        default:
+            break;
+        }
+    }
+    return -1;
+}
+
+void ArrayReader::setError(const QString &message)
+{
+    m_errorString = QStringLiteral("%1 (element %2, offset %3)").arg(message).arg(m_index + 1).arg(m_position);
+}
+
+} // namespace JSON
@@ -0,0 +1,89 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef JSONREADER_H
+#define JSONREADER_H
+
+#include <QtCore>
+
+namespace JSON {
+
+/*!
+ * \brief The ArrayReader class reads the elements of a top-level JSON array one at a time.
+ *
+ * \details The input file is memory-mapped and scanned for the boundaries of each element of the array.
+ * Only the current element is parsed into a QJsonValue, so that large files can be processed in constant
+ * memory instead of building a QJsonDocument of the complete file. The input has to be UTF-8 encoded, an
+ * optional byte order mark is skipped.
+ *
+ * Use readElement() to iterate over the elements. A syntax error inside an element stops the reader,
+ * hasError() and errorString() can be used to tell this apart from the end of the array.
+ */
+class ArrayReader
+{
+public:
+    explicit ArrayReader(const QString &file_name);
+
+    /*!
+     * \brief Maps the file into memory and positions the reader at the first element of the array.
+     * \return true if the file could be opened and contains a JSON array, otherwise errorString() contains
+     * a description of the error
+     */
+    bool open();
+
+    /*!
+     * \brief Parses the next element of the array into value
+     * \return false if the end of the array has been reached or an error has ocurred
+     */
+    bool readElement(QJsonValue &value);
+
+    /*!
+     * \brief The zero-based index of the element that has last been read
+     */
+    qsizetype index() const { return m_index; }
+
+    /*!
+     * \brief The number of bytes that have been parsed, can be used to report progress together with size()
+     */
+    qsizetype position() const { return m_position; }
+    qsizetype size() const { return m_data.size(); }
+
+    bool hasError() const { return !m_errorString.isEmpty(); }
+    const QString &errorString() const { return m_errorString; }
+
+private:
+    QFile m_file;
+    QByteArray m_buffer;    // holds the file contents if the file can not be mapped
+    QByteArrayView m_data;
+    qsizetype m_position = 0;
+    qsizetype m_index = -1;
+    bool m_atEnd = false;
+    QString m_errorString;
+
+    void skipWhitespace();
+
+    /*!
+     * \brief Returns the position after the element starting at m_position, or -1 if the element is incomplete
+     */
+    qsizetype elementEnd() const;
+
+    void setError(const QString &message);
+};
+
+} // namespace JSON
+
+#endif // JSONREADER_H
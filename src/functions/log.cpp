@@ -17,13 +17,316 @@
  */
 #include "log.h"
 #include "src/classes/paths.h"
+#include "src/functions/metrics.h"
 #include <QMessageBox>
 #include <QTextStream>
+#include <QThread>
+#include <QSemaphore>
+#include <QMutex>
+#include <QLoggingCategory>
+#include <QReadWriteLock>
+#include <atomic>
+#include <cstdio>
 
 namespace OPL::Log {
 
+static QDir logFolder;
+static QString logFileName;
 static bool logDebug = false; // Debug doesn't log to file by default
 
+namespace {
+
+/*!
+ * \brief A message as it has been received by the message handler
+ * \details The context strings point to string literals and stay valid for the lifetime of the application.
+ */
+struct Record {
+    QtMsgType type = QtDebugMsg;
+    QString message;
+    const char *function = nullptr;
+    const char *file = nullptr;
+    int line = 0;
+    qint64 msecsSinceStartOfDay = 0;
+};
+
+/*!
+ * \brief A bounded multi-producer, single-consumer ring buffer.
+ * \details Each slot carries a sequence number which tells producers and the consumer whether the slot
+ * is free or holds a record of the current lap, so that no locks are needed.
+ */
+class RingBuffer
+{
+public:
+    RingBuffer()
+    {
+        for (size_t i = 0; i < bufferSize; i++)
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    bool push(Record &&record)
+    {
+        size_t position = m_head.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot &slot = m_slots[position & MASK];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (difference == 0) {
+                if (m_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.record = std::move(record);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false; // full
+            } else {
+                position = m_head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool pop(Record &record)
+    {
+        Slot &slot = m_slots[m_tail & MASK];
+        if (slot.sequence.load(std::memory_order_acquire) != m_tail + 1)
+            return false; // empty or not yet completely written
+
+        record = std::move(slot.record);
+        slot.sequence.store(m_tail + bufferSize, std::memory_order_release);
+        m_tail++;
+        return true;
+    }
+
+private:
+    static constexpr size_t MASK = bufferSize - 1;
+    static_assert((bufferSize & MASK) == 0, "The buffer size has to be a power of 2");
+
+    struct Slot {
+        std::atomic<size_t> sequence;
+        Record record;
+    };
+    Slot m_slots[bufferSize];
+    alignas(64) std::atomic<size_t> m_head = 0;
+    alignas(64) size_t m_tail = 0; // only accessed by the consumer
+};
+
+/*!
+ * \brief Counts the messages of a call site in the current second
+ */
+struct RateCounter {
+    qint64 second = -1;
+    int count = 0;
+    int suppressed = 0;
+};
+
+RingBuffer *buffer = nullptr;
+std::atomic<QThread *> writerThread = nullptr;
+QMutex shutdownMutex;
+QMutex synchronousMutex; // serialises messages written without the writer thread
+QSemaphore wakeUp;
+std::atomic<bool> writerWaiting = false;
+std::atomic<bool> stopRequested = false;
+std::atomic<quint64> dropped = 0;
+std::atomic<quint64> pushed = 0;
+std::atomic<quint64> written = 0;
+std::atomic<int> rateLimit = defaultRateLimit;
+
+// only accessed by the writer thread, or by the message handler once the writer has stopped
+QFile logFile;
+QTextStream logStream;
+QTextStream consoleStream(stdout);
+qint64 logFileSize = 0;
+quint64 reportedDrops = 0;
+QHash<QPair<const void *, int>, RateCounter> rateCounters;
+int suppressingSites = 0; // number of rate counters with suppressed messages
+
+// category levels, applied by the category filter
+QReadWriteLock levelLock;
+QHash<QString, int> categoryLevels;
+QLoggingCategory::CategoryFilter defaultFilter = nullptr;
+
+/*!
+ * \brief QtMsgType is not ordered by severity, map it to a rank
+ */
+int severity(QtMsgType type)
+{
+    switch (type) {
+    case QtDebugMsg:    return 0;
+    case QtInfoMsg:     return 1;
+    case QtWarningMsg:  return 2;
+    case QtCriticalMsg: return 3;
+    case QtFatalMsg:    return 4;
+    }
+    return 1;
+}
+
+void categoryFilter(QLoggingCategory *category)
+{
+    if (defaultFilter)
+        defaultFilter(category);
+
+    QReadLocker locker(&levelLock);
+    const auto it = categoryLevels.constFind(QString::fromLatin1(category->categoryName()));
+    if (it == categoryLevels.cend())
+        return;
+    for (const auto type : {QtDebugMsg, QtInfoMsg, QtWarningMsg, QtCriticalMsg})
+        category->setEnabled(type, severity(type) >= it.value());
+}
+
+void openLogFile()
+{
+    logFile.close();
+    logFile.setFileName(logFileName);
+    logFile.open(QIODevice::WriteOnly | QIODevice::Append);
+    logFileSize = logFile.size();
+    logStream.setDevice(&logFile);
+}
+
+void reportSuppressed(RateCounter &counter)
+{
+    logStream << timeNow() << WARN_HEADER << counter.suppressed << " similar messages suppressed" << SPACER << "\n";
+    counter.suppressed = 0;
+    suppressingSites--;
+}
+
+/*!
+ * \brief Reports the messages suppressed in previous seconds, or all suppressed messages if all is true
+ * \details Called after every batch, so that suppressed messages are reported within a few hundred milliseconds
+ * even if the call site does not log again.
+ */
+void reportSuppressedMessages(bool all)
+{
+    if (suppressingSites == 0)
+        return;
+
+    const qint64 second = QTime::currentTime().msecsSinceStartOfDay() / 1000;
+    for (auto &counter : rateCounters) {
+        if (counter.suppressed > 0 && (all || counter.second != second))
+            reportSuppressed(counter);
+    }
+}
+
+/*!
+ * \brief Returns false if the call site of the record has exceeded the rate limit in the current second
+ */
+bool withinRateLimit(const Record &record)
+{
+    const int limit = rateLimit.load(std::memory_order_relaxed);
+    if (limit <= 0)
+        return true;
+
+    // Without a message log context (release builds), messages are grouped by their text
+    using Site = QPair<const void *, int>;
+    const Site site = record.file ? Site(record.file, record.line)
+                                  : Site(nullptr, int(qHash(record.message)));
+    if (rateCounters.size() > bufferSize) {
+        reportSuppressedMessages(true);
+        rateCounters.clear();
+    }
+    RateCounter &counter = rateCounters[site];
+    const qint64 second = record.msecsSinceStartOfDay / 1000;
+    if (counter.second != second) {
+        if (counter.suppressed > 0)
+            reportSuppressed(counter);
+        counter = {second, 0, 0};
+    }
+    if (++counter.count <= limit)
+        return true;
+    if (counter.suppressed++ == 0)
+        suppressingSites++;
+    return false;
+}
+
+void writeRecord(const Record &record)
+{
+    if (record.type != QtFatalMsg && !withinRateLimit(record))
+        return;
+
+    const QString time = QTime::fromMSecsSinceStartOfDay(record.msecsSinceStartOfDay).toString(Qt::ISODate);
+    const char *function = record.function ? record.function : "";
+    const QString &msg = record.message;
+
+    switch (record.type) {
+        case QtDebugMsg:
+            consoleStream << DEB_HEADER_CONSOLE << msg << "\n" << D_SPACER << function << "\033[m\n";
+            if(logDebug)
+                logStream << time << DEB_HEADER << msg << D_SPACER << function << "\n";
+            break;
+        case QtInfoMsg:
+            logStream << time << INFO_HEADER << msg << SPACER << function << "\n";
+            consoleStream << INFO_HEADER_CONSOLE << msg << "\n";
+            break;
+        case QtWarningMsg:
+            logStream << time << WARN_HEADER << msg << SPACER << "\n";
+            consoleStream << WARN_HEADER_CONSOLE << msg << "\n";
+            break;
+        case QtCriticalMsg:
+            logStream << time << CRIT_HEADER << msg << SPACER << "\n";
+            consoleStream << CRIT_HEADER_CONSOLE << msg << "\n";
+            break;
+    default:
+            logStream << time << INFO_HEADER << msg << function << "\n";
+            consoleStream << INFO_HEADER_CONSOLE << msg << "\n";
+            break;
+    }
+}
+
+/*!
+ * \brief Writes all records in the buffer and flushes the streams once at the end of the batch.
+ * Rotates the log file if it has grown beyond sizeOfLogs.
+ */
+void writeBatch(bool final = false)
+{
+    const quint64 drops = dropped.load(std::memory_order_relaxed);
+    if (drops != reportedDrops) {
+        logStream << timeNow() << WARN_HEADER << (drops - reportedDrops)
+                  << " messages dropped, the log buffer was full" << SPACER << "\n";
+        reportedDrops = drops;
+    }
+
+    Record record;
+    quint64 count = 0;
+    while (buffer->pop(record)) {
+        writeRecord(record);
+        count++;
+    }
+    reportSuppressedMessages(final);
+
+    logStream.flush();
+    consoleStream.flush();
+    written.fetch_add(count, std::memory_order_release);
+
+    logFileSize = logFile.pos();
+    if (logFileSize > sizeOfLogs) {
+        deleteOldLogs();
+        setLogFileName();
+        openLogFile();
+    }
+}
+
+void writerLoop()
+{
+    while (!stopRequested.load(std::memory_order_acquire)) {
+        writeBatch();
+
+        // Announce that the writer is about to sleep, producers only wake it up if it is waiting.
+        // Wake up periodically regardless to report dropped messages.
+        writerWaiting.store(true, std::memory_order_seq_cst);
+        if (written.load(std::memory_order_acquire) >= pushed.load(std::memory_order_seq_cst))
+            wakeUp.tryAcquire(1, 250);
+        writerWaiting.store(false, std::memory_order_relaxed);
+        wakeUp.tryAcquire(wakeUp.available());
+    }
+    writeBatch(true);
+}
+
+void wakeWriter()
+{
+    if (writerWaiting.exchange(false, std::memory_order_seq_cst))
+        wakeUp.release();
+}
+
+} // namespace
+
 /*!
  * \brief setLogFileName sets a log file name ("Log_<Date>_<Time>.txt")
  */
@@ -55,8 +358,8 @@ void deleteOldLogs()
 }
 
 /*!
- * \brief initialise logging, clean up logfiles and install a QMessageHandler. To enable
- * logging of debug messages, pass parameter as true.
+ * \brief initialise logging, clean up logfiles, start the writer thread and install a QMessageHandler.
+ * To enable logging of debug messages, pass parameter as true.
  */
 bool init(bool log_debug)
 {
@@ -65,72 +368,124 @@ bool init(bool log_debug)
     deleteOldLogs();
     setLogFileName();
 
-    QFile log_file((logFileName));
-    if(log_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
-        qInstallMessageHandler(aMessageHandler);
-        return true;
-    } else {
+    openLogFile();
+    if (!logFile.isOpen())
         return false;
+
+    if (buffer == nullptr)
+        buffer = new RingBuffer;
+    stopRequested = false;
+    QThread *thread = QThread::create(writerLoop);
+    thread->setObjectName(QStringLiteral("LogWriter"));
+    thread->start(QThread::LowPriority);
+    writerThread.store(thread, std::memory_order_release);
+
+    qInstallMessageHandler(aMessageHandler);
+    qAddPostRoutine(shutdown);
+
+    OPL::Metrics::setGauge(QStringLiteral("log/backlog"), [] { return double(pendingMessages()); });
+    OPL::Metrics::setGauge(QStringLiteral("log/dropped"), [] { return double(droppedMessages()); });
+    return true;
+}
+
+void shutdown()
+{
+    // shutdown() may be called concurrently by the post routine and a fatal message
+    QMutexLocker locker(&shutdownMutex);
+    QThread *thread = writerThread.load(std::memory_order_acquire);
+    if (thread == nullptr)
+        return;
+
+    stopRequested.store(true, std::memory_order_release);
+    wakeUp.release();
+    thread->wait();
+    writerThread.store(nullptr, std::memory_order_release);
+    delete thread;
+}
+
+void flush()
+{
+    // the writer thread can not wait for itself
+    QThread *thread = writerThread.load(std::memory_order_acquire);
+    if (thread == nullptr || thread == QThread::currentThread())
+        return;
+
+    const quint64 target = pushed.load(std::memory_order_acquire);
+    while (written.load(std::memory_order_acquire) < target && thread->isRunning()) {
+        wakeUp.release();
+        QThread::usleep(100);
+    }
+}
+
+void setCategoryLevel(const QString &category, QtMsgType minimum_level)
+{
+    {
+        QWriteLocker locker(&levelLock);
+        categoryLevels.insert(category, severity(minimum_level));
     }
+
+    // installing the filter re-applies it to all existing categories
+    const auto previous = QLoggingCategory::installFilter(categoryFilter);
+    if (previous != categoryFilter)
+        defaultFilter = previous;
+}
+
+void setRateLimit(int messages_per_second)
+{
+    rateLimit.store(messages_per_second, std::memory_order_relaxed);
 }
 
-// Maintain compatibility with older Qt versions using QTextStream::flush() but avoiding deprecation
-// warning with newer versions using Qt::endl
-#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
-#define end_line Qt::endl
-#else
-#define end_line '\n' << flush
-#endif
+quint64 droppedMessages()
+{
+    return dropped.load(std::memory_order_relaxed);
+}
+
+quint64 pendingMessages()
+{
+    const quint64 logged = pushed.load(std::memory_order_relaxed);
+    const quint64 done = written.load(std::memory_order_relaxed);
+    return logged > done ? logged - done : 0;
+}
 
 /*!
  * \brief aMessageHandler Intercepts Messages and prints to console and log file
  *
  * \details The message handler is responsible for intercepting the output from
- * qDebug(), qInfo(), qWarning() and qCritical(), formatting them and printing them
- * to the standard console out and to a logfile using QTextStream. Debug messages are
- * not written to the log file.
+ * qDebug(), qInfo(), qWarning() and qCritical() and passing them on to the writer
+ * thread, which formats them and prints them to the standard console out and to a
+ * logfile using QTextStream. Debug messages are not written to the log file.
  *
  */
 void aMessageHandler(QtMsgType type, const QMessageLogContext &context,
                       const QString& msg)
 {
-    const char *function = context.function ? context.function : "";
-    //check file size and if needed create new log!
-    {
-        QFile outFileCheck(logFileName);
-        if (outFileCheck.size() > sizeOfLogs) {
-            deleteOldLogs();
-            setLogFileName();
-        }
+    Record record;
+    record.type = type;
+    record.message = msg;
+    record.function = context.function;
+    record.file = context.file;
+    record.line = context.line;
+    record.msecsSinceStartOfDay = QTime::currentTime().msecsSinceStartOfDay();
+
+    // Without a writer thread, the messages are written synchronously. Fatal messages stop the writer thread
+    // first, unless they are raised by the writer thread itself, which can not be joined from within.
+    QThread *thread = writerThread.load(std::memory_order_acquire);
+    if (thread == nullptr || type == QtFatalMsg) {
+        if (thread != nullptr && thread != QThread::currentThread())
+            shutdown();
+        QMutexLocker locker(&synchronousMutex);
+        writeRecord(record);
+        logStream.flush();
+        consoleStream.flush();
+        return;
     }
-    // open the log file and prepare a textstream to write to it
-    QFile log_file(logFileName);
-    log_file.open(QIODevice::WriteOnly | QIODevice::Append);
-    QTextStream log_stream(&log_file);
 
-    switch (type) {
-        case QtDebugMsg:
-            QTextStream(stdout) << DEB_HEADER_CONSOLE << msg << end_line << D_SPACER << function << "\033[m" << end_line;
-            if(logDebug)
-                log_stream << timeNow() << DEB_HEADER << msg << D_SPACER << function << end_line;
-            break;
-        case QtInfoMsg:
-            log_stream << timeNow() << INFO_HEADER << msg << SPACER << function << end_line;
-            QTextStream(stdout) << INFO_HEADER_CONSOLE << msg << end_line;
-            break;
-        case QtWarningMsg:
-            log_stream << timeNow() << WARN_HEADER << msg << SPACER << end_line;
-            QTextStream(stdout) << WARN_HEADER_CONSOLE << msg << end_line;
-            break;
-        case QtCriticalMsg:
-            log_stream << timeNow() << CRIT_HEADER << msg << SPACER << end_line;
-            QTextStream(stdout) << CRIT_HEADER_CONSOLE << msg << end_line;
-            break;
-    default:
-            log_stream << timeNow() << INFO_HEADER << msg << function << end_line;
-            QTextStream(stdout) << INFO_HEADER_CONSOLE << msg << end_line;
-            break;
+    if (buffer->push(std::move(record))) {
+        pushed.fetch_add(1, std::memory_order_seq_cst);
+        wakeWriter();
+    } else {
+        dropped.fetch_add(1, std::memory_order_relaxed);
     }
 }
 
-} // namespace ALog
+} // namespace OPL::Log
@@ -40,18 +40,29 @@
  * at the moment, up to 10 logs of up to 100kB in size are kept, older logs are
  * automatically deleted.
  *
- * Debug output is not written to the logfile.
+ * Debug output is not written to the logfile unless enabled in init().
  *
- * In order to start logging, the ALog::init() function has to be called
+ * Logging is asynchronous. The message handler only places the message in a lock-free ring buffer, a
+ * background thread keeps the log file open, formats the messages and writes them in batches. If the
+ * buffer is full, messages are dropped and the number of dropped messages is written to the log once
+ * there is room again. Fatal messages are written synchronously before the application aborts.
+ *
+ * Messages can be filtered per logging category with setCategoryLevel(). Disabled categories are filtered
+ * by Qt before the message is formatted. Call sites that log more than the rate limit per second are
+ * suppressed until the next second, see setRateLimit(). The number of suppressed messages is reported by the
+ * writer thread shortly after the second has passed, and at shutdown.
+ *
+ * In order to start logging, the Log::init() function has to be called. Log::shutdown() writes the
+ * remaining messages and stops the writer thread, it is called automatically when the application exits.
  *
  * Credits to [Andy Dunkel](https://andydunkel.net/) for his excellent blog post on Qt Log File Rotation!
  */
 namespace OPL::Log
 {
-    static QDir logFolder;
-    static QString logFileName;
     const static int numberOfLogs = 10; // max number of log files to keep
     const static int sizeOfLogs = 1024 * 100; // max log size in bytes, = 100kB
+    const static int bufferSize = 4096; // number of messages the ring buffer can hold, power of 2
+    const static int defaultRateLimit = 100; // max messages per second and call site
 
     const static auto DEB_HEADER  = QLatin1String(" [DEBG]:\t");
     const static auto INFO_HEADER = QLatin1String(" [INFO]:\t");
@@ -71,15 +82,42 @@ namespace OPL::Log
     inline static const QString timeNow(){return QTime::currentTime().toString(Qt::ISODate);}
 
     /*!
-     * \brief info - Informs the user of an important program milestone
-     * \param msg - the message to be displayed. Shall be a translatable string (tr)
-     * \abstract This function is used to inform the user about an important step the
-     * program has (successfully) completed. This is achieved by displaying a QMessageBox.
-     *
-     * This function also creates a qInfo message, which will be written to the logfile and
-     * to stdout
+     * \brief Writes all pending messages, reports all suppressed messages and stops the writer thread.
+     * Messages logged afterwards are written synchronously.
+     */
+    void shutdown();
+
+    /*!
+     * \brief Blocks until all messages logged so far have been written. Returns immediately if called
+     * from the writer thread.
+     */
+    void flush();
+
+    /*!
+     * \brief Sets the least severe message type that is logged for a logging category
+     * \details The category of DEB, LOG and TODO is "opl", the unqualified Qt macros use "default".
+     * Severity increases from QtDebugMsg over QtInfoMsg, QtWarningMsg and QtCriticalMsg to QtFatalMsg,
+     * fatal messages can not be disabled.
+     */
+    void setCategoryLevel(const QString &category, QtMsgType minimum_level);
+
+    /*!
+     * \brief Sets the maximum number of messages per second that are logged from one call site.
+     * 0 disables rate limiting.
+     */
+    void setRateLimit(int messages_per_second);
+
+    /*!
+     * \brief The number of messages that have been dropped because the ring buffer was full
      */
-} // namespace ALog
+    quint64 droppedMessages();
+
+    /*!
+     * \brief The number of messages that have been logged but not yet written
+     */
+    quint64 pendingMessages();
+
+} // namespace OPL::Log
 
 /*!
  * Representation macro for custom classes.
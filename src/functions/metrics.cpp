@@ -0,0 +1,196 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "metrics.h"
+#include <QMutex>
+#include <map>
+#include <memory>
+
+namespace OPL::Metrics {
+
+namespace {
+
+QMutex registryMutex;
+std::map<QString, std::unique_ptr<Counter>> counters;
+std::map<QString, std::unique_ptr<Histogram>> histograms;
+std::map<QString, std::function<double()>> gauges;
+
+QJsonObject histogramToJson(const Histogram &histogram)
+{
+    const qint64 count = histogram.count();
+    return {
+        {QStringLiteral("count"), count},
+        {QStringLiteral("mean"), count > 0 ? double(histogram.sum()) / count : 0.0},
+        {QStringLiteral("p50"), histogram.percentile(0.5)},
+        {QStringLiteral("p90"), histogram.percentile(0.9)},
+        {QStringLiteral("p99"), histogram.percentile(0.99)},
+        {QStringLiteral("max"), histogram.max()},
+    };
+}
+
+} // namespace
+
+int Histogram::bucketIndex(qint64 value)
+{
+    if (value < SUB_BUCKETS)
+        return int(qMax<qint64>(value, 0));
+
+    // the exponent selects the bucket, the three bits below the most significant bit the sub-bucket
+    const int exponent = 63 - qCountLeadingZeroBits(quint64(value));
+    const int sub_bucket = int(value >> (exponent - 3)) & (SUB_BUCKETS - 1);
+    return (exponent - 2) * SUB_BUCKETS + sub_bucket;
+}
+
+qint64 Histogram::bucketLowerBound(int index)
+{
+    if (index < SUB_BUCKETS)
+        return index;
+
+    const int exponent = index / SUB_BUCKETS + 2;
+    return qint64(SUB_BUCKETS + index % SUB_BUCKETS) << (exponent - 3);
+}
+
+void Histogram::record(qint64 value)
+{
+    m_buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+
+    qint64 max = m_max.load(std::memory_order_relaxed);
+    while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed));
+}
+
+qint64 Histogram::percentile(double p) const
+{
+    const qint64 count = this->count();
+    if (count == 0)
+        return 0;
+
+    const qint64 rank = qMax<qint64>(1, qCeil(p * count));
+    qint64 cumulative = 0;
+    for (int i = 0; i < BUCKETS; i++) {
+        cumulative += m_buckets[i].load(std::memory_order_relaxed);
+        if (cumulative >= rank) {
+            // report the middle of the bucket, but never more than the largest recorded value
+            const qint64 lower = bucketLowerBound(i);
+            const qint64 upper = i + 1 < BUCKETS ? bucketLowerBound(i + 1) : lower;
+            return qMin(lower + (upper - lower) / 2, max());
+        }
+    }
+    return max();
+}
+
+void Histogram::reset()
+{
+    for (auto &bucket : m_buckets)
+        bucket.store(0, std::memory_order_relaxed);
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+Counter &counter(const QString &name)
+{
+    QMutexLocker locker(&registryMutex);
+    auto &counter = counters[name];
+    if (!counter)
+        counter = std::make_unique<Counter>();
+    return *counter;
+}
+
+Histogram &histogram(const QString &name)
+{
+    QMutexLocker locker(&registryMutex);
+    auto &histogram = histograms[name];
+    if (!histogram)
+        histogram = std::make_unique<Histogram>();
+    return *histogram;
+}
+
+void setGauge(const QString &name, std::function<double()> read_value)
+{
+    QMutexLocker locker(&registryMutex);
+    gauges[name] = std::move(read_value);
+}
+
+void reset()
+{
+    QMutexLocker locker(&registryMutex);
+    for (const auto &[name, counter] : counters)
+        counter->reset();
+    for (const auto &[name, histogram] : histograms)
+        histogram->reset();
+}
+
+QJsonObject toJson()
+{
+    QJsonObject counter_values;
+    QJsonObject gauge_values;
+    QJsonObject histogram_values;
+
+    QMutexLocker locker(&registryMutex);
+    for (const auto &[name, counter] : counters)
+        counter_values.insert(name, counter->value());
+    for (const auto &[name, read_value] : gauges)
+        gauge_values.insert(name, read_value());
+    for (const auto &[name, histogram] : histograms)
+        histogram_values.insert(name, histogramToJson(*histogram));
+
+    return {
+        {QStringLiteral("timestamp"), QDateTime::currentDateTimeUtc().toString(Qt::ISODate)},
+        {QStringLiteral("counters"), counter_values},
+        {QStringLiteral("gauges"), gauge_values},
+        {QStringLiteral("histograms"), histogram_values},
+    };
+}
+
+QString report()
+{
+    constexpr int NAME_WIDTH = -40;
+    QString result;
+    QTextStream out(&result);
+
+    QMutexLocker locker(&registryMutex);
+    out << "Counters\n";
+    for (const auto &[name, counter] : counters)
+        out << QStringLiteral("  %1 %2\n").arg(name, NAME_WIDTH).arg(counter->value());
+
+    out << "\nGauges\n";
+    for (const auto &[name, read_value] : gauges)
+        out << QStringLiteral("  %1 %2\n").arg(name, NAME_WIDTH).arg(read_value(), 0, 'f', 2);
+
+    out << "\nLatencies (microseconds)\n";
+    for (const auto &[name, histogram] : histograms)
+        out << QStringLiteral("  %1 count %2  p50 %3  p90 %4  p99 %5  max %6\n")
+               .arg(name, NAME_WIDTH)
+               .arg(histogram->count())
+               .arg(histogram->percentile(0.5))
+               .arg(histogram->percentile(0.9))
+               .arg(histogram->percentile(0.99))
+               .arg(histogram->max());
+    return result;
+}
+
+bool writeJson(const QString &file_path)
+{
+    QFile file(file_path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    return file.write(QJsonDocument(toJson()).toJson()) != -1;
+}
+
+} // namespace OPL::Metrics
@@ -0,0 +1,146 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef METRICS_H
+#define METRICS_H
+#include <QtCore>
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+/*!
+ * \brief The OPL::Metrics namespace provides a registry of named runtime metrics.
+ *
+ * \details There are three kinds of metrics:
+ * <ul>
+ * <li> Counters count events, for example the number of queries on a table </li>
+ * <li> Gauges report a value that is read when the metrics are reported, for example the log backlog </li>
+ * <li> Histograms record latencies in microseconds and report their percentiles </li>
+ * </ul>
+ *
+ * Metrics are created on first use and live until the application exits. Looking up a metric by name takes
+ * a lock, so call sites on hot paths should keep a reference, e.g. in a function-local static. Updating a
+ * counter or histogram is lock-free.
+ *
+ * Names are hierarchical, separated by '/', e.g. "database/queries/flights".
+ */
+namespace OPL::Metrics {
+
+class Counter
+{
+public:
+    void add(qint64 amount = 1) { m_value.fetch_add(amount, std::memory_order_relaxed); }
+    qint64 value() const { return m_value.load(std::memory_order_relaxed); }
+    void reset() { m_value.store(0, std::memory_order_relaxed); }
+private:
+    std::atomic<qint64> m_value = 0;
+};
+
+/*!
+ * \brief The Histogram class records values in logarithmic buckets with eight linear sub-buckets each,
+ * so percentiles are accurate to within 12.5 percent.
+ */
+class Histogram
+{
+public:
+    void record(qint64 value);
+    qint64 count() const { return m_count.load(std::memory_order_relaxed); }
+    qint64 sum() const { return m_sum.load(std::memory_order_relaxed); }
+    qint64 max() const { return m_max.load(std::memory_order_relaxed); }
+    /*!
+     * \brief Returns the approximate value below which the fraction p (0 to 1) of the recorded values lie
+     */
+    qint64 percentile(double p) const;
+    void reset();
+private:
+    static constexpr int SUB_BUCKETS = 8;
+    static constexpr int BUCKETS = 62 * SUB_BUCKETS;
+
+    static int bucketIndex(qint64 value);
+    static qint64 bucketLowerBound(int index);
+
+    std::atomic<qint64> m_buckets[BUCKETS] = {};
+    std::atomic<qint64> m_count = 0;
+    std::atomic<qint64> m_sum = 0;
+    std::atomic<qint64> m_max = 0;
+};
+
+/*!
+ * \brief The LatencyScope class records its lifetime in microseconds in a histogram
+ */
+class LatencyScope
+{
+public:
+    explicit LatencyScope(Histogram &histogram)
+        : m_histogram(histogram), m_start(std::chrono::steady_clock::now())
+    {}
+
+    ~LatencyScope()
+    {
+        m_histogram.record(std::chrono::duration_cast<std::chrono::microseconds>(
+                               std::chrono::steady_clock::now() - m_start).count());
+    }
+
+    Q_DISABLE_COPY_MOVE(LatencyScope)
+
+private:
+    Histogram &m_histogram;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+/*!
+ * \brief Returns the counter registered under name, creating it if necessary
+ */
+Counter &counter(const QString &name);
+
+/*!
+ * \brief Returns the histogram registered under name, creating it if necessary
+ */
+Histogram &histogram(const QString &name);
+
+/*!
+ * \brief Registers a gauge. The function is called from the thread that creates a report
+ * and must not access the metrics registry.
+ */
+void setGauge(const QString &name, std::function<double()> read_value);
+
+/*!
+ * \brief Resets all counters and histograms to zero
+ */
+void reset();
+
+/*!
+ * \brief Returns a snapshot of all metrics as a JSON object
+ * \details Counters and gauges are reported as numbers, histograms as objects containing
+ * the count, mean, p50, p90, p99 and max in microseconds.
+ */
+QJsonObject toJson();
+
+/*!
+ * \brief Returns a snapshot of all metrics as a human readable table
+ */
+QString report();
+
+/*!
+ * \brief Writes a snapshot of all metrics as JSON to file_path
+ * \return false if the file could not be written
+ */
+bool writeJson(const QString &file_path);
+
+} // namespace OPL::Metrics
+
+#endif // METRICS_H
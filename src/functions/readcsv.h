@@ -19,6 +19,8 @@
 #define READCSV_H
 
 #include<QtCore>
+#include "src/functions/csvreader.h"
+#include "src/functions/csvwriter.h"
 
 namespace CSV {
 
@@ -29,26 +31,23 @@ namespace CSV {
  */
 static inline QVector<QStringList> readCSVasColumns(const QString &filename)
 {
-    QFile csvfile(filename);
-    csvfile.open(QIODevice::ReadOnly);
-    QTextStream stream(&csvfile);
+    Reader reader(filename);
+    if (!reader.open())
+        return {};
 
     QVector<QStringList> values;
+    Reader::Row row;
 
     //Read CSV headers and create QStringLists accordingly
-    QString line = stream.readLine();
-    auto items = line.split(",");
-    for (int i = 0; i < items.length(); i++) {
-        QStringList list;
-        list.append(items[i]);
-        values.append(list);
-    }
+    if (!reader.readRow(row))
+        return values;
+    for (qsizetype i = 0; i < row.size(); i++)
+        values.append(QStringList{row.toString(i)});
+
     //Fill QStringLists with data
-    while (!stream.atEnd()) {
-        QString line = stream.readLine();
-        auto items = line.split(",");
-        for (int i = 0; i < values.length(); i++) {
-            values[i].append(items[i]);
+    while (reader.readRow(row)) {
+        for (qsizetype i = 0; i < values.length(); i++) {
+            values[i].append(row.toString(i));
         }
     }
     return values;
@@ -58,20 +57,19 @@ static inline QVector<QStringList> readCSVasColumns(const QString &filename)
  * \brief readCsvAsRows reads from CSV
  * \param file_name input file path
  * \return QVector<QStringList> of the CSV data, where each QStringList is one row of the input file
+ * \details Loads the whole file into memory. Use a CSV::Reader to process large files row by row.
  */
 static inline QVector<QStringList> readCsvAsRows(const QString &file_name)
 {
-    QFile csvfile(file_name);
-    csvfile.open(QIODevice::ReadOnly);
-    QTextStream stream(&csvfile);
-
     QVector<QStringList> csv_rows;
+    Reader reader(file_name);
+    if (!reader.open())
+        return csv_rows;
 
-    // Read each line
-    while (!stream.atEnd()) {
-        const QString line = stream.readLine();
-        csv_rows.append(line.split(','));
-    }
+    reader.forEachRow([&csv_rows](const Reader::Row &row) {
+        csv_rows.append(row.toStringList());
+        return true;
+    });
     return csv_rows;
 }
 
@@ -79,23 +77,22 @@ static inline QVector<QStringList> readCsvAsRows(const QString &file_name)
  * \brief writeCsv write to a CSV file
  * \param output file Path
  * \param rows
- * \return
+ * \return true if the file has been written successfully
+ * \details Fields are quoted as required. Use a CSV::Writer to write large amounts of data row by row.
  */
 static inline bool writeCsv(const QString &fileName, const QVector<QVector<QString>> &rows)
 {
-    QFile csvFile(fileName);
-    if(!csvFile.open(QIODevice::ReadWrite | QFile::Text))
+    Writer writer(fileName);
+    if(!writer.open())
         return false;
-    QTextStream stream(&csvFile);
 
     // write each line
     for(const auto &line : rows) {
-        for(int i = 0; i < line.size() - 1; i++) {
-            stream << line[i] + QLatin1Char(',');
-        }
-        stream << line.last() + QStringLiteral("\n");
+        for(const auto &field : line)
+            writer.writeField(field);
+        writer.endRow();
     }
-    return true;
+    return writer.close();
 }
 
 } // namespace CSV
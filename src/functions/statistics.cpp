@@ -17,6 +17,9 @@
  */
 #include "statistics.h"
 #include "src/database/database.h"
+#include "src/database/flightstore.h"
+#include "src/database/databasecache.h"
+#include "src/database/routemetricscache.h"
 
 /*!
  * \brief OPL::Statistics::totalTime Looks up Total Blocktime in the flights database
@@ -56,6 +59,13 @@ int OPL::Statistics::totalTime(TimeFrame time_frame)
         break;
     }
 
+    const auto store = FlightStore::instance();
+    if (store->isEnabled()) {
+        if (time_frame == TimeFrame::AllTime)
+            return store->sum(Schema::Flights::TBLK);
+        return store->sum(Schema::Flights::TBLK, start.toJulianDay());
+    }
+
     auto db_return = DB->customQuery(statement, 1);
 
     if (!db_return.isEmpty())
@@ -72,6 +82,12 @@ int OPL::Statistics::totalTime(TimeFrame time_frame)
  */
 QVector<QVariant> OPL::Statistics::countTakeOffLanding(int days)
 {
+    const auto store = FlightStore::instance();
+    if (store->isEnabled()) {
+        const auto take_offs_landings = store->takeOffsAndLandings(QDate::currentDate().toJulianDay() - days);
+        return {take_offs_landings.first, take_offs_landings.second};
+    }
+
     QString startDate = QString::number(QDate::fromJulianDay(QDate::currentDate().toJulianDay() - days).toJulianDay());
 
     // QString startdate = start.toString(Qt::ISODate);
@@ -96,6 +112,37 @@ QVector<QVariant> OPL::Statistics::countTakeOffLanding(int days)
 
 QVector<QPair<QString, QString>> OPL::Statistics::totals()
 {
+    const auto store = FlightStore::instance();
+    if (store->isEnabled()) {
+        using Flights = Schema::Flights;
+        const auto hours_minutes = [store](Flights::Column column) {
+            const qint64 minutes = store->sum(column);
+            return QStringLiteral("%1:%2").arg(minutes / 60, 2, 10, QLatin1Char('0'))
+                                           .arg(minutes % 60, 2, 10, QLatin1Char('0'));
+        };
+        const auto count = [store](Flights::Column column) {
+            return QString::number(store->sum(column));
+        };
+        return {
+            {QStringLiteral("total"),      hours_minutes(Flights::TBLK)},
+            {QStringLiteral("spse"),       hours_minutes(Flights::TSPSE)},
+            {QStringLiteral("spme"),       hours_minutes(Flights::TSPME)},
+            {QStringLiteral("night"),      hours_minutes(Flights::TNIGHT)},
+            {QStringLiteral("ifr"),        hours_minutes(Flights::TIFR)},
+            {QStringLiteral("pic"),        hours_minutes(Flights::TPIC)},
+            {QStringLiteral("picus"),      hours_minutes(Flights::TPICUS)},
+            {QStringLiteral("sic"),        hours_minutes(Flights::TSIC)},
+            {QStringLiteral("dual"),       hours_minutes(Flights::TDUAL)},
+            {QStringLiteral("fi"),         hours_minutes(Flights::TFI)},
+            {QStringLiteral("sim"),        hours_minutes(Flights::TSIM)},
+            {QStringLiteral("multipilot"), hours_minutes(Flights::TMP)},
+            {QStringLiteral("today"),      count(Flights::TODAY)},
+            {QStringLiteral("tonight"),    count(Flights::TONIGHT)},
+            {QStringLiteral("ldgday"),     count(Flights::LDGDAY)},
+            {QStringLiteral("ldgnight"),   count(Flights::LDGNIGHT)},
+        };
+    }
+
     QString statement = QStringLiteral("SELECT "
             "printf('%02d',CAST(SUM(tblk) AS INT)/60)||':'||printf('%02d',CAST(SUM(tblk) AS INT)%60) AS 'TOTAL', "
             "printf('%02d',CAST(SUM(tSPSE) AS INT)/60)||':'||printf('%02d',CAST(SUM(tSPSE) AS INT)%60) AS 'SP SE', "
@@ -141,6 +188,10 @@ QVector<QPair<QString, QString>> OPL::Statistics::totals()
  */
 QDate OPL::Statistics::currencyTakeOffLandingExpiry(int expiration_days)
 {
+    const auto store = FlightStore::instance();
+    if (store->isEnabled())
+        return store->takeOffLandingExpiry(expiration_days);
+
     int number_of_days = 0;
     QVector<QVariant> takeoff_landings;
 
@@ -167,3 +218,94 @@ QDate OPL::Statistics::currencyTakeOffLandingExpiry(int expiration_days)
     return expiration_date.addDays(expiration_days);;
 }
 
+namespace {
+
+/*!
+ * \brief Calls function(dept, dest, metrics, doft, acft, count) for the flights in the logbook in chronological
+ * order. count flights on the same date with the same aircraft and city pair may be grouped into a single call.
+ * \details The metrics are looked up in the RouteMetricsCache, so that no great circle formulas have to be
+ * evaluated per flight. Flights between unknown airports have invalid metrics.
+ */
+template<typename Function>
+void forEachSector(Function function)
+{
+    const auto cache = OPL::RouteMetricsCache::instance();
+    const auto store = OPL::FlightStore::instance();
+    if (store->isEnabled()) {
+        using Flights = OPL::Schema::Flights;
+        const auto &dept = store->column(Flights::DEPT);
+        const auto &dest = store->column(Flights::DEST);
+        const auto &doft = store->column(Flights::DOFT);
+        const auto &acft = store->column(Flights::ACFT);
+        const auto &airports = store->airportDictionary();
+
+        // look up every city pair only once
+        QHash<quint64, OPL::RouteMetrics> routes;
+        for (qsizetype i = 0; i < doft.size(); i++) {
+            const quint64 key = (quint64(quint32(dept[i])) << 32) | quint32(dest[i]);
+            auto route = routes.find(key);
+            if (route == routes.end())
+                route = routes.insert(key, cache->metrics(airports.at(dept[i]), airports.at(dest[i])));
+            function(airports.at(dept[i]), airports.at(dest[i]), *route, doft[i], acft[i], 1);
+        }
+        return;
+    }
+
+    QSqlQuery query(QStringLiteral("SELECT dept, dest, doft, acft, COUNT(*) FROM flights "
+                                   "GROUP BY dept, dest, doft, acft ORDER BY doft"));
+    while (query.next()) {
+        const QString departure = query.value(0).toString();
+        const QString destination = query.value(1).toString();
+        function(departure, destination, cache->metrics(departure, destination),
+                 query.value(2).toInt(), query.value(3).toInt(), query.value(4).toInt());
+    }
+}
+
+} // namespace
+
+QMap<int, double> OPL::Statistics::distancePerYear()
+{
+    QMap<int, double> distances;
+    qint32 year_doft = 0;
+    int year = 0;
+    forEachSector([&](const QString &, const QString &, const RouteMetrics &metrics, qint32 doft, int, int count) {
+        if (!metrics.isValid())
+            return;
+        if (doft != year_doft) {
+            year = QDate::fromJulianDay(doft).year();
+            year_doft = doft;
+        }
+        distances[year] += metrics.distance * count;
+    });
+    return distances;
+}
+
+QMap<QString, double> OPL::Statistics::distancePerType()
+{
+    QHash<int, double> tail_distances;
+    forEachSector([&](const QString &, const QString &, const RouteMetrics &metrics, qint32, int acft, int count) {
+        if (metrics.isValid())
+            tail_distances[acft] += metrics.distance * count;
+    });
+
+    const auto &types = DBCache->getTypesMap();
+    QMap<QString, double> distances;
+    for (auto it = tail_distances.cbegin(); it != tail_distances.cend(); ++it)
+        distances[types.value(it.key())] += it.value();
+    return distances;
+}
+
+OPL::Statistics::Sector OPL::Statistics::longestSector()
+{
+    Sector longest;
+    qint32 longest_doft = 0;
+    forEachSector([&](const QString &dept, const QString &dest, const RouteMetrics &metrics, qint32 doft, int, int) {
+        if (metrics.isValid() && metrics.distance > longest.distance) {
+            longest = {dept, dest, QDate(), metrics.distance};
+            longest_doft = doft;
+        }
+    });
+    if (longest_doft != 0)
+        longest.date = QDate::fromJulianDay(longest_doft);
+    return longest;
+}
@@ -42,6 +42,31 @@ namespace OPL::Statistics {
 
     QVector<QPair<QString, QString>> totals();
 
+    /*!
+     * \brief A flight between two airports and its great circle distance in nautical miles
+     */
+    struct Sector {
+        QString departure;
+        QString destination;
+        QDate date;
+        double distance = 0;
+    };
+
+    /*!
+     * \brief Returns the great circle distance flown in nautical miles, keyed by calendar year
+     */
+    QMap<int, double> distancePerYear();
+
+    /*!
+     * \brief Returns the great circle distance flown in nautical miles, keyed by aircraft type
+     */
+    QMap<QString, double> distancePerType();
+
+    /*!
+     * \brief Returns the flight with the longest great circle distance, the earliest one on a tie
+     */
+    Sector longestSector();
+
 } // namespace OPL::Statistics
 
 #endif // STAT_H
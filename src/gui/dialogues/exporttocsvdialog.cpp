@@ -1,11 +1,12 @@
 #include "exporttocsvdialog.h"
-#include "QtSql/qsqlfield.h"
-#include "QtSql/qsqlrecord.h"
-#include "QtSql/qsqltablemodel.h"
 #include "QtWidgets/qfiledialog.h"
+#include "QtWidgets/qprogressdialog.h"
 #include "src/opl.h"
 #include "ui_exporttocsvdialog.h"
-#include "src/functions/readcsv.h"
+#include "src/classes/paths.h"
+#include "src/classes/settings.h"
+#include "src/database/csvexporttask.h"
+#include "src/database/views/logbookviewinfo.h"
 
 ExportToCsvDialog::ExportToCsvDialog(QWidget *parent) :
     QDialog(parent),
@@ -22,7 +23,6 @@ ExportToCsvDialog::~ExportToCsvDialog()
 
 void ExportToCsvDialog::on_exportPushButton_clicked()
 {
-    selectRows();
     // File Dialog where to save
     QString filePath = QDir::toNativeSeparators(QFileDialog::getSaveFileName(this,
                                                     tr("Select Location"),
@@ -33,14 +33,7 @@ void ExportToCsvDialog::on_exportPushButton_clicked()
     if(!filePath.endsWith(QStringLiteral(".csv")))
         filePath += ".csv";
     DEB << filePath;
-    if(!selectedRows.isEmpty()) {
-        if(CSV::writeCsv(filePath, selectedRows)) {
-            INFO("Database successfully exported.");
-            QDialog::accept();
-        } else {
-            WARN("Unable to save csv file.");
-        }
-    }
+    exportSelectedView(filePath);
 }
 
 void ExportToCsvDialog::init()
@@ -50,38 +43,57 @@ void ExportToCsvDialog::init()
     ui->viewComboBox->setCurrentIndex(5);
 }
 
-void ExportToCsvDialog::selectRows()
+void ExportToCsvDialog::exportSelectedView(const QString &file_path)
 {
-    selectedRows.clear();
-    // create a QSqlTableModel based on the selected views
-    const auto model = new QSqlTableModel(this);
-    if(ui->viewComboBox->currentIndex() < 4)
-        model->setTable(OPL::GLOBALS->getViewIdentifier(OPL::LogbookView(ui->viewComboBox->currentIndex())));
-    else
-        model->setTable(exportView);
-    model->select();
+    using Format = OPL::CsvExportTask::ColumnFormat;
+    const QString database_path = OPL::Paths::databaseFileInfo().absoluteFilePath();
+    const int index = ui->viewComboBox->currentIndex();
 
-    int columns = model->record().count();
-    // check model is usable
-    if(model->rowCount() == 0 || columns == 0) {
-        WARN("Invalid Model, unable to parse CSV");
-        return;
+    // the logbook views contain raw database values which are formatted like in the logbook widget
+    std::unique_ptr<OPL::CsvExportTask> task;
+    if(index < 4) {
+        const auto view = OPL::LogbookView(index);
+        task = std::make_unique<OPL::CsvExportTask>(database_path, OPL::GLOBALS->getViewIdentifier(view), file_path);
+        task->setHeaders(OPL::LogbookViewInfo::getTableHeaders(view));
+        task->setColumnFormat(OPL::LogbookViewInfo::getDateColumn(view), Format::Date);
+        task->setColumnFormat(OPL::LogbookViewInfo::getPicColumn(view),  Format::PilotName);
+        task->setColumnFormat(OPL::LogbookViewInfo::getTypeColumn(view), Format::AircraftType);
+        for(const auto column : OPL::LogbookViewInfo::getTimeColumns(view))
+            task->setColumnFormat(column, Format::Time);
+    } else {
+        task = std::make_unique<OPL::CsvExportTask>(database_path, exportView, file_path);
+        task->setColumnFormat(1, Format::Date);
+        for(const auto column : exportTimeColumns)
+            task->setColumnFormat(column, Format::Time);
     }
-    QVector<QString> newRow;
+    task->setDateTimeFormat(Settings::getDisplayFormat());
+
+    QProgressDialog progress_dialog(tr("Exporting logbook..."), tr("Cancel"), 0, 0, this);
+    progress_dialog.setWindowModality(Qt::WindowModal);
+    progress_dialog.setMinimumDuration(500);
 
-    // extract headers
-    for(int i = 0; i < columns; i++)
-        newRow.append(model->headerData(i, Qt::Horizontal).toString());
-    selectedRows.append(newRow);
-    newRow.clear();
+    QEventLoop loop;
+    bool success = false;
+    QObject::connect(task.get(), &OPL::CsvExportTask::progress, &progress_dialog, [&progress_dialog](int done, int total) {
+        progress_dialog.setMaximum(total);
+        progress_dialog.setValue(done);
+    });
+    QObject::connect(&progress_dialog, &QProgressDialog::canceled, task.get(), &OPL::CsvExportTask::cancel,
+                     Qt::DirectConnection);
+    QObject::connect(task.get(), &OPL::CsvExportTask::finished, &loop, [&loop, &success](bool task_success) {
+        success = task_success;
+        loop.quit();
+    });
+    task->start();
+    loop.exec();
 
-    // add column data
-    for(int i = 0; i < model->rowCount(); i++) {
-        const auto record = model->record(i);
-        for(int i = 0; i < columns; i++)
-            newRow.append(record.field(i).value().toString());
-        selectedRows.append(newRow);
-        newRow.clear();
+    if(progress_dialog.wasCanceled())
+        return; // the target file remains untouched
+
+    if(success) {
+        INFO("Database successfully exported.");
+        QDialog::accept();
+    } else {
+        WARN("Unable to save csv file.");
     }
 }
-
@@ -23,15 +23,15 @@ private slots:
 
 private:
     Ui::ExportToCsvDialog *ui;
-    QVector<QVector<QString>> selectedRows;
     const static inline QString exportView = "viewExport";
+    // the columns of exportView which contain times in minutes
+    const static inline std::vector<int> exportTimeColumns = { 3, 5, 8, 9, 10, 11, 17, 18, 19, 20, 21, 22, 24 };
 
     void init();
     /*!
-     * \brief fill the selectedRows vector with data based on the selected view.
-     * The selected rows are a subset of the rows available in the database.
+     * \brief export the selected view to the given file on a worker thread while showing a progress dialog.
      */
-    void selectRows();
+    void exportSelectedView(const QString &file_path);
 };
 
 #endif // EXPORTTOCSVDIALOG_H
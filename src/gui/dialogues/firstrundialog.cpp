@@ -369,8 +369,7 @@ bool FirstRunDialog::writeCurrencies()
         // only set expiry date if user has modified it
         const QDate date = pair.second->date();
         if(date != today) {
-            int julianDay = date.toJulianDay();
-            currencyEntry.setExpiryDate(OPL::Date(julianDay, m_format));
+            currencyEntry.setExpiryDate(OPL::Date(date));
         }
 
         if(!DB->commit(currencyEntry))
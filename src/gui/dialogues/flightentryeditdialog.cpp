@@ -2,6 +2,7 @@
 #include "src/classes/date.h"
 #include "src/database/database.h"
 #include "src/database/databasecache.h"
+#include "src/database/flightpredictor.h"
 #include "src/gui/dialogues/airportentryeditdialog.h"
 #include "src/gui/dialogues/newpilotdialog.h"
 #include "src/gui/dialogues/tailentryeditdialog.h"
@@ -13,16 +14,21 @@
 #include <src/classes/settings.h>
 #include <QGridLayout>
 #include <QDialogButtonBox>
+#include "src/testing/trace.h"
 
 FlightEntryEditDialog::FlightEntryEditDialog(QWidget *parent)
     : EntryEditDialog(parent)
 {
+    TRACE_FUNCTION("gui");
     init();
 }
 
 FlightEntryEditDialog::FlightEntryEditDialog(int rowId, QWidget *parent)
     : EntryEditDialog(parent)
 {
+    TRACE_FUNCTION("gui");
+    // set before init(), so that no predictions are made for an existing flight
+    m_rowID = rowId;
     init();
 
     FlightEntryEditDialog::loadEntry(rowId);
@@ -30,8 +36,7 @@ FlightEntryEditDialog::FlightEntryEditDialog(int rowId, QWidget *parent)
 
 void FlightEntryEditDialog::loadEntry(int rowID)
 {
-    m_entryParser = OPL::FlightEntryParser(DB->getFlightEntry(rowID));
-    FlightEntryEditDialog::loadEntry(m_entryParser.getFlightEntry());
+    FlightEntryEditDialog::loadEntry(DB->getFlightEntry(rowID));
 }
 
 void FlightEntryEditDialog::loadEntry(const OPL::Row &entry)
@@ -39,15 +44,14 @@ void FlightEntryEditDialog::loadEntry(const OPL::Row &entry)
     LOG << "Loading Flight Entry" << entry.getPosition();
     DEB << entry;
     // Load the entry data into the parser
-    OPL::FlightEntry flightEntry(entry.getRowId(), entry.getData());
-    m_entryParser = OPL::FlightEntryParser(flightEntry);
+    m_entryParser = OPL::FlightEntryParser(OPL::FlightEntry(entry.getRowId(), entry.getData()));
     m_rowID = entry.getRowId();
 
     // Fill the entry data into the form
     // Date of Flight
     const QDate date = m_entryParser.getDate();
     calendarWidget->setSelectedDate(date);
-    dateLineEdit.setText(OPL::Date(date, m_displayFormat).toString());
+    dateLineEdit.setText(OPL::Date(date).toString(m_formatter));
 
     // Location
     departureLineEdit.setText(m_entryParser.getDeparture());
@@ -114,8 +118,7 @@ void FlightEntryEditDialog::init()
     // use the dateDisplayLabel as a spacer
     dateDisplayLabel.setMinimumWidth(200); // TODO make dynamic
     // set the current date
-    OPL::Date today = OPL::Date::today(m_displayFormat);
-    dateLineEdit.setText(today.toString());
+    dateLineEdit.setText(OPL::Date::today().toString(m_formatter));
     emit dateLineEdit.editingFinished();
     // set cursor to entry point
     dateLineEdit.setFocus();
@@ -327,6 +330,7 @@ void FlightEntryEditDialog::setupSignalsAndSlots()
 void FlightEntryEditDialog::readSettings()
 {
     m_displayFormat = Settings::getDisplayFormat();
+    m_formatter = OPL::DateTimeFormatter(m_displayFormat);
     pilotFunctionComboBox.setCurrentIndex(static_cast<int>(Settings::getPilotFunction()));
     approachTypeComboBox.setCurrentText(Settings::getApproachType());
     flightRulesComboBox.setCurrentIndex(Settings::getLogIfr());
@@ -487,9 +491,10 @@ void FlightEntryEditDialog::onDialogAccepted()
     if(!runSanityChecks()) {
         return;
     }
-    DEB << m_entryParser.getFlightEntry();
-    DEB << m_entryParser.getFlightEntry().getPosition();
-    if (!DB->commit(m_entryParser.getFlightEntry())) {
+    const auto flight_entry = m_entryParser.getFlightEntry();
+    DEB << flight_entry;
+    DEB << flight_entry.getPosition();
+    if (!DB->commit(flight_entry)) {
         WARN(tr("The following error has ocurred:"
                 "<br><br>%1<br><br>"
                 "The entry has not been saved."
@@ -509,7 +514,7 @@ void FlightEntryEditDialog::onCalendarRequested()
 void FlightEntryEditDialog::onCalendarDateSelected()
 {
     calendarWidget->setVisible(false);
-    dateLineEdit.setText(OPL::Date(calendarWidget->selectedDate(), m_displayFormat).toString());
+    dateLineEdit.setText(OPL::Date(calendarWidget->selectedDate()).toString(m_formatter));
 }
 
 void FlightEntryEditDialog::onPilotFlyingCheckboxStateChanged(int index)
@@ -527,12 +532,11 @@ void FlightEntryEditDialog::onDateEditingFinished()
 {
     LOG << "Date editing finished: " << dateLineEdit.text();
     // TODO - UserInput subclass for date entry, deprecate and clean up OPL::Date
-    const QDate date = QDate::fromString(dateLineEdit.text(), m_displayFormat.dateFormatString());
-
-    if(! m_entryParser.setDate(date)) {
+    if(! m_entryParser.setDate(dateLineEdit.text(), m_displayFormat)) {
         onBadInputReceived(&dateLineEdit);
     } else {
         onGoodInputReceived(&dateLineEdit);
+        updatePredictions();
     }
 }
 
@@ -543,6 +547,7 @@ void FlightEntryEditDialog::onTimeOutEditingFinished()
         onBadInputReceived(&timeOutLineEdit);
     else
         onGoodInputReceived(&timeOutLineEdit);
+    updateTimeInSuggestion();
 }
 
 void FlightEntryEditDialog::onTimeInEditingFinished()
@@ -631,12 +636,9 @@ void FlightEntryEditDialog::onRegistrationEditingFinished(QLineEdit *lineEdit)
 
 void FlightEntryEditDialog::onLocationEditingFinished(QLineEdit *lineEdit)
 {
-    if(verifyUserInput(lineEdit, AirportInput(lineEdit->text())) ) {
-        updateAirportLabels();
-        lineEdit == locationLineEdits[0] ?
-            m_entryParser.setDeparture(lineEdit->text()) :
-            m_entryParser.setDestination(lineEdit->text());
-        onGoodInputReceived(lineEdit);
+    if(verifyLocation(lineEdit)) {
+        // the route determines the remaining predictions
+        updatePredictions();
         return;
     } else {
         if(addNewDatabaseElement(lineEdit, OPL::DbTable::Airports)) {
@@ -649,6 +651,19 @@ void FlightEntryEditDialog::onLocationEditingFinished(QLineEdit *lineEdit)
     onBadInputReceived(lineEdit);
 }
 
+bool FlightEntryEditDialog::verifyLocation(QLineEdit *lineEdit)
+{
+    if (!verifyUserInput(lineEdit, AirportInput(lineEdit->text())))
+        return false;
+
+    updateAirportLabels();
+    lineEdit == locationLineEdits[0] ?
+        m_entryParser.setDeparture(lineEdit->text()) :
+        m_entryParser.setDestination(lineEdit->text());
+    onGoodInputReceived(lineEdit);
+    return true;
+}
+
 void FlightEntryEditDialog::onRemarksEditingFinished()
 {
     m_entryParser.setRemarks(remarksLineEdit.text());
@@ -659,6 +674,73 @@ void FlightEntryEditDialog::onFlightNumberEditingFinished()
     m_entryParser.setFlightNumber(flightNumberLineEdit.text());
 }
 
+void FlightEntryEditDialog::updatePredictions()
+{
+    const auto predictor = OPL::FlightPredictor::instance();
+    if (m_rowID != NEW_ENTRY || !predictor->isEnabled())
+        return;
+
+    // a location entered by the user is used for the prediction, a predicted one is re-predicted
+    auto userInput = [this](const QLineEdit &lineEdit) {
+        return lineEdit.text() == m_suggestions.value(&lineEdit) ? QString() : lineEdit.text();
+    };
+    const QDate date = m_entryParser.getDate();
+    const auto prediction = predictor->predict(date.isValid() ? date.toJulianDay() : QDate::currentDate().toJulianDay(),
+                                               departureLineEdit.text(),
+                                               userInput(destinationLineEdit));
+
+    // the flight number prefix from the settings is a default, not user input
+    if (!m_suggestions.contains(&flightNumberLineEdit))
+        m_suggestions.insert(&flightNumberLineEdit, flightNumberLineEdit.text());
+
+    suggest(&departureLineEdit, prediction.departure);
+    suggest(&destinationLineEdit, prediction.destination);
+    suggest(&registrationLineEdit, DBCache->getTailsMap().value(prediction.registrationId));
+    suggest(&firstPilotLineEdit, DBCache->getPilotNamesMap().value(prediction.firstPilotId));
+    suggest(&secondPilotLineEdit, DBCache->getPilotNamesMap().value(prediction.secondPilotId));
+    suggest(&thirdPilotLineEdit, DBCache->getPilotNamesMap().value(prediction.thirdPilotId));
+    suggest(&flightNumberLineEdit, prediction.flightNumber);
+
+    m_predictedBlockMinutes = prediction.blockMinutes;
+    updateTimeInSuggestion();
+}
+
+void FlightEntryEditDialog::suggest(QLineEdit *lineEdit, const QString &text)
+{
+    // never overwrite user input
+    if (text.isEmpty() || (!lineEdit->text().isEmpty() && lineEdit->text() != m_suggestions.value(lineEdit)))
+        return;
+    m_suggestions.insert(lineEdit, text);
+    if (lineEdit->text() == text)
+        return;
+
+    lineEdit->setText(text);
+
+    // Verify the suggestion like user input. Locations are verified directly, because their editing finished
+    // slot would predict again from the suggestion.
+    if (lineEdit == &departureLineEdit || lineEdit == &destinationLineEdit) {
+        if (!verifyLocation(lineEdit))
+            onBadInputReceived(lineEdit);
+    } else if (lineEdit == &registrationLineEdit) {
+        onRegistrationEditingFinished(lineEdit);
+    } else if (lineEdit == &flightNumberLineEdit) {
+        onFlightNumberEditingFinished();
+    } else {
+        onNameEditingFinished(lineEdit);
+    }
+}
+
+void FlightEntryEditDialog::updateTimeInSuggestion()
+{
+    // show the expected on blocks time until the actual time is entered
+    if (m_rowID != NEW_ENTRY || m_predictedBlockMinutes < 0 || timeOutLineEdit.text().isEmpty()) {
+        timeInLineEdit.setPlaceholderText(QString());
+        return;
+    }
+    const QTime timeIn = m_entryParser.getTimeOffBlocks().addSecs(m_predictedBlockMinutes * 60);
+    timeInLineEdit.setPlaceholderText(m_formatter.timeString(timeIn.msecsSinceStartOfDay() / 60000));
+}
+
 bool FlightEntryEditDialog::addNewDatabaseElement(QLineEdit *caller, const OPL::DbTable table)
 {
     // Ask the user if they want to add a new DB Element
@@ -13,6 +13,7 @@
 #include "src/opl.h"
 #include "src/gui/verification/userinput.h"
 #include "src/gui/verification/flightentryparser.h"
+#include "src/classes/datetimeformatter.h"
 
 class FlightEntryEditDialog : public EntryEditDialog
 {
@@ -33,6 +34,13 @@ private:
     static constexpr int NEW_ENTRY = 0;
     int m_rowID = NEW_ENTRY;
     OPL::DateTimeFormat m_displayFormat;
+    OPL::DateTimeFormatter m_formatter;
+    /*!
+     * \brief m_suggestions holds the predicted text of the line edits filled in by the FlightPredictor,
+     * so that predictions can be updated as long as the user has not changed them
+     */
+    QHash<const QLineEdit *, QString> m_suggestions;
+    int m_predictedBlockMinutes = -1;
 
     QLineEdit dateLineEdit = QLineEdit(this);
     QLineEdit timeOutLineEdit = QLineEdit(this);
@@ -104,6 +112,14 @@ private:
     void onBadInputReceived(QLineEdit *lineEdit);
     void onGoodInputReceived(QLineEdit *lineEdit);
     void updateAirportLabels();
+    bool verifyLocation(QLineEdit *lineEdit);
+
+    /*!
+     * \brief Fills in the predicted values for a new flight. Values entered by the user are not changed.
+     */
+    void updatePredictions();
+    void suggest(QLineEdit *lineEdit, const QString &text);
+    void updateTimeInSuggestion();
 
     /*!
      * \brief Add the data from combo and spin boxes to the flight entry
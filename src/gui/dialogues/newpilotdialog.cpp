@@ -21,6 +21,7 @@
 #include "src/opl.h"
 
 #include "src/database/database.h"
+#include "src/testing/trace.h"
 
 /*!
  * \brief NewPilotDialog::NewPilotDialog - creates a new pilot dialog which can be used to add a new entry to the database
@@ -29,6 +30,7 @@ NewPilotDialog::NewPilotDialog(QString userInput, QWidget* parent)
     : EntryEditDialog{parent},
     ui(new Ui::NewPilot)
 {
+    TRACE_FUNCTION("gui");
     setup();
     if(userInput != QString()) {
         ui->lastnameLineEdit->setText(userInput.replace(0, 1, userInput.first(1).toUpper()));
@@ -44,6 +46,7 @@ NewPilotDialog::NewPilotDialog(int rowId, QWidget *parent) :
     EntryEditDialog{rowId, parent},
     ui(new Ui::NewPilot)
 {
+    TRACE_FUNCTION("gui");
     setup();
 
     pilotEntry = DB->getPilotEntry(rowId);
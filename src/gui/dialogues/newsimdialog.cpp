@@ -17,7 +17,7 @@ NewSimDialog::NewSimDialog(QWidget *parent)
     ui->setupUi(this);
     init();
 
-    ui->dateLineEdit->setText(OPL::Date::today(m_format).toString());
+    ui->dateLineEdit->setText(OPL::Date::today().toString(m_formatter));
 }
 /*!
  * \brief create a NewSimDialog to edit an existing Simulator Entry
@@ -49,6 +49,7 @@ void NewSimDialog::init()
     ui->aircraftTypeLineEdit->setCompleter(completer);
 
     m_format = Settings::getDisplayFormat();
+    m_formatter = OPL::DateTimeFormatter(m_format);
 }
 
 /*!
@@ -57,8 +58,8 @@ void NewSimDialog::init()
 void NewSimDialog::fillEntryData()
 {
     const auto& data = entry.getData();
-    ui->dateLineEdit->setText(OPL::Date(data.value(OPL::SimulatorEntry::DATE).toInt(), m_format).toString());
-    ui->totalTimeLineEdit->setText(OPL::Time(data.value(OPL::SimulatorEntry::TIME).toInt(), m_format).toString());
+    ui->dateLineEdit->setText(m_formatter.dateString(data.value(OPL::SimulatorEntry::DATE).toInt()));
+    ui->totalTimeLineEdit->setText(m_formatter.timeString(data.value(OPL::SimulatorEntry::TIME).toInt()));
     ui->deviceTypeComboBox->setCurrentIndex(data.value(OPL::SimulatorEntry::TYPE).toInt());
     ui->aircraftTypeLineEdit->setText(data.value(OPL::SimulatorEntry::ACFT).toString());
     ui->registrationLineEdit->setText(data.value(OPL::SimulatorEntry::REG).toString());
@@ -72,9 +73,9 @@ NewSimDialog::~NewSimDialog()
 
 void NewSimDialog::on_dateLineEdit_editingFinished()
 {
-    const auto date = OPL::Date(ui->dateLineEdit->text(), m_format);
+    const auto date = OPL::Date::fromString(ui->dateLineEdit->text(), m_format);
     if(date.isValid()) {
-        ui->dateLineEdit->setText(date.toString());
+        ui->dateLineEdit->setText(date.toString(m_formatter));
         ui->dateLineEdit->setStyleSheet(QString());
         return;
     } else {
@@ -121,7 +122,7 @@ void NewSimDialog::on_helpPushButton_clicked()
 bool NewSimDialog::verifyInput(QString& error_msg)
 {
     // Date
-    const auto date = OPL::Date(ui->dateLineEdit->text(), m_format);
+    const auto date = OPL::Date::fromString(ui->dateLineEdit->text(), m_format);
 
     if (!date.isValid()) {
         ui->dateLineEdit->setStyleSheet(OPL::CssStyles::RED_BORDER);
@@ -156,7 +157,7 @@ OPL::RowData_T NewSimDialog::collectInput()
 {
     OPL::RowData_T new_entry;
     // Date
-    const auto date = OPL::Date(ui->dateLineEdit->text(), m_format);
+    const auto date = OPL::Date::fromString(ui->dateLineEdit->text(), m_format);
     new_entry.insert(OPL::SimulatorEntry::DATE, date.toJulianDay());
     // Time
     new_entry.insert(OPL::SimulatorEntry::TIME, OPL::Time::fromString(ui->totalTimeLineEdit->text(), m_format).toMinutes());
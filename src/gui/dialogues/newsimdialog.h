@@ -49,6 +49,7 @@ private:
         OPL::DateTimeFormat::TimeFormat::Default,
         QStringLiteral("hh:mm")
         );
+    OPL::DateTimeFormatter m_formatter = OPL::DateTimeFormatter(m_format);
 
     void init();
     void fillEntryData();
@@ -19,10 +19,12 @@
 #include "src/database/database.h"
 #include "src/database/databasecache.h"
 #include "src/opl.h"
+#include "src/testing/trace.h"
 
 TailEntryEditDialog::TailEntryEditDialog(const QString &new_registration, QWidget *parent) :
     EntryEditDialog(parent)
 {
+    TRACE_FUNCTION("gui");
     LOG << "Editing New Tail Entry: " << new_registration;
     init();
     setupCompleter();
@@ -38,6 +40,7 @@ TailEntryEditDialog::TailEntryEditDialog(const QString &new_registration, QWidge
 TailEntryEditDialog::TailEntryEditDialog(int row_id, QWidget *parent) :
     EntryEditDialog(parent), m_rowId(row_id)
 {
+    TRACE_FUNCTION("gui");
     init();
 
     searchLabel.hide();
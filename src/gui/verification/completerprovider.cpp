@@ -1,17 +1,40 @@
 #include "completerprovider.h"
+#include "src/database/database.h"
 #include "src/database/databasecache.h"
+#include <QSqlQuery>
+
+/*!
+ * \brief Runs statement, which selects a key and a count, and sums up the counts for every key
+ */
+static QHash<QString, int> sumCounts(const QSqlDatabase &database, const QString &statement)
+{
+    QHash<QString, int> counts;
+    QSqlQuery query(database);
+    query.setForwardOnly(true);
+    query.prepare(statement);
+    query.exec();
+    while (query.next())
+        counts[query.value(0).toString()] += query.value(1).toInt();
+    counts.remove(QString());
+    return counts;
+}
 
 //namespace OPL {
 
 CompleterProvider::CompleterProvider()
 {
-    pilotCompleter    = new QCompleter(DBCache->getPilotNamesList());
-    tailsCompleter    = new QCompleter(DBCache->getTailsList());
-    airportCompleter  = new QCompleter(DBCache->getAirportList());
-    companyCompleter  = new QCompleter(DBCache->getCompaniesList());
-    aircraftCompleter = new QCompleter(DBCache->getAircraftList());
+    pilotCompleter    = new IndexedCompleter(DBCache->getPilotNamesList());
+    tailsCompleter    = new IndexedCompleter(DBCache->getTailsList());
+    airportCompleter  = new IndexedCompleter(DBCache->getAirportList());
+    companyCompleter  = new IndexedCompleter(DBCache->getCompaniesList());
+    aircraftCompleter = new IndexedCompleter(DBCache->getAircraftList());
 
-    QList<QCompleter*> completers = {
+    pilotCompleter->indexModel()->setScoreFunction(&CompleterProvider::fetchPilotUsage);
+    tailsCompleter->indexModel()->setScoreFunction(&CompleterProvider::fetchTailUsage);
+    airportCompleter->indexModel()->setScoreFunction(&CompleterProvider::fetchAirportUsage);
+    companyCompleter->indexModel()->setScoreFunction(&CompleterProvider::fetchCompanyUsage);
+
+    QList<IndexedCompleter*> completers = {
         pilotCompleter,
         tailsCompleter,
         airportCompleter,
@@ -20,13 +43,17 @@ CompleterProvider::CompleterProvider()
     };
     for (const auto completer : completers) {
         completer->setCaseSensitivity(Qt::CaseInsensitive);
-        completer->setCompletionMode(QCompleter::PopupCompletion);
-        completer->setFilterMode(Qt::MatchContains);
+        completer->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+        // the scores are read in the background
+        completer->indexModel()->refreshScores();
     }
 
     // Listen for changes in Database Cache
     QObject::connect(DBCache,    	&OPL::DatabaseCache::databaseCacheUpdated,
                      this,			&CompleterProvider::onDatabaseCacheUpdated);
+    // Listen for new flights, which change the ranking
+    QObject::connect(DB,			&OPL::Database::dataBaseUpdated,
+                     this,			&CompleterProvider::onDatabaseUpdated);
 }
 
 CompleterProvider::~CompleterProvider()
@@ -34,6 +61,8 @@ CompleterProvider::~CompleterProvider()
     pilotCompleter->deleteLater();
     tailsCompleter->deleteLater();
     airportCompleter->deleteLater();
+    companyCompleter->deleteLater();
+    aircraftCompleter->deleteLater();
 }
 
 
@@ -59,12 +88,21 @@ QCompleter *CompleterProvider::getCompleter(CompleterTarget target) const
     }
 }
 
+QString CompleterProvider::bestMatch(CompleterTarget target, const QString &input) const
+{
+    const auto completer = static_cast<IndexedCompleter*>(getCompleter(target));
+    if (completer == nullptr)
+        return QString();
+    return completer->indexModel()->bestMatch(input);
+}
+
 void CompleterProvider::onDatabaseCacheUpdated(const OPL::DbTable table)
 {
     switch (table) {
     case OPL::DbTable::Pilots:
         DEB << "Pilots completer model updated...";
         updateModel(CompleterTarget::Pilots);
+        updateModel(CompleterTarget::Companies);
         break;
     case OPL::DbTable::Tails:
         DEB << "Tails completer model updated...";
@@ -74,6 +112,27 @@ void CompleterProvider::onDatabaseCacheUpdated(const OPL::DbTable table)
         DEB << "Airports completer model updated...";
         updateModel(CompleterTarget::Airports);
         break;
+    case OPL::DbTable::Aircraft:
+        DEB << "Aircraft completer model updated...";
+        updateModel(CompleterTarget::Aircraft);
+        break;
+    default:
+        break;
+    }
+}
+
+void CompleterProvider::onDatabaseUpdated(const OPL::DbTable table)
+{
+    switch (table) {
+    case OPL::DbTable::Flights:
+    case OPL::DbTable::Any:
+        pilotCompleter->indexModel()->refreshScores();
+        tailsCompleter->indexModel()->refreshScores();
+        airportCompleter->indexModel()->refreshScores();
+        break;
+    case OPL::DbTable::Pilots:
+        companyCompleter->indexModel()->refreshScores();
+        break;
     default:
         break;
     }
@@ -82,29 +141,76 @@ void CompleterProvider::onDatabaseCacheUpdated(const OPL::DbTable table)
 void CompleterProvider::updateModel(CompleterTarget target)
 {
     const QStringList *newData = nullptr;
-    QStringListModel* model = nullptr;
+    CompletionModel* model = nullptr;
 
     switch(target) {
     case Airports:
         newData = &DBCache->getAirportList();
-        model = qobject_cast<QStringListModel*>(airportCompleter->model());
+        model = airportCompleter->indexModel();
         break;
     case Pilots:
         newData = &DBCache->getPilotNamesList();
-        model = qobject_cast<QStringListModel*>(pilotCompleter->model());
+        model = pilotCompleter->indexModel();
         break;
     case Tails: {
         newData = &DBCache->getTailsList();
-        model = qobject_cast<QStringListModel*>(tailsCompleter->model());
+        model = tailsCompleter->indexModel();
         break;
     }
+    case Companies:
+        newData = &DBCache->getCompaniesList();
+        model = companyCompleter->indexModel();
+        break;
+    case Aircraft:
+        newData = &DBCache->getAircraftList();
+        model = aircraftCompleter->indexModel();
+        break;
     default:
         break;
     }
 
     if(newData == nullptr) return;
 
-    model->setStringList(*newData);
+    model->setEntries(*newData);
+}
+
+QHash<QString, int> CompleterProvider::fetchAirportUsage(const QSqlDatabase &database)
+{
+    // IATA codes are ranked like the ICAO code of the same airport
+    return sumCounts(database, QStringLiteral(
+                         "WITH usage AS (SELECT dept AS code, COUNT(*) AS count FROM flights GROUP BY dept "
+                         "UNION ALL SELECT dest, COUNT(*) FROM flights GROUP BY dest) "
+                         "SELECT code, count FROM usage "
+                         "UNION ALL SELECT airports.iata, usage.count FROM usage "
+                         "JOIN airports ON airports.icao = usage.code WHERE airports.iata NOT NULL"));
+}
+
+QHash<QString, int> CompleterProvider::fetchPilotUsage(const QSqlDatabase &database)
+{
+    // the names are formatted like the entries of DatabaseCache::getPilotNamesList()
+    return sumCounts(database, QStringLiteral(
+                         "WITH usage AS (SELECT pic AS id, COUNT(*) AS count FROM flights GROUP BY pic "
+                         "UNION ALL SELECT secondPilot, COUNT(*) FROM flights GROUP BY secondPilot "
+                         "UNION ALL SELECT thirdPilot, COUNT(*) FROM flights GROUP BY thirdPilot) "
+                         "SELECT pilots.lastname||', '||pilots.firstname, usage.count FROM usage "
+                         "JOIN pilots ON pilots.ROWID = usage.id"));
+}
+
+QHash<QString, int> CompleterProvider::fetchTailUsage(const QSqlDatabase &database)
+{
+    // the completion entry of a registration containing a hyphen is followed by the registration without it,
+    // see DatabaseCache::getTailsList()
+    return sumCounts(database, QStringLiteral(
+                         "WITH usage AS (SELECT acft AS id, COUNT(*) AS count FROM flights GROUP BY acft) "
+                         "SELECT CASE WHEN instr(tails.registration, '-') > 0 "
+                         "THEN tails.registration||' ('||replace(tails.registration, '-', '')||')' "
+                         "ELSE tails.registration END, usage.count FROM usage "
+                         "JOIN tails ON tails.ROWID = usage.id"));
+}
+
+QHash<QString, int> CompleterProvider::fetchCompanyUsage(const QSqlDatabase &database)
+{
+    return sumCounts(database, QStringLiteral("SELECT company, COUNT(*) FROM pilots GROUP BY company"));
 }
 
 //} // namespace OPL
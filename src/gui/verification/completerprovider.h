@@ -1,6 +1,7 @@
 #ifndef VALIDATORFACTORY_H
 #define VALIDATORFACTORY_H
 #include "src/opl.h"
+#include "src/gui/verification/completionmodel.h"
 #include <QCompleter>
 
 #define QCompleterProvider CompleterProvider::getInstance()
@@ -15,17 +16,27 @@
  * a consistent user experience. The QCompleters' models are based on
  * input from the database, so whenever the database content is modified,
  * the completion model is updated via the databaseCacheUpdated Signal.
+ *
+ * The completers are IndexedCompleters, which look up completions in a
+ * CompletionIndex instead of scanning the whole list on every keystroke.
+ * Completions are ranked by how often an entry has been used in the logbook,
+ * these scores are re-read in the background after the flights have been modified.
  */
 class CompleterProvider : public QObject
 {
     Q_OBJECT
     CompleterProvider();
 
-    QCompleter* pilotCompleter;
-    QCompleter* airportCompleter;
-    QCompleter* tailsCompleter;
-    QCompleter* companyCompleter;
-    QCompleter* aircraftCompleter;
+    IndexedCompleter* pilotCompleter;
+    IndexedCompleter* airportCompleter;
+    IndexedCompleter* tailsCompleter;
+    IndexedCompleter* companyCompleter;
+    IndexedCompleter* aircraftCompleter;
+
+    static QHash<QString, int> fetchAirportUsage(const QSqlDatabase &database);
+    static QHash<QString, int> fetchPilotUsage(const QSqlDatabase &database);
+    static QHash<QString, int> fetchTailUsage(const QSqlDatabase &database);
+    static QHash<QString, int> fetchCompanyUsage(const QSqlDatabase &database);
 public:
     static CompleterProvider& getInstance() {
         static CompleterProvider instance;
@@ -47,8 +58,16 @@ public:
      * \brief return a pointer to the completer instance
      */
     QCompleter *getCompleter(CompleterTarget target) const;
+
+    /*!
+     * \brief returns the best completion for input without changing the completer's popup
+     * \details Use this function to fix up user input, it returns an empty string if there is no completion.
+     * Typos are not corrected, so that new entries which resemble an existing one are not replaced by it.
+     */
+    QString bestMatch(CompleterTarget target, const QString &input) const;
 public slots:
     void onDatabaseCacheUpdated(const OPL::DbTable table);
+    void onDatabaseUpdated(const OPL::DbTable table);
 };
 
 #endif // VALIDATORFACTORY_H
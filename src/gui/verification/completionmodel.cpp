@@ -0,0 +1,149 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "completionmodel.h"
+#include "src/functions/metrics.h"
+#include "src/opl.h"
+#include "src/classes/paths.h"
+#include <QSqlError>
+
+CompletionModel::CompletionModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+    m_threadPool.setMaxThreadCount(1);
+}
+
+CompletionModel::~CompletionModel()
+{
+    // queued results of a refresh that is still running are discarded when this object is destroyed
+    m_threadPool.clear();
+    m_threadPool.waitForDone();
+}
+
+void CompletionModel::setEntries(const QStringList &entries)
+{
+    beginResetModel();
+    m_index.build(entries, m_scores);
+    m_query.clear();
+    m_results.clear();
+    endResetModel();
+    refreshScores();
+}
+
+void CompletionModel::refreshScores()
+{
+    if (!m_scoreFunction)
+        return;
+
+    // the copy shares its data with m_index until the worker changes its scores
+    const int generation = ++m_generation;
+    const QString database_path = OPL::Paths::databaseFileInfo().absoluteFilePath();
+    m_threadPool.clear();
+    m_threadPool.start([this, generation, database_path, index = m_index, score_function = m_scoreFunction]() mutable {
+        const auto scores = readScores(score_function, database_path);
+        index.setScores(scores);
+        QMetaObject::invokeMethod(this, [this, generation, index = std::move(index), scores]() mutable {
+            if (generation != m_generation)
+                return;
+            m_index = std::move(index);
+            m_scores = scores;
+            if (!m_query.isEmpty())
+                runQuery();
+        }, Qt::QueuedConnection);
+    });
+}
+
+QHash<QString, int> CompletionModel::readScores(const ScoreFunction &score_function, const QString &database_path)
+{
+    // every thread needs its own connection
+    const QString connection_name = QStringLiteral("completion_connection_%1")
+            .arg(reinterpret_cast<quintptr>(QThread::currentThread()));
+    QHash<QString, int> scores;
+    { // scope for a temporary database connection, ensures proper cleanup when removeDatabase() is called.
+        QSqlDatabase database = QSqlDatabase::addDatabase(SQLITE_DRIVER, connection_name);
+        database.setDatabaseName(database_path);
+        database.setConnectOptions(QStringLiteral("QSQLITE_OPEN_READONLY;QSQLITE_BUSY_TIMEOUT=5000"));
+        if (database.open()) {
+            scores = score_function(database);
+            database.close();
+        } else {
+            LOG << "Unable to read the completion scores:" << database.lastError().text();
+        }
+    }
+    QSqlDatabase::removeDatabase(connection_name);
+    return scores;
+}
+
+void CompletionModel::setQuery(const QString &input, bool prefix_only)
+{
+    if (input == m_query && prefix_only == m_prefixOnly)
+        return;
+
+    m_query = input;
+    m_prefixOnly = prefix_only;
+    runQuery();
+}
+
+void CompletionModel::runQuery()
+{
+    static auto &latency = OPL::Metrics::histogram(QStringLiteral("completion/query"));
+    beginResetModel();
+    {
+        const OPL::Metrics::LatencyScope scope(latency);
+        m_results = m_index.complete(m_query);
+    }
+    if (m_prefixOnly) {
+        m_results.removeIf([this](int entry) {
+            return !m_index.entry(entry).startsWith(m_query, Qt::CaseInsensitive);
+        });
+    }
+    endResetModel();
+}
+
+QString CompletionModel::bestMatch(const QString &input)
+{
+    return m_index.bestMatch(input);
+}
+
+int CompletionModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_results.size();
+}
+
+QVariant CompletionModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_results.size())
+        return QVariant();
+    if (role == Qt::DisplayRole || role == Qt::EditRole)
+        return m_index.entry(m_results.at(index.row()));
+    return QVariant();
+}
+
+IndexedCompleter::IndexedCompleter(const QStringList &entries, QObject *parent)
+    : QCompleter(parent), m_model(new CompletionModel(this))
+{
+    m_model->setEntries(entries);
+    setModel(m_model);
+    setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+}
+
+QStringList IndexedCompleter::splitPath(const QString &path) const
+{
+    // the model contains the ranked results for path, which QCompleter must not filter again
+    m_model->setQuery(path, completionMode() == QCompleter::InlineCompletion);
+    return QStringList();
+}
@@ -0,0 +1,117 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef COMPLETIONMODEL_H
+#define COMPLETIONMODEL_H
+#include "src/classes/completionindex.h"
+#include <QAbstractListModel>
+#include <QCompleter>
+#include <QSqlDatabase>
+#include <functional>
+
+/*!
+ * \brief The CompletionModel class exposes the results of a CompletionIndex query to a QCompleter
+ *
+ * \details The model only ever contains the ranked results of the last query set with setQuery(), at most
+ * CompletionIndex::TOP_K rows. The scores used for ranking are read with the function set with setScoreFunction()
+ * whenever refreshScores() is called.
+ *
+ * Reading the scores and re-ranking the index both take a while on a large logbook, so they are done on a worker
+ * thread with a copy of the index. Queries use the previous ranking until the copy replaces the index.
+ */
+class CompletionModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    using ScoreFunction = std::function<QHash<QString, int>(const QSqlDatabase &database)>;
+
+    explicit CompletionModel(QObject *parent = nullptr);
+    ~CompletionModel();
+
+    /*!
+     * \brief Rebuilds the index from entries with the last known scores and clears the current results.
+     * The scores of the new entries are refreshed afterwards.
+     */
+    void setEntries(const QStringList &entries);
+
+    /*!
+     * \brief Sets the function used to determine how often the entries have been used
+     * \details The function is called on a worker thread with a read-only connection to the logbook, it must not
+     * access the database cache or the default connection.
+     */
+    void setScoreFunction(const ScoreFunction &score_function) { m_scoreFunction = score_function; }
+
+    /*!
+     * \brief Re-reads the scores and re-ranks the entries in the background
+     */
+    void refreshScores();
+
+    /*!
+     * \brief Replaces the rows of the model with the best completions for input
+     * \param prefix_only - only keep completions starting with input, as required for inline completion
+     */
+    void setQuery(const QString &input, bool prefix_only = false);
+
+    /*!
+     * \brief Returns the best completion for input without changing the rows of the model.
+     * No typos are tolerated, see CompletionIndex::bestMatch()
+     */
+    QString bestMatch(const QString &input);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    inline const static QString SQLITE_DRIVER = QStringLiteral("QSQLITE");
+
+    OPL::CompletionIndex m_index;
+    ScoreFunction m_scoreFunction;
+    QHash<QString, int> m_scores;
+    QString m_query;
+    bool m_prefixOnly = false;
+    QVector<int> m_results;
+
+    // score refreshes run one at a time, the result of a refresh started before the last one is discarded
+    QThreadPool m_threadPool;
+    int m_generation = 0;
+
+    void runQuery();
+    static QHash<QString, int> readScores(const ScoreFunction &score_function, const QString &database_path);
+};
+
+/*!
+ * \brief The IndexedCompleter class is a QCompleter which is backed by a CompletionModel
+ *
+ * \details QCompleter filters its model itself, which means scanning all entries on every keystroke. The
+ * IndexedCompleter instead passes the completion prefix to its CompletionModel and shows the ranked results
+ * unfiltered. Use it with QCompleter::UnfilteredPopupCompletion or QCompleter::InlineCompletion.
+ */
+class IndexedCompleter : public QCompleter
+{
+    Q_OBJECT
+public:
+    explicit IndexedCompleter(const QStringList &entries, QObject *parent = nullptr);
+
+    CompletionModel *indexModel() const { return m_model; }
+
+    QStringList splitPath(const QString &path) const override;
+
+private:
+    CompletionModel *m_model;
+};
+
+#endif // COMPLETIONMODEL_H
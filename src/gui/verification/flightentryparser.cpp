@@ -1,4 +1,5 @@
 #include "flightentryparser.h"
+#include "src/classes/date.h"
 #include "src/classes/time.h"
 #include "src/database/database.h"
 #include "src/database/databasecache.h"
@@ -40,6 +41,16 @@ bool FlightEntryParser::setDate(const QDate &date)
     return false;
 }
 
+bool FlightEntryParser::setDate(const QString &input, const DateTimeFormat &format)
+{
+    const Date date = Date::fromString(input, format);
+    if(date.isValid()) {
+        m_entryData.insert(FlightEntry::DOFT, date.toJulianDay());
+        return true;
+    }
+    return false;
+}
+
 bool FlightEntryParser::setDeparture(const QString &input)
 {
     if(DBCache->getAirportsMapICAO().key(input) != 0) {
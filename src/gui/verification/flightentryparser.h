@@ -21,12 +21,12 @@ class FlightEntryParser
 public:
     FlightEntryParser()
     {
-        m_entryData = OPL::FlightEntry().getData();
+        m_entryData = OPL::FlightEntry().takeData();
         m_rowId = NEW_ENTRY;
     }
     explicit FlightEntryParser(OPL::FlightEntry entry)
     {
-        m_entryData = entry.getData();
+        m_entryData = entry.takeData();
         m_rowId = entry.getRowId();
     }
     static int timeToMinutes(const QTime &time) { return time.hour() * 60 + time.minute(); }
@@ -42,13 +42,18 @@ public:
      * constraints in the database are valid.
      */
     bool isValid() const;
-    OPL::FlightEntry getFlightEntry() const { return OPL::FlightEntry(m_rowId, m_entryData); }
+    OPL::FlightEntry getFlightEntry() const & { return OPL::FlightEntry(m_rowId, m_entryData); }
+    /*!
+     * \brief moves the entry data out of a parser that is no longer needed
+     */
+    OPL::FlightEntry getFlightEntry() && { return OPL::FlightEntry(m_rowId, std::move(m_entryData)); }
     QStringList invalidFields() const;
     QString getFlightSummary() const;
 
 
     // Setters
     bool setDate(const QDate &date);
+    bool setDate(const QString &input, const OPL::DateTimeFormat &format);
     bool setDeparture(const QString &input);
     bool setDestination(const QString &input);
     bool setTimeOffBlocks(const QString &input, const OPL::DateTimeFormat &format);
@@ -12,7 +12,5 @@ QString PilotInput::fixup() const
     if (input.contains(self, Qt::CaseInsensitive))
         return DBCache->getPilotNamesMap().value(1);
 
-    QCompleter* completer = CompleterProvider::getInstance().getCompleter(CompleterProvider::Pilots);
-    completer->setCompletionPrefix(input);
-    return completer->currentCompletion();
+    return CompleterProvider::getInstance().bestMatch(CompleterProvider::Pilots, input);
 }
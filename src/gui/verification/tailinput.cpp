@@ -9,7 +9,5 @@ bool TailInput::isValid() const
 
 QString TailInput::fixup() const
 {
-    QCompleter *completer = QCompleterProvider.getCompleter(CompleterProvider::Tails);
-    completer->setCompletionPrefix(input);
-    return completer->currentCompletion();
+    return QCompleterProvider.bestMatch(CompleterProvider::Tails, input);
 }
@@ -48,7 +48,7 @@ const QString TimeInput::fixDefaultFormat() const
 
     OPL::Time fixedTime = OPL::Time::fromString(fixed, m_format);
     if(fixedTime.isValid()) {
-        return OPL::Time::fromString(fixed, m_format).toString();
+        return fixedTime.toString(OPL::DateTimeFormatter(m_format));
     } else {
         return QString();
     }
@@ -60,6 +60,7 @@ const QString TimeInput::fixDecimalFormat() const
 {
     // try to replace an erroneus decimal seperator
     QString fixed = input;
-    return OPL::Time::fromString(fixed.replace(QLatin1Char(','), OPL::DECIMAL_SEPERATOR), m_format).toString();
+    return OPL::Time::fromString(fixed.replace(QLatin1Char(','), OPL::DECIMAL_SEPERATOR), m_format)
+            .toString(OPL::DateTimeFormatter(m_format));
 }
 
@@ -21,6 +21,7 @@
 #include "src/database/database.h"
 #include "src/functions/datetime.h"
 #include "src/database/dbsummary.h"
+#include "src/database/backuparchive.h"
 #include "src/gui/dialogues/firstrundialog.h"
 #include "src/classes/settings.h"
 #include "src/classes/styleddatedelegate.h"
@@ -30,11 +31,15 @@
 #include <QFileIconProvider>
 #include <QMessageBox>
 #include <QFileDialog>
+#include <QProgressDialog>
+#include <QEventLoop>
+#include "src/testing/trace.h"
 
 BackupWidget::BackupWidget(QWidget *parent) :
     QWidget(parent),
     ui(new Ui::BackupWidget)
 {
+    TRACE_FUNCTION("gui");
     ui->setupUi(this);
 
     model = new QStandardItemModel(this);
@@ -46,6 +51,15 @@ BackupWidget::BackupWidget(QWidget *parent) :
     // julian day to Date Format
     const auto dateDelegate = new StyledDateDelegate(Settings::getDisplayFormat(), model);
     view->setItemDelegateForColumn(DATE_COLUMN, dateDelegate);
+    view->setModel(model);
+
+    // Summaries are created on worker threads and rows are filled in as they become available
+    summaryCache = new OPL::DbSummaryCache(OPL::Paths::filePath(OPL::Paths::Backup,
+                                                                OPL::DbSummaryCache::INDEX_FILE_NAME), this);
+    QObject::connect(summaryCache, &OPL::DbSummaryCache::summaryReady,
+                     this,         &BackupWidget::onSummaryReady);
+    QObject::connect(summaryCache, &OPL::DbSummaryCache::finished,
+                     view,         &QTableView::resizeColumnsToContents);
 
     refresh();
 }
@@ -66,37 +80,89 @@ void BackupWidget::refresh()
 {
     // First column in table, would be created by listing the files in backupdir
     QDir backup_dir = OPL::Paths::directory(OPL::Paths::Backup);
-    const QStringList entries = backup_dir.entryList(QStringList{"*.db"}, QDir::Files, QDir::Time);
-    QFileIconProvider provider;
+    const QFileInfoList entries = backup_dir.entryInfoList(QStringList{"*.db", QLatin1Char('*') + OPL::BackupArchive::FILE_EXTENSION},
+                                                           QDir::Files, QDir::Time);
 
-    // Get summary of each db file and populate lists (columns) of data
-    for (const auto &entry : entries) {
-        QMap<OPL::DbSummaryKey, QString> summary = OPL::DbSummary::databaseSummary(backup_dir.absoluteFilePath(entry));
-        model->appendRow({new QStandardItem(summary[OPL::DbSummaryKey::total_time]),
-                          new QStandardItem(summary[OPL::DbSummaryKey::total_flights]),
-                          new QStandardItem(summary[OPL::DbSummaryKey::total_tails]),
-                          new QStandardItem(summary[OPL::DbSummaryKey::total_pilots]),
-                          new QStandardItem(summary[OPL::DbSummaryKey::last_flight]),
-                          new QStandardItem(provider.icon(QFileIconProvider::File), entry),
-                         });
-    }
+    // List the files right away and fill in the summaries when they are ready
+    model->removeRows(0, model->rowCount());
+    for (const auto &entry : entries)
+        insertBackupRow(model->rowCount(), entry.fileName());
 
-    view->setModel(model);
     view->resizeColumnsToContents();
+    summaryCache->request(entries);
+}
+
+void BackupWidget::insertBackupRow(int row, const QString &file_name)
+{
+    QFileIconProvider provider;
+    model->insertRow(row, {new QStandardItem(),
+                           new QStandardItem(),
+                           new QStandardItem(),
+                           new QStandardItem(),
+                           new QStandardItem(),
+                           new QStandardItem(provider.icon(QFileIconProvider::File), file_name),
+                          });
 }
 
-const QString BackupWidget::absoluteBackupPath()
+void BackupWidget::onSummaryReady(const QString &file_path, const QMap<OPL::DbSummaryKey, QString> &summary)
 {
-    const QString backup_name = backupName();
+    const auto items = model->findItems(QFileInfo(file_path).fileName(), Qt::MatchExactly, FILE_COLUMN);
+    if (items.isEmpty())
+        return;
+
+    const int row = items.first()->row();
+    model->item(row, 0)->setText(summary[OPL::DbSummaryKey::total_time]);
+    model->item(row, 1)->setText(summary[OPL::DbSummaryKey::total_flights]);
+    model->item(row, 2)->setText(summary[OPL::DbSummaryKey::total_tails]);
+    model->item(row, 3)->setText(summary[OPL::DbSummaryKey::total_pilots]);
+    model->item(row, DATE_COLUMN)->setText(summary[OPL::DbSummaryKey::last_flight]);
+}
+
+bool BackupWidget::runBackupTask(OPL::BackupTask::Mode mode, const QString &file_path)
+{
+    QProgressDialog progress_dialog(mode == OPL::BackupTask::Mode::Backup ? tr("Creating backup...")
+                                                                          : tr("Restoring backup..."),
+                                    QString(), 0, 0, this);
+    progress_dialog.setWindowModality(Qt::WindowModal);
+    progress_dialog.setMinimumDuration(500);
+
+    // The database connection remains open while the task runs on a worker thread
+    if (mode == OPL::BackupTask::Mode::Restore)
+        DB->prepareContentsReplacement();
+    OPL::BackupTask task(mode, OPL::Paths::databaseFileInfo().absoluteFilePath(), file_path);
+    QEventLoop loop;
+    bool success = false;
+    QObject::connect(&task, &OPL::BackupTask::progress, &progress_dialog, [&progress_dialog](int done, int total) {
+        progress_dialog.setMaximum(total);
+        progress_dialog.setValue(done);
+    });
+    QObject::connect(&task, &OPL::BackupTask::finished, &loop, [&loop, &success](bool task_success) {
+        success = task_success;
+        loop.quit();
+    });
+    task.start();
+    loop.exec();
+
+    // refresh models and views after the database contents have been replaced
+    if (success && mode == OPL::BackupTask::Mode::Restore)
+        DB->contentsReplaced();
+
+    return success;
+}
+
+const QString BackupWidget::absoluteBackupPath(const QString &extension)
+{
+    const QString backup_name = backupName(extension);
     return OPL::Paths::filePath(OPL::Paths::Backup, backup_name);
 }
 
-const QString BackupWidget::backupName()
+const QString BackupWidget::backupName(const QString &extension)
 {
     auto owner = DB->getPilotEntry(1);
-    return  QStringLiteral("logbook_backup_%1_%2.db").arg(
+    return  QStringLiteral("logbook_backup_%1_%2%3").arg(
         OPL::DateTime::dateTimeToString(QDateTime::currentDateTime(), OPL::DateTimeFormat_deprecated::Backup),
-                                                  owner.getLastName()
+                                                  owner.getLastName(),
+                                                  extension
                 );
 }
 
@@ -108,10 +174,10 @@ void BackupWidget::on_tableView_clicked(const QModelIndex &index)
 
 void BackupWidget::on_createLocalPushButton_clicked()
 {
-    QString filename = absoluteBackupPath();
+    QString filename = absoluteBackupPath(OPL::BackupArchive::FILE_EXTENSION);
     DEB << filename;
 
-    if(!DB->createBackup(QDir::toNativeSeparators(filename))) {
+    if(!runBackupTask(OPL::BackupTask::Mode::Backup, QDir::toNativeSeparators(filename))) {
         WARN(tr("Could not create local file: %1").arg(filename));
         return;
     } else {
@@ -119,15 +185,8 @@ void BackupWidget::on_createLocalPushButton_clicked()
     }
 
     QFileInfo file_info(filename);
-    QFileIconProvider provider;
-    QMap<OPL::DbSummaryKey, QString> summary = OPL::DbSummary::databaseSummary(filename);
-    model->insertRow(0, {new QStandardItem(summary[OPL::DbSummaryKey::total_time]),
-                         new QStandardItem(summary[OPL::DbSummaryKey::total_flights]),
-                         new QStandardItem(summary[OPL::DbSummaryKey::total_tails]),
-                         new QStandardItem(summary[OPL::DbSummaryKey::total_pilots]),
-                         new QStandardItem(summary[OPL::DbSummaryKey::last_flight]),
-                         new QStandardItem(provider.icon(QFileIconProvider::File), file_info.fileName()),
-                     });
+    insertBackupRow(0, file_info.fileName());
+    summaryCache->request({file_info});
 }
 
 void BackupWidget::on_restoreLocalPushButton_clicked()
@@ -137,7 +196,7 @@ void BackupWidget::on_restoreLocalPushButton_clicked()
         return;
     }
 
-    const QString file_name = model->item(selectedRows.first(), 5)->data(Qt::DisplayRole).toString();
+    const QString file_name = model->item(selectedRows.first(), FILE_COLUMN)->data(Qt::DisplayRole).toString();
     const QString backup_name = OPL::Paths::filePath(OPL::Paths::Backup, file_name);
 
     QMessageBox confirm(this);
@@ -152,7 +211,7 @@ void BackupWidget::on_restoreLocalPushButton_clicked()
     if (confirm.exec() == QMessageBox::No)
         return;
 
-    if(!DB->restoreBackup(QDir::toNativeSeparators(backup_name))) {
+    if(!runBackupTask(OPL::BackupTask::Mode::Restore, QDir::toNativeSeparators(backup_name))) {
        WARN(tr("Unable to restore Backup file: %1").arg(backup_name));
     } else {
         INFO(tr("Backup successfully restored."));
@@ -169,7 +228,7 @@ void BackupWidget::on_deleteSelectedPushButton_clicked()
         return;
     }
 
-    const QString file_name = model->item(selectedRows.first(), 5)->data(Qt::DisplayRole).toString();
+    const QString file_name = model->item(selectedRows.first(), FILE_COLUMN)->data(Qt::DisplayRole).toString();
     const QString backup_name = OPL::Paths::filePath(OPL::Paths::Backup, file_name);
     QFile file(OPL::Paths::filePath(OPL::Paths::Backup, file_name));
 
@@ -197,6 +256,11 @@ void BackupWidget::on_deleteSelectedPushButton_clicked()
     } else {
         INFO(tr("Backup successfully deleted."));
     }
+    summaryCache->remove(backup_name);
+
+    // archives share their data, only remove what is no longer used by any archive
+    if (OPL::BackupArchive::isArchive(file_name))
+        OPL::BackupArchive::removeUnusedChunks(OPL::Paths::directory(OPL::Paths::Backup));
 
     model->removeRow(selectedRows.first());
     view->clearSelection();
@@ -220,7 +284,7 @@ void BackupWidget::on_createExternalPushButton_clicked()
         filename.append(".db");
     }
 
-    if(!DB->createBackup(QDir::toNativeSeparators(filename))) {
+    if(!runBackupTask(OPL::BackupTask::Mode::Backup, QDir::toNativeSeparators(filename))) {
         WARN(tr("Unable to backup file:").arg(filename));
         return;
     } else {
@@ -234,13 +298,21 @@ void BackupWidget::on_restoreExternalPushButton_clicked()
                 this,
                 tr("Choose backup file"),
                 QDir::homePath(),
-                "*.db"
+                QStringLiteral("*.db")
     );
 
     if(filename.isEmpty()) { // QFileDialog has been cancelled
         return;
     }
 
+    // archives store their data in the chunk directory of the backup directory and can not be restored on their own
+    if(OPL::BackupArchive::isArchive(filename)) {
+        WARN(tr("<tt>%1</tt> is a local backup archive and can not be imported on its own.<br><br>"
+                "Local backups are restored from the list of backups. To move a logbook to another location "
+                "or computer, create an external backup instead.").arg(QFileInfo(filename).fileName()));
+        return;
+    }
+
     // Maybe create a Message Box asking for confirmation here and displaying the summary of backup and active DB
 
     QMessageBox confirm(this);
@@ -253,7 +325,7 @@ void BackupWidget::on_restoreExternalPushButton_clicked()
                        "<br>Continue?"
                        ).arg(OPL::DbSummary::summaryString(filename)));
     if (confirm.exec() == QMessageBox::Yes) {
-        if(!DB->restoreBackup(QDir::toNativeSeparators(filename))) {
+        if(!runBackupTask(OPL::BackupTask::Mode::Restore, QDir::toNativeSeparators(filename))) {
             WARN(tr("Unable to import database file:").arg(filename));
             return;
         }
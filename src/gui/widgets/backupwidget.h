@@ -24,6 +24,8 @@
 #include <QFileSystemModel>
 #include <QFileSystemWatcher>
 #include <QTableView>
+#include "src/database/dbsummarycache.h"
+#include "src/database/backuptask.h"
 
 namespace Ui {
 class BackupWidget;
@@ -34,6 +36,7 @@ class BackupWidget;
  * database.
  * \details OpenPilotLog offers two kinds of backups: Local and External Backups.<br><br>Local backups
  * are automatically stored in a folder determined by OPL::Paths and automatically presented to the user in a List.
+ * New local backups are created as compressed OPL::BackupArchive files, which share unchanged data with previous backups.
  * <b>Create Local backup</b> and <b>Restore Local Backup</b>. are convenient shortcuts.<br>
  * When using <b>Create External Backup</b>, the user will be asked where to save the backup file. This can be a pen drive, a cloud location or any other location of his choice.
  * This functionality can also be used to sync the database across devices. External backup files con be restored with <b>Restore external backup</b>.
@@ -47,13 +50,15 @@ public:
 
     /*!
      * \brief Generates a filename for creating a backup
+     * \param extension - the file extension, either ".db" for a copy of the database or
+     * OPL::BackupArchive::FILE_EXTENSION for a compressed archive
      */
-    static const QString backupName();
+    static const QString backupName(const QString &extension = QStringLiteral(".db"));
 
     /*!
      * \brief Generates the absolute path for a new local backup file.
      */
-    static const QString absoluteBackupPath();
+    static const QString absoluteBackupPath(const QString &extension = QStringLiteral(".db"));
 
 private slots:
     void on_tableView_clicked(const QModelIndex &index);
@@ -94,9 +99,28 @@ private:
     QStandardItemModel *model;
     QTableView *view;
     QList<int> selectedRows;
+    OPL::DbSummaryCache *summaryCache;
     void refresh();
 
+    /*!
+     * \brief Inserts a row for a backup file at the given position. The summary columns
+     * are filled in once the summary has been created by the DbSummaryCache.
+     */
+    void insertBackupRow(int row, const QString &file_name);
+
+    /*!
+     * \brief Fills in the summary columns of the row displaying file_path
+     */
+    void onSummaryReady(const QString &file_path, const QMap<OPL::DbSummaryKey, QString> &summary);
+
+    /*!
+     * \brief Runs a BackupTask on a worker thread while displaying its progress.
+     * \return true if the backup has been created or restored successfully
+     */
+    bool runBackupTask(OPL::BackupTask::Mode mode, const QString &file_path);
+
     static constexpr int DATE_COLUMN = 4;
+    static constexpr int FILE_COLUMN = 5;
 
 protected:
     /*!
@@ -11,11 +11,13 @@
 #include <QCalendarWidget>
 #include <QInputDialog>
 #include <QLabel>
+#include "src/testing/trace.h"
 
 CurrencyWidget::CurrencyWidget(QWidget *parent)
     : QWidget{parent}
 {
-    m_format = Settings::getDisplayFormat();
+    TRACE_FUNCTION("gui");
+    m_formatter = OPL::DateTimeFormatter(Settings::getDisplayFormat());
     setupModelAndView();
     setupUI();
 
@@ -155,7 +157,7 @@ void CurrencyWidget::fillFlightTimeLimitations()
     for (const auto &pair : limits) {
         int accruedMinutes = OPL::Statistics::totalTime(pair.second);
         int limitMinutes = EasaFTL::getLimit(pair.second);
-        pair.first->setText(OPL::Time(accruedMinutes, m_format).toString());
+        pair.first->setText(m_formatter.timeString(accruedMinutes));
 
 
         if (accruedMinutes >= limitMinutes)
@@ -2,6 +2,7 @@
 #define CURRENCYWIDGET_H
 
 #include "src/opl.h"
+#include "src/classes/datetimeformatter.h"
 #include <QWidget>
 #include <QCalendarWidget>
 #include <QTableView>
@@ -15,7 +16,7 @@ class CurrencyWidget : public QWidget
     QSqlTableModel *model;
     QCalendarWidget *calendar;
     QModelIndex lastSelection;
-    OPL::DateTimeFormat m_format;
+    OPL::DateTimeFormatter m_formatter;
 
     int ROWID_COLUMN = 0;
     int CURRENCY_NAME_COLUMN = 1;
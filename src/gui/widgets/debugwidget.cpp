@@ -20,10 +20,19 @@
 #include "src/opl.h"
 #include "ui_debugwidget.h"
 #include <QtGlobal>
+#include <QFontDatabase>
+#include <QScrollBar>
+#include <QProgressDialog>
 #include "src/classes/downloadhelper.h"
 #include "src/database/database.h"
+#include "src/database/jsontableloader.h"
+#include "src/import/importer.h"
+#include "src/import/importformats.h"
 #include "src/testing/atimer.h"
+#include "src/testing/syntheticlogbook.h"
 #include "src/classes/settings.h"
+#include "src/functions/metrics.h"
+#include "src/testing/trace.h"
 
 void DebugWidget::on_debugPushButton_clicked()
 {
@@ -57,14 +66,17 @@ DebugWidget::DebugWidget(QWidget *parent) :
     QWidget(parent),
     ui(new Ui::DebugWidget)
 {
+    TRACE_FUNCTION("gui");
     ui->setupUi(this);
-    for (const auto& table : DB->getTableNames()) {
-        if( table != "sqlite_sequence") {
-            ui->tableComboBox->addItem(table);
-        }
-    }
+    for (const auto &format : OPL::Import::Formats::all())
+        ui->importFormatComboBox->addItem(format.name);
     ui->debugLineEdit->setCompleter(QCompleterProvider.getCompleter(CompleterProvider::Airports));
     ui->debug2LineEdit->setCompleter(QCompleterProvider.getCompleter(CompleterProvider::Airports));
+
+    ui->metricsPlainTextEdit->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    QObject::connect(&metricsTimer, &QTimer::timeout,
+                     this,          &DebugWidget::refreshMetrics);
+    metricsTimer.start(1000);
 }
 
 DebugWidget::~DebugWidget()
@@ -94,52 +106,56 @@ void DebugWidget::on_resetDatabasePushButton_clicked()
     }
 
 
-    // Download templates
-    QString branch_name = ui->branchLineEdit->text();
-
-    // Create url string
-    auto template_url_string = QStringLiteral("https://raw.githubusercontent.com/fiffty-50/openpilotlog/");
-    template_url_string.append(branch_name);
-    template_url_string.append(QLatin1String("/assets/database/templates/"));
-
-    QDir template_dir(OPL::Paths::directory(OPL::Paths::Templates));
-    QStringList template_table_names;
-    for (const auto table : DB->getTemplateTables())
-        template_table_names.append(OPL::GLOBALS->getDbTableName(table));
-    // Download json files
-    for (const auto& table_name : template_table_names) {
-        QEventLoop loop;
-        DownloadHelper* dl = new DownloadHelper;
-        QObject::connect(dl, &DownloadHelper::done, &loop, &QEventLoop::quit );
-        dl->setTarget(QUrl(template_url_string + table_name + QLatin1String(".json")));
-        dl->setFileName(template_dir.absoluteFilePath(table_name + QLatin1String(".json")));
-        DEB << "Downloading: " << template_url_string + table_name + QLatin1String(".json");
-        dl->download();
-        dl->deleteLater();
-        loop.exec(); // event loop waits for download done signal before allowing loop to continue
-
-        QFileInfo downloaded_file(template_dir.filePath(table_name + QLatin1String(".json")));
-        if (downloaded_file.size() == 0)
-            LOG << "ssl/network error";
-    }
-    // Download checksum files
-    for (const auto& table : template_table_names) {
-        QEventLoop loop;
-        DownloadHelper* dl = new DownloadHelper;
-        QObject::connect(dl, &DownloadHelper::done, &loop, &QEventLoop::quit );
-        dl->setTarget(QUrl(template_url_string + table + QLatin1String(".md5")));
-        dl->setFileName(template_dir.absoluteFilePath(table + QLatin1String(".md5")));
-
-        DEB << "Downloading: " << template_url_string + table + QLatin1String(".md5");
-
-        dl->download();
-        dl->deleteLater();
-        loop.exec(); // event loop waits for download done signal before allowing loop to continue
-
-        QFileInfo downloaded_file(template_dir.filePath(table + QLatin1String(".md5")));
-        if (downloaded_file.size() == 0)
-            LOG << "ssl/network error";
+    // Download the templates from the given branch, clear the branch name to use the bundled template database
+    const QString branch_name = ui->branchLineEdit->text();
+    const bool use_ressource_data = branch_name.isEmpty();
+
+    if (!use_ressource_data) {
+        // Create url string
+        auto template_url_string = QStringLiteral("https://raw.githubusercontent.com/fiffty-50/openpilotlog/");
+        template_url_string.append(branch_name);
+        template_url_string.append(QLatin1String("/assets/database/templates/"));
+
+        QDir template_dir(OPL::Paths::directory(OPL::Paths::Templates));
+        QStringList template_table_names;
+        for (const auto table : DB->getTemplateTables())
+            template_table_names.append(OPL::GLOBALS->getDbTableName(table));
+        // Download json files
+        for (const auto& table_name : template_table_names) {
+            QEventLoop loop;
+            DownloadHelper* dl = new DownloadHelper;
+            QObject::connect(dl, &DownloadHelper::done, &loop, &QEventLoop::quit );
+            dl->setTarget(QUrl(template_url_string + table_name + QLatin1String(".json")));
+            dl->setFileName(template_dir.absoluteFilePath(table_name + QLatin1String(".json")));
+            DEB << "Downloading: " << template_url_string + table_name + QLatin1String(".json");
+            dl->download();
+            dl->deleteLater();
+            loop.exec(); // event loop waits for download done signal before allowing loop to continue
+
+            QFileInfo downloaded_file(template_dir.filePath(table_name + QLatin1String(".json")));
+            if (downloaded_file.size() == 0)
+                LOG << "ssl/network error";
+        }
+        // Download checksum files
+        for (const auto& table : template_table_names) {
+            QEventLoop loop;
+            DownloadHelper* dl = new DownloadHelper;
+            QObject::connect(dl, &DownloadHelper::done, &loop, &QEventLoop::quit );
+            dl->setTarget(QUrl(template_url_string + table + QLatin1String(".md5")));
+            dl->setFileName(template_dir.absoluteFilePath(table + QLatin1String(".md5")));
+
+            DEB << "Downloading: " << template_url_string + table + QLatin1String(".md5");
+
+            dl->download();
+            dl->deleteLater();
+            loop.exec(); // event loop waits for download done signal before allowing loop to continue
+
+            QFileInfo downloaded_file(template_dir.filePath(table + QLatin1String(".md5")));
+            if (downloaded_file.size() == 0)
+                LOG << "ssl/network error";
+        }
     }
+
     // Create Database
     if (!DB->createSchema()) {
         WARN(QString("Unable to create database.<br>%1").arg(DB->lastError.text()));
@@ -147,7 +163,6 @@ void DebugWidget::on_resetDatabasePushButton_clicked()
     }
 
     // Load ressources
-    bool use_ressource_data = false; // do not use local data, download from github
     if(!DB->importTemplateData(use_ressource_data)) {
         WARN(tr("Database creation has been unsuccessful. Unable to fill template data.<br><br>%1")
              .arg(DB->lastError.text()));
@@ -165,82 +180,116 @@ void DebugWidget::downloadFinished()
 
 void DebugWidget::on_fillUserDataPushButton_clicked()
 {
-    TODO << "Create JSON sample data and import";
-    /*
+    // Sample data is read from sample_<table>.json in the templates directory
     ATimer timer(this);
-    QMessageBox message_box(this);
-    // download latest json
-    QStringList userTables = {"pilots", "tails", "flights"};
-    QString linkStub = "https://raw.githubusercontent.com/fiffty-50/openpilotlog/";
-    linkStub.append(ui->branchLineEdit->text());
-    linkStub.append("/assets/database/templates/sample_");
-    QDir template_dir(AStandardPaths::directory(AStandardPaths::Templates));
-
-    for (const auto& table : userTables) {
-        QEventLoop loop;
-        ADownload* dl = new ADownload;
-        connect(dl, &ADownload::done, &loop, &QEventLoop::quit );
-        dl->setTarget(QUrl(linkStub + table + ".json"));
-        dl->setFileName(template_dir.filePath("sample_" % table % QStringLiteral(".json")));
-        dl->download();
-        loop.exec(); // event loop waits for download done signal before allowing loop to continue
-        dl->deleteLater();
+    const QDir template_dir(OPL::Paths::directory(OPL::Paths::Templates));
+    const QList<OPL::DbTable> user_tables = {
+        OPL::DbTable::Pilots,
+        OPL::DbTable::Tails,
+        OPL::DbTable::Flights,
+    };
+
+    QStringList errors;
+    for (const auto table : user_tables) {
+        const QString table_name = OPL::GLOBALS->getDbTableName(table);
+        const QString file_path = template_dir.absoluteFilePath(QLatin1String("sample_") + table_name
+                                                                + QLatin1String(".json"));
+        OPL::JsonTableLoader loader(table);
+        if (!loader.loadFile(file_path)) {
+            errors.append(QStringLiteral("%1: %2").arg(table_name, loader.errorString()));
+            continue;
+        }
+        for (const auto &error : loader.rowErrors())
+            errors.append(QStringLiteral("%1, row %2: %3").arg(table_name).arg(error.row).arg(error.message));
+        LOG << loader.rowsInserted() << "rows imported into" << table_name;
     }
-    QBitArray allGood;
-    allGood.resize(userTables.size());
+    emit DB->dataBaseUpdated(OPL::DbTable::Any);
 
-    for (const auto& table : userTables) {
-        auto data = readcsv(AStandardPaths::directory(AStandardPaths::Templates).absoluteFilePath(
-                             + "sample_" + table + ".json"));
-        allGood.setBit(userTables.indexOf(table), aDbSetup::commitData(data, table));
+    QMessageBox message_box(this);
+    if (errors.isEmpty()) {
+        message_box.setText(tr("User tables successfully populated."));
+    } else {
+        message_box.setText(tr("Errors have ocurred. Check details."));
+        message_box.setDetailedText(errors.join(QLatin1Char('\n')));
     }
+    message_box.exec();
+}
 
-    if (allGood.count(true) != userTables.size()) {
-        message_box.setText("Errors have ocurred. Check console for details.");
-        message_box.exec();
+void DebugWidget::on_syntheticLogbookPushButton_clicked()
+{
+    ATimer timer(this);
+    if (!DB->resetUserData()) {
+        WARN(tr("Unable to reset the user tables.<br><br>%1").arg(DB->lastError.text()));
         return;
     }
 
-    message_box.setText("User tables successfully populated.");
-    message_box.exec();
-    emit DB->dataBaseUpdated();
-    */
+    QProgressDialog progress_dialog(tr("Generating logbook..."), QString(), 0, 0, this);
+    progress_dialog.setWindowModality(Qt::WindowModal);
+    progress_dialog.setMinimumDuration(500);
+
+    // generate the logbook through a connection of its own on a worker thread
+    const int number_of_flights = ui->syntheticFlightsSpinBox->value();
+    const QString database_path = OPL::Paths::databaseFileInfo().absoluteFilePath();
+    OPL::SyntheticLogbook logbook(1);
+    bool success = false;
+    QThread *thread = QThread::create([&logbook, &success, number_of_flights, &database_path] {
+        success = logbook.generate(number_of_flights, database_path);
+    });
+    QEventLoop loop;
+    QObject::connect(thread, &QThread::finished, &loop, &QEventLoop::quit);
+    thread->start();
+    loop.exec();
+    thread->wait();
+    delete thread;
+
+    if (!success) {
+        WARN(tr("Unable to generate the synthetic logbook.<br><br>%1").arg(logbook.errorString()));
+        return;
+    }
+    LOG << "Synthetic logbook generated:" << number_of_flights << "flights,"
+        << logbook.numberOfPilots() << "pilots," << logbook.numberOfTails() << "tails";
+    emit DB->dataBaseUpdated(OPL::DbTable::Any);
 }
 
 void DebugWidget::on_selectCsvPushButton_clicked()
 {
     auto fileName = QFileDialog::getOpenFileName(this,
                                                  tr("Open CSV File for import"),
-                                                 OPL::Paths::directory(OPL::Paths::Templates).absolutePath(),
+                                                 QDir::homePath(),
                                                  tr("CSV files (*.csv)"));
     ui->importCsvLineEdit->setText(fileName);
 }
 
 void DebugWidget::on_importCsvPushButton_clicked()
 {
-    WARN("Not currently working...");
-    /*
+    const QFileInfo file(ui->importCsvLineEdit->text());
+    if (!file.isFile()) {
+        WARN(tr("Please select a valid file."));
+        return;
+    }
+
     ATimer timer(this);
-    auto file = QFileInfo(ui->importCsvLineEdit->text());
-    DEB << "File exists/is file:" << file.exists() << file.isFile() << " Path:" << file.absoluteFilePath();
-
-    if (file.exists() && file.isFile()) {
-
-        if (DataBaseSetup::commitData(aReadCsv(file.absoluteFilePath()), ui->tableComboBox->currentText())) {
-            QMessageBox message_box(this);
-            message_box.setText("Data inserted successfully.");
-            message_box.exec();
-        } else {
-            QMessageBox message_box(this);
-            message_box.setText("Errors have ocurred. Check console for details.");
-            message_box.exec();
-        }
-    } else {
-        QMessageBox message_box(this);
-        message_box.setText("Please select a valid file.");
-        message_box.exec();
+    const bool dry_run = ui->importDryRunCheckBox->isChecked();
+    const auto &format = OPL::Import::Formats::all().at(ui->importFormatComboBox->currentIndex());
+    OPL::Import::Importer importer(format, file.absoluteFilePath());
+    importer.setDryRun(dry_run);
+    if (!importer.exec()) {
+        WARN(tr("Unable to import %1.<br><br>%2").arg(file.fileName(), importer.errorString()));
+        return;
+    }
+
+    const auto &report = importer.report();
+    QString message = tr("%1 of %2 rows %3, %4 rows skipped.<br>New pilots: %5<br>New aircraft: %6<br>")
+            .arg(report.rowsImported).arg(report.rowsRead)
+            .arg(dry_run ? tr("would be imported") : tr("imported"))
+            .arg(report.rowsSkipped).arg(report.newPilots).arg(report.newTails);
+    if (report.errorCount > 0) {
+        message.append(tr("<br>%1 invalid values, the first ones are:<br>").arg(report.errorCount));
+        for (const auto &error : report.errors.first(qMin<qsizetype>(REPORTED_IMPORT_ERRORS, report.errors.size())))
+            message.append(tr("Line %1, %2: %3 <tt>%4</tt><br>")
+                           .arg(error.line).arg(error.field, error.message, error.value.toHtmlEscaped()));
     }
-    */
+    INFO(message);
 }
 
 void DebugWidget::changeEvent(QEvent *event)
@@ -308,3 +357,68 @@ void DebugWidget::on_pushButton_clicked()
     Settings::setSetupCompleted(false);
 }
 
+void DebugWidget::on_traceStartPushButton_clicked()
+{
+    OPL::Trace::clear();
+    OPL::Trace::start();
+    ui->traceStartPushButton->setEnabled(false);
+    ui->traceSavePushButton->setEnabled(true);
+}
+
+void DebugWidget::on_traceSavePushButton_clicked()
+{
+    OPL::Trace::stop();
+    ui->traceStartPushButton->setEnabled(true);
+    ui->traceSavePushButton->setEnabled(false);
+
+    const QString file_name = QFileDialog::getSaveFileName(this,
+                                                           tr("Save Trace"),
+                                                           OPL::Paths::directory(OPL::Paths::Log).absoluteFilePath(
+                                                               QStringLiteral("opl_trace.json")),
+                                                           tr("Trace files (*.json)"));
+    if (file_name.isEmpty())
+        return;
+
+    if (!OPL::Trace::writeChromeTrace(file_name)) {
+        WARN(tr("Unable to write trace file: %1").arg(file_name));
+        return;
+    }
+    if (OPL::Trace::droppedEvents() > 0)
+        LOG << OPL::Trace::droppedEvents() << "trace events have been dropped.";
+    LOG << "Trace written to" << file_name;
+}
+
+void DebugWidget::refreshMetrics()
+{
+    if (!ui->metricsTab->isVisible())
+        return;
+
+    // keep the scroll position while the text is replaced
+    const int scroll_position = ui->metricsPlainTextEdit->verticalScrollBar()->value();
+    ui->metricsPlainTextEdit->setPlainText(OPL::Metrics::report());
+    ui->metricsPlainTextEdit->verticalScrollBar()->setValue(scroll_position);
+}
+
+void DebugWidget::on_metricsResetPushButton_clicked()
+{
+    OPL::Metrics::reset();
+    refreshMetrics();
+}
+
+void DebugWidget::on_metricsSavePushButton_clicked()
+{
+    const QString file_name = QFileDialog::getSaveFileName(this,
+                                                           tr("Save Metrics"),
+                                                           OPL::Paths::directory(OPL::Paths::Log).absoluteFilePath(
+                                                               QStringLiteral("opl_metrics.json")),
+                                                           tr("JSON files (*.json)"));
+    if (file_name.isEmpty())
+        return;
+
+    if (!OPL::Metrics::writeJson(file_name)) {
+        WARN(tr("Unable to write metrics file: %1").arg(file_name));
+        return;
+    }
+    LOG << "Metrics written to" << file_name;
+}
+
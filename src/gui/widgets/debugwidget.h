@@ -25,6 +25,7 @@
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QProcess>
+#include <QTimer>
 
 namespace Ui {
 class DebugWidget;
@@ -47,6 +48,8 @@ private slots:
 
     void on_fillUserDataPushButton_clicked();
 
+    void on_syntheticLogbookPushButton_clicked();
+
     void on_selectCsvPushButton_clicked();
 
     void on_importCsvPushButton_clicked();
@@ -59,11 +62,29 @@ private slots:
 
     void on_pushButton_clicked();
 
+    void on_traceStartPushButton_clicked();
+
+    void on_traceSavePushButton_clicked();
+
+    void on_metricsResetPushButton_clicked();
+
+    void on_metricsSavePushButton_clicked();
+
+    /*!
+     * \brief Shows the current metrics while the metrics tab is visible
+     */
+    void refreshMetrics();
+
 private:
     Ui::DebugWidget *ui;
 
     bool downloadComplete = false;
 
+    QTimer metricsTimer;
+
+    // the number of invalid values listed after an import
+    static constexpr int REPORTED_IMPORT_ERRORS = 10;
+
 protected:
     void changeEvent(QEvent* event) override;
 };
@@ -20,11 +20,13 @@
 #include "src/gui/widgets/totalswidget.h"
 #include "ui_homewidget.h"
 #include "src/database/database.h"
+#include "src/testing/trace.h"
 
 HomeWidget::HomeWidget(QWidget *parent) :
     QWidget(parent),
     ui(new Ui::HomeWidget)
 {
+    TRACE_FUNCTION("gui");
     ui->setupUi(this);
 
     const auto logo = QPixmap(OPL::Assets::LOGO);
@@ -24,16 +24,18 @@
 #include "src/database/database.h"
 #include "src/opl.h"
 #include "src/gui/widgets/backupwidget.h"
+#include "src/testing/trace.h"
 
 SettingsWidget::SettingsWidget(QWidget *parent) :
     QWidget(parent),
     ui(new Ui::SettingsWidget)
 {
+    TRACE_FUNCTION("gui");
     ui->setupUi(this);
     ui->tabWidget->setCurrentIndex(0);
 
-    loadBackupWidget();
-    loadPreviousExperienceWidget();
+    // The backup and previous experience tabs query the database (and every backup file)
+    // when they are created, so they are only loaded once the user opens the tab.
     setupComboBoxes();
     setupValidators();
     readSettings();
@@ -66,6 +68,15 @@ void SettingsWidget::setupComboBoxes(){
     }
 }
 
+void SettingsWidget::on_tabWidget_currentChanged(int index)
+{
+    const QWidget *tab = ui->tabWidget->widget(index);
+    if (tab == ui->backupTab && ui->backupStackedWidget->count() == 0)
+        loadBackupWidget();
+    else if (tab == ui->previousExpTab && ui->previousExpStackedWidget->count() == 0)
+        loadPreviousExperienceWidget();
+}
+
 void SettingsWidget::loadBackupWidget()
 {
     auto bw = new BackupWidget(this);
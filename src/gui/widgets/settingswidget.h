@@ -52,6 +52,10 @@ public:
 
 private slots:
 
+    /*!
+     * \brief Loads the backup and previous experience widgets the first time their tab is shown
+     */
+    void on_tabWidget_currentChanged(int index);
     void on_aboutPushButton_clicked();
     void on_aboutBackupsPushButton_clicked();
     void on_acftSortComboBox_currentIndexChanged(int index);
@@ -1,6 +1,8 @@
 #include "tableeditwidget.h"
 #include "src/database/database.h"
 #include "src/opl.h"
+#include "src/functions/metrics.h"
+#include "src/testing/trace.h"
 #include <QGridLayout>
 #include <QLabel>
 
@@ -10,6 +12,7 @@ TableEditWidget::TableEditWidget(Orientation orientation, QWidget *parent)
 
 void TableEditWidget::init()
 {
+    TRACE_FUNCTION("gui");
     setupUI();
     setupSignalsAndSlots();
 }
@@ -121,6 +124,11 @@ void TableEditWidget::setupSignalsAndSlots()
     // refresh the view when the database is updated
     QObject::connect(DB,             		   	&OPL::Database::dataBaseUpdated,
                      this,     		 		   	&TableEditWidget::databaseContentChanged);
+    QObject::connect(DB,             		   	&OPL::Database::connectionReset,
+                     this,     		 		   	&TableEditWidget::databaseContentChanged);
+    // finish reading before the database contents are replaced
+    QObject::connect(DB,             		   	&OPL::Database::aboutToReplaceContents,
+                     this,     		 		   	&TableEditWidget::finishFetching);
     // filter the view
     QObject::connect(m_filterLineEdit,  		&QLineEdit::textChanged,
                      this,                     	&TableEditWidget::filterTextChanged);
@@ -207,10 +215,18 @@ void TableEditWidget::sortColumnChanged(int newSortColumn)
 
 void TableEditWidget::databaseContentChanged()
 {
+    TRACE_FUNCTION("gui");
+    OPL::Metrics::counter(QStringLiteral("gui/modelReloads/%1").arg(QLatin1String(metaObject()->className()))).add();
     m_model->select();
     m_view->resizeColumnsToContents();
 }
 
+void TableEditWidget::finishFetching()
+{
+    while (m_model->canFetchMore())
+        m_model->fetchMore();
+}
+
 void TableEditWidget::showEditWidget()
 {
     m_buttonWidget->hide();
@@ -149,6 +149,11 @@ public slots:
      */
     void databaseContentChanged();
 
+    /*!
+     * \brief fetch the remaining rows of the model, which finishes its query and releases its read lock
+     */
+    void finishFetching();
+
 };
 
 #endif // TABLEEDITWIDGET_H
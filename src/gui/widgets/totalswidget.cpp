@@ -23,11 +23,13 @@
 #include "src/classes/time.h"
 #include "ui_totalswidget.h"
 #include "src/classes/settings.h"
+#include "src/testing/trace.h"
 
 TotalsWidget::TotalsWidget(WidgetType widgetType, QWidget *parent) :
     QWidget(parent),
     ui(new Ui::TotalsWidget)
 {
+    TRACE_FUNCTION("gui");
     ui->setupUi(this);
     setup(widgetType);
 }
@@ -45,6 +47,7 @@ TotalsWidget::~TotalsWidget()
 void TotalsWidget::setup(const WidgetType widgetType)
 {
     m_format = Settings::getDisplayFormat();
+    m_formatter = OPL::DateTimeFormatter(m_format);
     const QList<QLineEdit *> lineEdits = this->findChildren<QLineEdit *>();
 
     switch (widgetType) {
@@ -109,8 +112,7 @@ void TotalsWidget::fillTotals(const WidgetType widgetType)
                 line_edit->setText(field.toString());
             } else {
                 // line edits for total time
-                OPL::Time time = OPL::Time(field.toInt(), m_format);
-                line_edit->setText(time.toString());
+                line_edit->setText(m_formatter.timeString(field.toInt()));
             }
         }
 
@@ -184,8 +186,7 @@ void TotalsWidget::timeLineEditEditingFinished()
 
     // Read back the value and set the line edit to confirm input is correct and provide user feedback
     m_rowData = DB->getRowData(OPL::DbTable::PreviousExperience, ROW_ID);
-    OPL::Time new_time = OPL::Time(m_rowData.value(db_field).toInt(), m_format);
-    line_edit->setText(new_time.toString());
+    line_edit->setText(m_formatter.timeString(m_rowData.value(db_field).toInt()));
 }
 
 void TotalsWidget::movementLineEditEditingFinished()
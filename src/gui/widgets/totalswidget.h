@@ -21,6 +21,7 @@
 #include "QtWidgets/qlineedit.h"
 #include "src/gui/verification/timeinput.h"
 #include "src/opl.h"
+#include "src/classes/datetimeformatter.h"
 #include <QWidget>
 #include <QRegularExpressionValidator>
 
@@ -62,6 +63,7 @@ private:
      */
 
     OPL::DateTimeFormat m_format;
+    OPL::DateTimeFormatter m_formatter;
     const static int ROW_ID = 1;
     void fillTotals(const WidgetType widgetType);
     void setup(const WidgetType widgetType);
@@ -0,0 +1,118 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "fieldparser.h"
+
+namespace OPL::Import {
+
+void FieldParser::parseColumn(const FieldSpec &field, const FormatSpec &format, const QStringList &values,
+                              QVariantList &result, QVector<int> &invalid)
+{
+    // look up the date layout once for the whole column
+    const auto layout = DateTimeParser::layoutFromFormat(format.dateFormat);
+    result.resize(values.size());
+    bool ok;
+    for (qsizetype i = 0; i < values.size(); i++) {
+        result[i] = parseValue(field, format, layout, values[i], ok);
+        if (!ok)
+            invalid.append(i);
+    }
+}
+
+QVariant FieldParser::parse(const FieldSpec &field, const FormatSpec &format, const QString &value, bool &ok)
+{
+    return parseValue(field, format, DateTimeParser::layoutFromFormat(format.dateFormat), value, ok);
+}
+
+QVariant FieldParser::parseValue(const FieldSpec &field, const FormatSpec &format,
+                                 std::optional<DateTimeParser::DateLayout> layout, const QString &value, bool &ok)
+{
+    ok = true;
+    const QString trimmed = value.trimmed();
+    if (trimmed.isEmpty())
+        return field.type == FieldType::Boolean ? QVariant(0) : QVariant();
+
+    switch (field.type) {
+    case FieldType::Text:
+    case FieldType::Name:
+        return trimmed;
+    case FieldType::Date: {
+        int julian_day = DateTimeParser::INVALID;
+        if (layout) {
+            julian_day = DateTimeParser::julianDay(trimmed, *layout);
+        } else {
+            const QDate date = QDate::fromString(trimmed, format.dateFormat);
+            if (date.isValid())
+                julian_day = date.toJulianDay();
+        }
+        ok = julian_day != DateTimeParser::INVALID;
+        return ok ? QVariant(julian_day) : QVariant();
+    }
+    case FieldType::Time: {
+        const int minutes = DateTimeParser::minutesOfDay(trimmed);
+        ok = minutes != DateTimeParser::INVALID;
+        return ok ? QVariant(minutes) : QVariant();
+    }
+    case FieldType::Duration: {
+        int minutes = DateTimeParser::INVALID;
+        switch (format.durationFormat) {
+        case DurationFormat::Minutes:
+            minutes = trimmed.toInt(&ok);
+            if (!ok || minutes < 0)
+                minutes = DateTimeParser::INVALID;
+            break;
+        case DurationFormat::HoursMinutes:
+            minutes = DateTimeParser::durationMinutes(trimmed);
+            break;
+        case DurationFormat::DecimalHours:
+            minutes = DateTimeParser::decimalHoursToMinutes(trimmed);
+            break;
+        }
+        ok = minutes != DateTimeParser::INVALID;
+        return ok ? QVariant(minutes) : QVariant();
+    }
+    case FieldType::Integer: {
+        const int number = trimmed.toInt(&ok);
+        return ok ? QVariant(number) : QVariant();
+    }
+    case FieldType::Boolean:
+        return format.trueValues.contains(trimmed, Qt::CaseInsensitive) ? 1 : 0;
+    case FieldType::Enum: {
+        const auto it = field.values.constFind(trimmed);
+        ok = it != field.values.constEnd();
+        return ok ? QVariant(it.value()) : QVariant();
+    }
+    }
+    ok = false;
+    return QVariant();
+}
+
+std::pair<QString, QString> FieldParser::splitName(const QString &name, NameOrder order)
+{
+    const QString simplified = QString(name).replace(QLatin1Char(','), QLatin1Char(' ')).simplified();
+    const qsizetype split = order == NameOrder::LastFirst ? simplified.indexOf(QLatin1Char(' '))
+                                                          : simplified.lastIndexOf(QLatin1Char(' '));
+    if (split == -1)
+        return {simplified, QString()};
+
+    if (order == NameOrder::LastFirst)
+        return {simplified.left(split), simplified.mid(split + 1)};
+    else
+        return {simplified.mid(split + 1), simplified.left(split)};
+}
+
+} // namespace OPL::Import
@@ -0,0 +1,66 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef FIELDPARSER_H
+#define FIELDPARSER_H
+#include "src/import/importspec.h"
+#include "src/functions/datetimeparser.h"
+
+namespace OPL::Import {
+
+/*!
+ * \brief The FieldParser class converts the raw values of a source file to the database format.
+ *
+ * \details Values are converted one column at a time, so that the same conversion runs in a tight loop
+ * over all values of a chunk and columns can be converted in parallel. Dates and times in the common
+ * layouts are parsed with the DateTimeParser, other date formats fall back to QDate.
+ */
+class FieldParser
+{
+public:
+    FieldParser() = delete;
+
+    /*!
+     * \brief Converts all values of one source column
+     * \param field - the specification of the column
+     * \param format - the specification of the source format
+     * \param values - the raw values
+     * \param result - receives one converted value per raw value. Empty and invalid values are NULL.
+     * \param invalid - receives the indexes of the values which could not be converted
+     */
+    static void parseColumn(const FieldSpec &field, const FormatSpec &format, const QStringList &values,
+                            QVariantList &result, QVector<int> &invalid);
+
+    /*!
+     * \brief Converts a single value
+     * \param ok - set to false if a non-empty value could not be converted
+     */
+    static QVariant parse(const FieldSpec &field, const FormatSpec &format, const QString &value, bool &ok);
+
+    /*!
+     * \brief Splits a name into last name and first name(s). Commas and surplus whitespace are dropped.
+     */
+    static std::pair<QString, QString> splitName(const QString &name, NameOrder order);
+
+private:
+    static QVariant parseValue(const FieldSpec &field, const FormatSpec &format,
+                               std::optional<DateTimeParser::DateLayout> layout, const QString &value, bool &ok);
+};
+
+} // namespace OPL::Import
+
+#endif // FIELDPARSER_H
@@ -0,0 +1,462 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "importer.h"
+#include "src/opl.h"
+#include "src/import/fieldparser.h"
+#include "src/database/database.h"
+#include "src/database/flightentry.h"
+#include "src/database/pilotentry.h"
+#include "src/database/tailentry.h"
+#include <QSqlError>
+
+namespace OPL::Import {
+
+Importer::Importer(const FormatSpec &format, const QString &file_path)
+    : m_format(format), m_reader(file_path)
+{}
+
+bool Importer::exec()
+{
+    QElapsedTimer total_timer;
+    total_timer.start();
+
+    if (!m_reader.open()) {
+        m_errorString = m_reader.errorString();
+        return false;
+    }
+    CSV::Reader::Row header;
+    if (!m_reader.readRow(header)) {
+        m_errorString = QStringLiteral("The file is empty.");
+        return false;
+    }
+    m_line = 1;
+    if (!mapColumns(header))
+        return false;
+
+    loadDimensions();
+
+    // Inhibit HomeWindow Updating
+    QSignalBlocker blocker(DB);
+
+    // Prepare database and set up exclusive transaction for mass commit
+    QSqlQuery transaction(DB->database());
+    if (!m_dryRun) {
+        if (!transaction.exec(QStringLiteral("BEGIN EXCLUSIVE TRANSACTION"))) {
+            m_errorString = transaction.lastError().text();
+            return false;
+        }
+    }
+
+    bool success = m_dryRun || prepareStatements();
+    while (success && parse() > 0) {
+        normalise();
+        resolve();
+        if (!m_dryRun)
+            success = insert();
+    }
+
+    if (!m_dryRun) {
+        if (success && !transaction.exec(QStringLiteral("COMMIT"))) {
+            m_errorString = transaction.lastError().text();
+            success = false;
+        }
+        if (!success) {
+            transaction.exec(QStringLiteral("ROLLBACK"));
+            return false;
+        }
+    }
+
+    LOG << m_format.name << (m_dryRun ? "dry run" : "import") << "finished in" << total_timer.elapsed() << "ms";
+    logReport();
+
+    if (!m_dryRun) {
+        blocker.unblock();
+        emit DB->dataBaseUpdated(OPL::DbTable::Any);
+    }
+    return true;
+}
+
+bool Importer::mapColumns(const CSV::Reader::Row &header)
+{
+    QHash<QString, int> header_columns;
+    for (int i = 0; i < header.size(); i++)
+        header_columns.insert(header.toString(i).trimmed(), i);
+
+    const std::array<QString, 3> references = {
+        OPL::FlightEntry::PIC, OPL::FlightEntry::SECONDPILOT, OPL::FlightEntry::THIRDPILOT
+    };
+    for (int i = 0; i < 3; i++)
+        m_pilotSlots[i].reference = references[i];
+
+    QStringList missing;
+    const auto &fields = m_format.fields;
+    m_sourceColumns.resize(fields.size());
+    for (int f = 0; f < fields.size(); f++) {
+        const FieldSpec &field = fields[f];
+        const int column = field.source.header.isEmpty() ? field.source.index
+                                                         : header_columns.value(field.source.header, -1);
+        if (column == -1 && field.mandatory)
+            missing.append(field.source.header);
+        m_sourceColumns[f] = column;
+
+        switch (field.target) {
+        case Target::Flight:
+            m_flightFields.append(f);
+            break;
+        case Target::Pic:
+        case Target::SecondPilot:
+        case Target::ThirdPilot: {
+            PilotSlot &slot = m_pilotSlots[static_cast<int>(field.target) - static_cast<int>(Target::Pic)];
+            if (field.type == FieldType::Name)
+                slot.nameField = f;
+            else if (!m_pilotColumns.contains(field.field))
+                m_pilotColumns.append(field.field);
+            break;
+        }
+        case Target::Tail:
+            m_tailFields.append(f);
+            if (field.field == OPL::TailEntry::REGISTRATION)
+                m_tailKeyField = f;
+            break;
+        }
+    }
+
+    if (!missing.isEmpty()) {
+        m_errorString = QStringLiteral("The file does not contain the columns: ") + missing.join(QStringLiteral(", "));
+        return false;
+    }
+    if (m_pilotSlots[0].nameField == -1 || m_tailKeyField == -1) {
+        m_errorString = QStringLiteral("The format %1 does not identify the PIC and the aircraft.").arg(m_format.name);
+        return false;
+    }
+
+    // find the field for each pilot column, pilot slots may provide different details
+    for (int i = 0; i < 3; i++) {
+        const Target target = static_cast<Target>(static_cast<int>(Target::Pic) + i);
+        for (const auto &column : std::as_const(m_pilotColumns)) {
+            int field_index = -1;
+            for (int f = 0; f < fields.size(); f++)
+                if (fields[f].target == target && fields[f].field == column)
+                    field_index = f;
+            m_pilotSlots[i].columnFields.append(field_index);
+        }
+    }
+
+    m_raw.resize(fields.size());
+    m_values.resize(fields.size());
+    return true;
+}
+
+void Importer::loadDimensions()
+{
+    // load the pilots and tails already in the database to avoid creating duplicates
+    QSqlQuery query(DB->database());
+    query.setForwardOnly(true);
+    query.exec(QStringLiteral("SELECT pilot_id, lastname, firstname FROM pilots"));
+    while (query.next()) {
+        const int id = query.value(0).toInt();
+        const QString last_name = query.value(1).toString();
+        const QString first_name = query.value(2).toString();
+        QString name = last_name;
+        if (!first_name.isEmpty())
+            name = m_format.nameOrder == NameOrder::LastFirst ? last_name + QLatin1Char(' ') + first_name
+                                                              : first_name + QLatin1Char(' ') + last_name;
+        m_pilotIds.insert(pilotKey(name), id);
+        m_nextPilotId = qMax(m_nextPilotId, id + 1);
+    }
+    // the logbook owner
+    m_pilotIds.insert(pilotKey(m_format.selfName), 1);
+    m_nextPilotId = qMax(m_nextPilotId, 2);
+
+    query.exec(QStringLiteral("SELECT tail_id, registration FROM tails"));
+    while (query.next()) {
+        const int id = query.value(0).toInt();
+        m_tailIds.insert(query.value(1).toString(), id);
+        m_nextTailId = qMax(m_nextTailId, id + 1);
+    }
+}
+
+bool Importer::prepareStatements()
+{
+    const auto placeholders = [](qsizetype count) {
+        return QStringList(count, QStringLiteral("?")).join(QStringLiteral(", "));
+    };
+    const auto &fields = m_format.fields;
+
+    QStringList pilot_columns = {OPL::PilotEntry::ROWID, OPL::PilotEntry::LASTNAME, OPL::PilotEntry::FIRSTNAME};
+    pilot_columns.append(m_pilotColumns);
+
+    QStringList tail_columns = {OPL::TailEntry::ROWID};
+    for (const auto f : std::as_const(m_tailFields))
+        tail_columns.append(fields[f].field);
+
+    QStringList flight_columns;
+    for (const auto f : std::as_const(m_flightFields))
+        flight_columns.append(fields[f].field);
+    for (const auto &slot : m_pilotSlots)
+        if (slot.nameField != -1)
+            flight_columns.append(slot.reference);
+    flight_columns.append(OPL::FlightEntry::ACFT);
+
+    const QString statement = QStringLiteral("INSERT INTO %1 (%2) VALUES (%3)");
+    m_pilotQuery = QSqlQuery(DB->database());
+    m_tailQuery = QSqlQuery(DB->database());
+    m_flightQuery = QSqlQuery(DB->database());
+    const bool prepared =
+            m_pilotQuery.prepare(statement.arg(OPL::PilotEntry::TABLE_NAME, pilot_columns.join(QStringLiteral(", ")),
+                                               placeholders(pilot_columns.size())))
+         && m_tailQuery.prepare(statement.arg(OPL::TailEntry::TABLE_NAME, tail_columns.join(QStringLiteral(", ")),
+                                              placeholders(tail_columns.size())))
+         && m_flightQuery.prepare(statement.arg(OPL::FlightEntry::TABLE_NAME, flight_columns.join(QStringLiteral(", ")),
+                                                placeholders(flight_columns.size())));
+    if (!prepared) {
+        m_errorString = QStringLiteral("Unable to prepare insert statements: ")
+                + m_pilotQuery.lastError().text() + m_tailQuery.lastError().text()
+                + m_flightQuery.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+int Importer::parse()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    m_rows = 0;
+    m_lines.resize(0);
+    for (auto &column : m_raw)
+        column.resize(0);
+
+    CSV::Reader::Row row;
+    while (m_rows < CHUNK_SIZE && m_reader.readRow(row)) {
+        m_line++;
+        if (row.size() <= 1 && row[0].isEmpty())
+            continue; // empty line
+
+        for (int f = 0; f < m_sourceColumns.size(); f++)
+            m_raw[f].append(m_sourceColumns[f] == -1 ? QString() : row.toString(m_sourceColumns[f]));
+        m_lines.append(m_line);
+        m_rows++;
+    }
+
+    m_report.rowsRead += m_rows;
+    m_report.stages[Parse].nsecs += timer.nsecsElapsed();
+    m_report.stages[Parse].items += m_rows;
+    return m_rows;
+}
+
+void Importer::normalise()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // every column is converted by its own task, so no synchronisation is required
+    const auto &fields = m_format.fields;
+    QVector<QVector<int>> invalid(fields.size());
+    for (int f = 0; f < fields.size(); f++) {
+        m_threadPool.start([this, f, &invalid] {
+            FieldParser::parseColumn(m_format.fields[f], m_format, m_raw[f], m_values[f], invalid[f]);
+        });
+    }
+    m_threadPool.waitForDone();
+
+    // validate
+    m_valid.fill(true, m_rows);
+    for (int f = 0; f < fields.size(); f++) {
+        for (const auto row : std::as_const(invalid[f])) {
+            addError(row, f, QStringLiteral("Invalid value"));
+            if (fields[f].mandatory)
+                m_valid[row] = false;
+        }
+        if (!fields[f].mandatory)
+            continue;
+        for (int row = 0; row < m_rows; row++) {
+            if (m_raw[f][row].trimmed().isEmpty()) {
+                addError(row, f, QStringLiteral("Missing value"));
+                m_valid[row] = false;
+            }
+        }
+    }
+
+    m_report.stages[Normalise].nsecs += timer.nsecsElapsed();
+    m_report.stages[Normalise].items += m_rows;
+}
+
+/*!
+ * \brief Returns the key under which a pilot is looked up. Names from the database and from the source file
+ * are compared regardless of case, commas and whitespace, so "Smith, John" matches "SMITH  John".
+ */
+QString Importer::pilotKey(const QString &name)
+{
+    return QString(name).replace(QLatin1Char(','), QLatin1Char(' ')).simplified().toCaseFolded();
+}
+
+void Importer::resolve()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    m_newPilots.clear();
+    m_newTails.clear();
+    for (auto &references : m_pilotRefs)
+        references.fill(QVariant(), m_rows);
+    m_tailRefs.fill(QVariant(), m_rows);
+
+    int valid_rows = 0;
+    for (int row = 0; row < m_rows; row++) {
+        if (!m_valid[row])
+            continue;
+
+        for (int i = 0; i < 3; i++) {
+            const PilotSlot &slot = m_pilotSlots[i];
+            if (slot.nameField == -1)
+                continue;
+            const QString name = m_values[slot.nameField][row].toString();
+            if (name.isEmpty())
+                continue;
+
+            const QString key = pilotKey(name);
+            int id = m_pilotIds.value(key);
+            if (id == 0) {
+                id = m_nextPilotId++;
+                m_pilotIds.insert(key, id);
+                const auto [last_name, first_name] = FieldParser::splitName(name, m_format.nameOrder);
+                QVariantList pilot = {id, last_name, first_name.isEmpty() ? QVariant() : QVariant(first_name)};
+                for (const auto f : slot.columnFields)
+                    pilot.append(f == -1 ? QVariant() : m_values[f][row]);
+                m_newPilots.append(pilot);
+            }
+            m_pilotRefs[i][row] = id;
+        }
+        if (m_pilotRefs[0][row].isNull()) {
+            addError(row, m_pilotSlots[0].nameField, QStringLiteral("Missing PIC"));
+            m_valid[row] = false;
+            continue;
+        }
+
+        const QString registration = m_values[m_tailKeyField][row].toString();
+        if (registration.isEmpty()) {
+            addError(row, m_tailKeyField, QStringLiteral("Missing registration"));
+            m_valid[row] = false;
+            continue;
+        }
+        int id = m_tailIds.value(registration);
+        if (id == 0) {
+            id = m_nextTailId++;
+            m_tailIds.insert(registration, id);
+            QVariantList tail = {id};
+            for (const auto f : std::as_const(m_tailFields))
+                tail.append(m_values[f][row]);
+            m_newTails.append(tail);
+        }
+        m_tailRefs[row] = id;
+        valid_rows++;
+    }
+
+    m_report.rowsImported += valid_rows;
+    m_report.rowsSkipped += m_rows - valid_rows;
+    m_report.newPilots += m_newPilots.size();
+    m_report.newTails += m_newTails.size();
+    m_report.stages[Resolve].nsecs += timer.nsecsElapsed();
+    m_report.stages[Resolve].items += m_rows;
+}
+
+bool Importer::insert()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const auto exec_batch = [this](QSqlQuery &query, const QVector<QVariantList> &columns) {
+        for (const auto &values : columns)
+            query.addBindValue(values);
+        if (!query.execBatch()) {
+            m_errorString = query.lastError().text();
+            return false;
+        }
+        return true;
+    };
+    // transposes rows to the column lists required by execBatch()
+    const auto to_columns = [](const QVector<QVariantList> &rows) {
+        QVector<QVariantList> columns(rows.first().size());
+        for (auto &column : columns)
+            column.reserve(rows.size());
+        for (const auto &row : rows)
+            for (int c = 0; c < row.size(); c++)
+                columns[c].append(row[c]);
+        return columns;
+    };
+
+    // pilots and tails have to be inserted first to satisfy the foreign key constraints
+    if (!m_newPilots.isEmpty() && !exec_batch(m_pilotQuery, to_columns(m_newPilots)))
+        return false;
+    if (!m_newTails.isEmpty() && !exec_batch(m_tailQuery, to_columns(m_newTails)))
+        return false;
+
+    // collect the values of the valid rows
+    const auto valid_values = [this](const QVariantList &values) {
+        QVariantList column;
+        column.reserve(m_rows);
+        for (int row = 0; row < m_rows; row++)
+            if (m_valid[row])
+                column.append(values[row]);
+        return column;
+    };
+    QVector<QVariantList> flight_columns;
+    for (const auto f : std::as_const(m_flightFields))
+        flight_columns.append(valid_values(m_values[f]));
+    for (int i = 0; i < 3; i++)
+        if (m_pilotSlots[i].nameField != -1)
+            flight_columns.append(valid_values(m_pilotRefs[i]));
+    flight_columns.append(valid_values(m_tailRefs));
+
+    const qsizetype flights = flight_columns.last().size();
+    if (flights > 0 && !exec_batch(m_flightQuery, flight_columns))
+        return false;
+
+    m_report.stages[Insert].nsecs += timer.nsecsElapsed();
+    m_report.stages[Insert].items += m_newPilots.size() + m_newTails.size() + flights;
+    return true;
+}
+
+void Importer::addError(int row, int field, const QString &message)
+{
+    m_report.errorCount++;
+    if (m_report.errors.size() >= MAX_REPORTED_ERRORS)
+        return;
+
+    const FieldSpec &spec = m_format.fields[field];
+    const QString column = spec.source.header.isEmpty() ? QStringLiteral("Column %1").arg(spec.source.index + 1)
+                                                        : spec.source.header;
+    m_report.errors.append({m_lines[row], column, m_raw[field][row], message});
+}
+
+void Importer::logReport() const
+{
+    for (const auto &stage : m_report.stages) {
+        const double msecs = stage.nsecs / 1e6;
+        const double throughput = stage.nsecs > 0 ? stage.items * 1e9 / stage.nsecs : 0.0;
+        LOG << m_format.name << "-" << stage.name << ":" << msecs << "ms," << stage.items << "items,"
+            << qRound64(throughput) << "items/s";
+    }
+    LOG << m_format.name << "-" << m_report.rowsImported << "of" << m_report.rowsRead << "rows imported,"
+        << m_report.newPilots << "new pilots," << m_report.newTails << "new tails,"
+        << m_report.errorCount << "errors";
+}
+
+} // namespace OPL::Import
@@ -0,0 +1,164 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef IMPORTER_H
+#define IMPORTER_H
+#include <QtCore>
+#include <QSqlQuery>
+#include "src/import/importspec.h"
+#include "src/functions/csvreader.h"
+
+namespace OPL::Import {
+
+/*!
+ * \brief A value of the source file which could not be imported
+ */
+struct ValidationError {
+    int line;       // the line in the source file
+    QString field;
+    QString value;
+    QString message;
+};
+
+/*!
+ * \brief The result of an import
+ */
+struct ImportReport {
+    struct Stage {
+        const char *name;
+        qint64 nsecs = 0;
+        qint64 items = 0;
+    };
+
+    int rowsRead = 0;
+    int rowsImported = 0;
+    int rowsSkipped = 0;
+    int newPilots = 0;
+    int newTails = 0;
+    int errorCount = 0;
+    QVector<ValidationError> errors;
+    std::array<Stage, 4> stages = {{{"parse"}, {"normalise"}, {"resolve"}, {"insert"}}};
+};
+
+/*!
+ * \brief The Importer class imports the logbook export of a third-party application described by a FormatSpec.
+ *
+ * \details The source file is processed in chunks of CHUNK_SIZE rows, so that memory use does not depend
+ * on the size of the file. Every chunk passes through the following stages:
+ *
+ * 1. Parse - the mapped columns are read from the CSV file
+ * 2. Normalise - the values are converted to the database format and validated. The columns of a chunk
+ * are converted in parallel.
+ * 3. Resolve - pilots and tails are deduplicated. Known pilots and tails are mapped to their id in the
+ * database, new ones are given an id.
+ * 4. Insert - new pilots, tails and the flights are written in batches
+ *
+ * All chunks are written in a single exclusive transaction, which is rolled back if any step fails. Rows with
+ * missing or invalid mandatory values are skipped. Every invalid value is reported in the ImportReport.
+ *
+ * In dry run mode, the first three stages are run and the report shows what would be imported, without
+ * changing the database.
+ */
+class Importer
+{
+public:
+    Importer(const FormatSpec &format, const QString &file_path);
+
+    /*!
+     * \brief In dry run mode, the source file is validated but nothing is written to the database.
+     */
+    void setDryRun(bool dry_run) { m_dryRun = dry_run; }
+
+    /*!
+     * \brief Runs the import
+     * \return true on success, otherwise errorString() contains a description of the error
+     */
+    bool exec();
+
+    const ImportReport &report() const { return m_report; }
+    const QString &errorString() const { return m_errorString; }
+
+    /*!
+     * \brief Only the first MAX_REPORTED_ERRORS validation errors are kept in the report.
+     */
+    static constexpr int MAX_REPORTED_ERRORS = 1000;
+
+private:
+    /*!
+     * \brief The fields of a Target which refers to a pilot
+     */
+    struct PilotSlot {
+        QString reference;          // the column in the flights table
+        int nameField = -1;
+        QVector<int> columnFields;  // the field for each of m_pilotColumns, or -1
+    };
+
+    enum Stage {Parse, Normalise, Resolve, Insert};
+    static constexpr int CHUNK_SIZE = 4096;
+
+    FormatSpec m_format;
+    CSV::Reader m_reader;
+    bool m_dryRun = false;
+    ImportReport m_report;
+    QString m_errorString;
+    QThreadPool m_threadPool;
+
+    // the mapping of the source file
+    QVector<int> m_sourceColumns;
+    QVector<int> m_flightFields;
+    std::array<PilotSlot, 3> m_pilotSlots;
+    QStringList m_pilotColumns;
+    QVector<int> m_tailFields;
+    int m_tailKeyField = -1;
+
+    // dimension lookups
+    QHash<QString, int> m_pilotIds;
+    QHash<QString, int> m_tailIds;
+    int m_nextPilotId = 1;
+    int m_nextTailId = 1;
+
+    // the current chunk, stored by field
+    int m_line = 0;
+    int m_rows = 0;
+    QVector<int> m_lines;
+    QVector<QStringList> m_raw;
+    QVector<QVariantList> m_values;
+    QVector<bool> m_valid;
+    std::array<QVariantList, 3> m_pilotRefs;
+    QVariantList m_tailRefs;
+    QVector<QVariantList> m_newPilots;
+    QVector<QVariantList> m_newTails;
+
+    QSqlQuery m_pilotQuery;
+    QSqlQuery m_tailQuery;
+    QSqlQuery m_flightQuery;
+
+    bool mapColumns(const CSV::Reader::Row &header);
+    void loadDimensions();
+    static QString pilotKey(const QString &name);
+    bool prepareStatements();
+    int parse();
+    void normalise();
+    void resolve();
+    bool insert();
+    void addError(int row, int field, const QString &message);
+    void logReport() const;
+};
+
+} // namespace OPL::Import
+
+#endif // IMPORTER_H
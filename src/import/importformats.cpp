@@ -0,0 +1,96 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "importformats.h"
+#include "src/database/flightentry.h"
+#include "src/database/pilotentry.h"
+#include "src/database/tailentry.h"
+
+namespace OPL::Import::Formats {
+
+FormatSpec crewLounge()
+{
+    using F = OPL::FlightEntry;
+    using P = OPL::PilotEntry;
+    using T = OPL::TailEntry;
+
+    FormatSpec spec;
+    spec.name = QStringLiteral("CrewLounge");
+    spec.dateFormat = QStringLiteral("dd/MM/yyyy");
+    spec.durationFormat = DurationFormat::Minutes;
+    spec.nameOrder = NameOrder::LastFirst;
+    spec.fields = {
+        // source, target, database column, type, mandatory
+        {0,  Target::Flight, F::DOFT,           FieldType::Date,     true},
+        {3,  Target::Flight, F::FLIGHTNUMBER,   FieldType::Text},
+        {5,  Target::Flight, F::DEPT,           FieldType::Text,     true},
+        {7,  Target::Flight, F::DEST,           FieldType::Text,     true},
+        {9,  Target::Flight, F::TOFB,           FieldType::Time,     true},
+        {11, Target::Flight, F::TONB,           FieldType::Time,     true},
+        {17, Target::Flight, F::TBLK,           FieldType::Duration, true},
+        {19, Target::Flight, F::TPIC,           FieldType::Duration},
+        {20, Target::Flight, F::TSIC,           FieldType::Duration},
+        {21, Target::Flight, F::TDUAL,          FieldType::Duration},
+        {22, Target::Flight, F::TPICUS,         FieldType::Duration},
+        {23, Target::Flight, F::TFI,            FieldType::Duration},
+        {25, Target::Flight, F::TNIGHT,         FieldType::Duration},
+        {53, Target::Flight, F::TODAY,          FieldType::Integer},
+        {54, Target::Flight, F::TONIGHT,        FieldType::Integer},
+        {55, Target::Flight, F::LDGDAY,         FieldType::Integer},
+        {56, Target::Flight, F::LDGNIGHT,       FieldType::Integer},
+        {58, Target::Flight, F::PILOTFLYING,    FieldType::Boolean},
+        {60, Target::Flight, F::APPROACHTYPE,   FieldType::Text},
+        {64, Target::Flight, F::REMARKS,        FieldType::Text},
+
+        {37, Target::Pic,         P::EMPLOYEEID, FieldType::Text},
+        {38, Target::Pic,         P::LASTNAME,   FieldType::Name,    true},
+        {39, Target::Pic,         P::PHONE,      FieldType::Text},
+        {40, Target::Pic,         P::EMAIL,      FieldType::Text},
+        {41, Target::SecondPilot, P::EMPLOYEEID, FieldType::Text},
+        {42, Target::SecondPilot, P::LASTNAME,   FieldType::Name},
+        {43, Target::SecondPilot, P::PHONE,      FieldType::Text},
+        {44, Target::SecondPilot, P::EMAIL,      FieldType::Text},
+        {45, Target::ThirdPilot,  P::EMPLOYEEID, FieldType::Text},
+        {46, Target::ThirdPilot,  P::LASTNAME,   FieldType::Name},
+        {47, Target::ThirdPilot,  P::PHONE,      FieldType::Text},
+        {48, Target::ThirdPilot,  P::EMAIL,      FieldType::Text},
+
+        {79, Target::Tail, T::REGISTRATION, FieldType::Text,    true},
+        {36, Target::Tail, T::COMPANY,      FieldType::Text},
+        {76, Target::Tail, T::MAKE,         FieldType::Text},
+        {77, Target::Tail, T::MODEL,        FieldType::Text},
+        {78, Target::Tail, T::VARIANT,      FieldType::Text},
+        {83, Target::Tail, T::MULTI_PILOT,  FieldType::Boolean},
+        {84, Target::Tail, T::MULTI_ENGINE, FieldType::Boolean},
+        // other values need to be added as needed
+        {92, Target::Tail, T::ENGINE_TYPE,  FieldType::Enum,    false,
+         {{QStringLiteral("Piston"), 1}, {QStringLiteral("Turbine (jet-fan)"), 3}}},
+        // this is a above 7.5t switch in MCC, so default to medium for now
+        {96, Target::Tail, T::WEIGHT_CLASS, FieldType::Boolean},
+    };
+    return spec;
+}
+
+const QVector<FormatSpec> &all()
+{
+    static const QVector<FormatSpec> formats = {
+        crewLounge(),
+    };
+    return formats;
+}
+
+} // namespace OPL::Import::Formats
@@ -0,0 +1,41 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef IMPORTFORMATS_H
+#define IMPORTFORMATS_H
+#include "src/import/importspec.h"
+
+/*!
+ * \brief The specifications of the logbook formats which can be imported.
+ *
+ * \details To support a new format, add a function returning its FormatSpec and list it in all().
+ */
+namespace OPL::Import::Formats {
+
+/*!
+ * \brief The CSV export of CrewLounge PILOTLOG
+ */
+FormatSpec crewLounge();
+
+/*!
+ * \brief Returns all supported formats
+ */
+const QVector<FormatSpec> &all();
+
+} // namespace OPL::Import::Formats
+
+#endif // IMPORTFORMATS_H
@@ -0,0 +1,100 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef IMPORTSPEC_H
+#define IMPORTSPEC_H
+#include <QtCore>
+
+namespace OPL::Import {
+
+/*!
+ * \brief How the value of a source column is converted to the database format
+ * \details
+ * <ul>
+ * <li> Text - the trimmed string </li>
+ * <li> Name - the name of a person, used to identify pilots. Split into first and last name on import. </li>
+ * <li> Date - a date in FormatSpec::dateFormat, stored as julian day </li>
+ * <li> Time - a time of day (h:mm or hh:mm), stored as minutes since midnight </li>
+ * <li> Duration - a duration in FormatSpec::durationFormat, stored as minutes </li>
+ * <li> Integer - an integer number </li>
+ * <li> Boolean - 1 if the value is one of FormatSpec::trueValues, otherwise 0 </li>
+ * <li> Enum - an integer looked up in FieldSpec::values </li>
+ * </ul>
+ */
+enum class FieldType {Text, Name, Date, Time, Duration, Integer, Boolean, Enum};
+
+/*!
+ * \brief The table a field is written to. Pilots are referenced by the flight as pic, secondPilot and
+ * thirdPilot, the tail as acft.
+ */
+enum class Target {Flight, Pic, SecondPilot, ThirdPilot, Tail};
+
+/*!
+ * \brief How durations are given in the source file
+ */
+enum class DurationFormat {Minutes, HoursMinutes, DecimalHours};
+
+/*!
+ * \brief The order in which the parts of a name are given in the source file
+ */
+enum class NameOrder {LastFirst, FirstLast};
+
+/*!
+ * \brief Identifies a column of the source file either by its header or by its index.
+ * \details Source formats which have stable headers should use the header, since the
+ * column order of an export may change between versions of the source application.
+ */
+struct Column {
+    Column(const char *header) : header(QString::fromLatin1(header)) {}
+    Column(int index) : index(index) {}
+
+    QString header;
+    int index = -1;
+};
+
+/*!
+ * \brief Maps one column of the source file to a column in the database
+ */
+struct FieldSpec {
+    Column source;
+    Target target;
+    QString field;                  // the column name in the target table
+    FieldType type;
+    bool mandatory = false;
+    QHash<QString, int> values = {}; // only used for FieldType::Enum
+};
+
+/*!
+ * \brief Declares how a logbook export of a third-party application is imported
+ * \details Every field of a pilot target with FieldType::Name identifies the pilot. Pilots with the same
+ * name are only created once and existing pilots are re-used. The tail is identified by the field
+ * mapped to the registration column in the same way.
+ */
+struct FormatSpec {
+    QString name;
+    QString dateFormat = QStringLiteral("yyyy-MM-dd");
+    DurationFormat durationFormat = DurationFormat::Minutes;
+    NameOrder nameOrder = NameOrder::LastFirst;
+    QStringList trueValues = {QStringLiteral("TRUE"), QStringLiteral("1")};
+    // the name used in the source file for the logbook owner
+    QString selfName = QStringLiteral("SELF");
+    QVector<FieldSpec> fields;
+};
+
+} // namespace OPL::Import
+
+#endif // IMPORTSPEC_H
@@ -2,6 +2,8 @@
 
 namespace OPL {
 
+Q_LOGGING_CATEGORY(logCategory, "opl")
+
 void OplGlobals::fillLanguageComboBox(QComboBox *combo_box) const
 {
     QSignalBlocker blocker(combo_box);
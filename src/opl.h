@@ -59,9 +59,17 @@ namespace OPL {
     #define FUNC_IDENT __func__
 #endif
 
-#define DEB qDebug()                            // Use for debugging
-#define LOG qInfo()                             // Use for logging milestones (silently, will be written to log file and console out only)
-#define TODO qCritical() << "TO DO:\t"
+/*!
+ * \brief The logging category of the DEB, LOG and TODO macros ("opl")
+ * \details The macros check if their message type is enabled for the category before the arguments
+ * are evaluated, so disabled messages cost a single branch. Debug output can be compiled out entirely
+ * with the OPL_DEBUG_LOGGING build option. See OPL::Log::setCategoryLevel() to set the level at runtime.
+ */
+Q_DECLARE_LOGGING_CATEGORY(logCategory)
+
+#define DEB qCDebug(OPL::logCategory)           // Use for debugging
+#define LOG qCInfo(OPL::logCategory)            // Use for logging milestones (silently, will be written to log file and console out only)
+#define TODO qCCritical(OPL::logCategory) << "TO DO:\t"
 
 #define INFO(msg) OPL::ANotificationHandler::info(msg, this)  // Use for messages of interest to the user (will be displayed in GUI)
 #define WARN(msg) OPL::ANotificationHandler::warn(msg, this)  // Use for warnings (will be displayed in GUI)
@@ -325,8 +333,7 @@ Q_GLOBAL_STATIC(OplGlobals, GLOBALS)
 namespace Assets {
 
 const inline auto  DATABASE_SCHEMA               = QStringLiteral(":/database/database_schema.sql");
-const inline auto  DATABASE_TEMPLATE_AIRCRAFT    = QStringLiteral(":/database/templates/aircraft.json");
-const inline auto  DATABASE_TEMPLATE_AIRPORT     = QStringLiteral(":/database/templates/airports.json");
+const inline auto  DATABASE_TEMPLATES            = QStringLiteral(":/database/templates.db");
 
 const inline auto  LOGO                          = QStringLiteral(":/icons/opl-icons/logos/logo_text.png");
 const inline auto  ICON_MAIN                     = QStringLiteral(":/icons/opl-icons/app/icon_main.png");
@@ -21,7 +21,7 @@
 
 ATimer::ATimer(QObject *parent) : QObject(parent)
 {
-     start = std::chrono::high_resolution_clock::now();
+     start = OPL::Trace::Clock::now();
      if(parent == nullptr) {
          DEB << "Starting Timer... ";
      } else {
@@ -32,7 +32,10 @@ ATimer::ATimer(QObject *parent) : QObject(parent)
 
 ATimer::~ATimer()
 {
-    stop = std::chrono::high_resolution_clock::now();
+    stop = OPL::Trace::Clock::now();
+    if (OPL::Trace::isEnabled())
+        OPL::Trace::addEvent(parent() == nullptr ? "ATimer" : parent()->metaObject()->className(),
+                             "timer", start, stop);
     if(parent() == nullptr) {
         DEB << "Execution time: "
                  << std::chrono::duration_cast<std::chrono::milliseconds>(stop - start).count()
@@ -46,7 +49,7 @@ ATimer::~ATimer()
 
 long ATimer::timeNow()
 {
-    intermediate_point = std::chrono::high_resolution_clock::now();
+    intermediate_point = OPL::Trace::Clock::now();
     if(parent() == nullptr) {
         DEB << "Intermediate time: "
                  << std::chrono::duration_cast<std::chrono::milliseconds>(intermediate_point - start).count()
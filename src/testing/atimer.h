@@ -21,6 +21,7 @@
 #include <QObject>
 #include <chrono>
 #include <QDebug>
+#include "src/testing/trace.h"
 
 /*!
  * \brief The ATimer class provides an easy to use performance timer.
@@ -30,6 +31,9 @@
  *
  * It can be given a QObject as a parent to time its lifetime or can be used without
  * parent in any context.
+ *
+ * While tracing is enabled, the timed scope is also recorded as an event named after the
+ * parent's class, see OPL::Trace.
  */
 class ATimer : public QObject
 {
@@ -44,11 +48,11 @@ public:
     long timeNow();
 private:
 
-    std::chrono::high_resolution_clock::time_point start;
+    OPL::Trace::Clock::time_point start;
 
-    std::chrono::high_resolution_clock::time_point intermediate_point;
+    OPL::Trace::Clock::time_point intermediate_point;
 
-    std::chrono::high_resolution_clock::time_point stop;
+    OPL::Trace::Clock::time_point stop;
 
     double duration;
 
@@ -0,0 +1,456 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "benchmarks.h"
+#include "src/opl.h"
+#include "src/classes/time.h"
+#include "src/classes/datetimeformatter.h"
+#include "src/classes/completionindex.h"
+#include "src/functions/datetimeparser.h"
+#include "src/functions/calc.h"
+#include "src/functions/statistics.h"
+#include "src/database/database.h"
+#include "src/database/databasecache.h"
+#include "src/database/flightstore.h"
+#include "src/database/flightpredictor.h"
+#include "src/database/airportindex.h"
+#include "src/database/csvexporttask.h"
+#include "src/database/views/logbookviewinfo.h"
+#include "src/classes/paths.h"
+#include "src/import/importer.h"
+#include "src/import/importformats.h"
+#include <QSqlTableModel>
+
+namespace OPL::Benchmarks {
+
+// a category with debug output disabled, like the "opl" category in production
+Q_LOGGING_CATEGORY(disabledCategory, "opl.benchmark", QtInfoMsg)
+
+QJsonObject Result::toJson() const
+{
+    QJsonObject object = {
+        {QStringLiteral("name"), name},
+        {QStringLiteral("iterations"), iterations},
+        {QStringLiteral("nsecs"), nsecs},
+        {QStringLiteral("nsecsPerIteration"), nsecsPerIteration()},
+    };
+    if (allocations >= 0) {
+        object.insert(QStringLiteral("allocations"), allocations);
+        object.insert(QStringLiteral("allocationsPerIteration"), allocationsPerIteration());
+    }
+    return object;
+}
+
+/*!
+ * \brief Runs function repetitions times and returns the elapsed time
+ */
+template <typename Function>
+static Result repeat(const QString &name, int repetitions, Function function)
+{
+    const qint64 allocations = allocationCount.load(std::memory_order_relaxed);
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < repetitions; i++)
+        function();
+    Result result{name, repetitions, timer.nsecsElapsed()};
+    if (allocationCountingEnabled)
+        result.allocations = allocationCount.load(std::memory_order_relaxed) - allocations;
+    return result;
+}
+
+/*!
+ * \brief Runs function for every input and returns the elapsed time. The results are summed up and
+ * returned in checksum, so that the compiler can not optimise the calls away.
+ */
+template <typename Function>
+static Result run(const QString &name, const QStringList &inputs, qint64 &checksum, Function function)
+{
+    QElapsedTimer timer;
+    timer.start();
+    for (const auto &input : inputs)
+        checksum += function(input);
+    return {name, inputs.size(), timer.nsecsElapsed()};
+}
+
+QVector<Result> dateTimeParsing(int iterations)
+{
+    // generate the inputs up front, so that only the parsing is measured
+    QStringList dates;
+    QStringList times;
+    dates.reserve(iterations);
+    times.reserve(iterations);
+    const QDate start(2000, 1, 1);
+    for (int i = 0; i < iterations; i++) {
+        dates.append(start.addDays(i % 10000).toString(QStringLiteral("dd/MM/yyyy")));
+        times.append(QTime(i % 24, i % 60).toString(QStringLiteral("h:mm")));
+    }
+
+    using Layout = DateTimeParser::DateLayout;
+    const DateTimeFormat format;
+    qint64 checksum = 0;
+    QVector<Result> results;
+    results.append(run(QStringLiteral("date/QDate::fromString"), dates, checksum, [](const QString &input) {
+        return QDate::fromString(input, QStringLiteral("dd/MM/yyyy")).toJulianDay();
+    }));
+    results.append(run(QStringLiteral("date/DateTimeParser::julianDay"), dates, checksum, [](const QString &input) {
+        return qint64(DateTimeParser::julianDay(input, Layout::DayMonthYear));
+    }));
+    results.append(run(QStringLiteral("time/QTime::fromString"), times, checksum, [](const QString &input) {
+        const QTime time = QTime::fromString(input, QStringLiteral("h:mm"));
+        return qint64(time.hour() * 60 + time.minute());
+    }));
+    results.append(run(QStringLiteral("time/DateTimeParser::minutesOfDay"), times, checksum, [](const QString &input) {
+        return qint64(DateTimeParser::minutesOfDay(input));
+    }));
+    results.append(run(QStringLiteral("time/Time::fromString"), times, checksum, [&format](const QString &input) {
+        return qint64(Time::fromString(input, format).toMinutes());
+    }));
+
+    DEB << "Checksum:" << checksum;
+    return results;
+}
+
+QVector<Result> dateTimeFormatting(int iterations)
+{
+    const QDate start(2000, 1, 1);
+    const int first_day = start.toJulianDay();
+    const DateTimeFormatter formatter;
+    qint64 checksum = 0;
+    QVector<Result> results;
+
+    results.append(repeat(QStringLiteral("format/date/QDate::toString"), iterations, [&, i = 0]() mutable {
+        checksum += QDate::fromJulianDay(first_day + i++ % 10000).toString(Qt::ISODate).size();
+    }));
+    results.append(repeat(QStringLiteral("format/date/DateTimeFormatter::dateString"), iterations, [&, i = 0]() mutable {
+        checksum += formatter.dateString(first_day + i++ % 10000).size();
+    }));
+    results.append(repeat(QStringLiteral("format/date/DateTimeFormatter::formatDate"), iterations, [&, i = 0]() mutable {
+        DateTimeFormatter::Buffer buffer;
+        checksum += formatter.formatDate(first_day + i++ % 10000, buffer).size();
+    }));
+    results.append(repeat(QStringLiteral("format/time/QTime::toString"), iterations, [&, i = 0]() mutable {
+        checksum += QTime(i % 24, i % 60).toString(QStringLiteral("hh:mm")).size();
+        i++;
+    }));
+    results.append(repeat(QStringLiteral("format/time/DateTimeFormatter::timeString"), iterations, [&, i = 0]() mutable {
+        checksum += formatter.timeString(i++ % 1440).size();
+    }));
+    results.append(repeat(QStringLiteral("format/time/DateTimeFormatter::formatTime"), iterations, [&, i = 0]() mutable {
+        DateTimeFormatter::Buffer buffer;
+        checksum += formatter.formatTime(i++ % 1440, buffer).size();
+    }));
+
+    DEB << "Checksum:" << checksum;
+    return results;
+}
+
+QVector<Result> logging(int iterations)
+{
+    const QVariantList bound_values = {42, QStringLiteral("EDDF"), QStringLiteral("KJFK"), 660, 1140, QVariant()};
+    QVector<Result> results;
+    QElapsedTimer timer;
+
+    timer.start();
+    for (int i = 0; i < iterations; i++)
+        qCDebug(disabledCategory) << "Bound values: " << bound_values << i;
+    results.append({QStringLiteral("log/disabled category"), iterations, timer.nsecsElapsed()});
+
+    qint64 checksum = 0;
+    timer.restart();
+    for (int i = 0; i < iterations; i++) {
+        QString message;
+        QDebug(&message) << "Bound values: " << bound_values << i;
+        checksum += message.size();
+    }
+    results.append({QStringLiteral("log/formatted and discarded"), iterations, timer.nsecsElapsed()});
+
+    DEB << "Checksum:" << checksum;
+    return results;
+}
+
+QVector<Result> hotPaths(int repetitions, int commits)
+{
+    QVector<Result> results;
+
+    // the cache is initialised once, afterwards its tables are refreshed whenever they are updated
+    results.append(repeat(QStringLiteral("cache/init"), 1, [] { DBCache->init(); }));
+    results.append(repeat(QStringLiteral("cache/refresh"), repetitions, [] {
+        for (const auto table : {DbTable::Pilots, DbTable::Tails, DbTable::Airports, DbTable::Aircraft})
+            DBCache->onDatabaseUpdated(table);
+    }));
+
+    // completing airport codes the way QCompleter with Qt::MatchContains did it and with the completion index
+    const QStringList &airports = DBCache->getAirportList();
+    const QStringList inputs = {QStringLiteral("e"), QStringLiteral("ed"), QStringLiteral("edd"), QStringLiteral("eddf"),
+                                QStringLiteral("fra"), QStringLiteral("edfd"), QStringLiteral("kjf"), QStringLiteral("lhr")};
+    qint64 completions = 0;
+    results.append(repeat(QStringLiteral("completion/contains"), repetitions, [&] {
+        for (const auto &input : inputs)
+            completions += airports.filter(input, Qt::CaseInsensitive).size();
+    }));
+    CompletionIndex index;
+    results.append(repeat(QStringLiteral("completion/index/build"), 1, [&] { index.build(airports); }));
+    results.append(repeat(QStringLiteral("completion/index/complete"), repetitions, [&] {
+        for (const auto &input : inputs)
+            completions += index.complete(input).size();
+    }));
+    DEB << "Completions:" << completions;
+
+    results.append(repeat(QStringLiteral("statistics/getTotals"), repetitions, [] { DB->getTotals(true); }));
+    results.append(repeat(QStringLiteral("statistics/totals"), repetitions, [] { Statistics::totals(); }));
+    results.append(repeat(QStringLiteral("currency/takeOffLanding"), repetitions, [] {
+        Statistics::countTakeOffLanding(90);
+        Statistics::currencyTakeOffLandingExpiry(90);
+    }));
+    results.append(repeat(QStringLiteral("currency/totalTime"), repetitions, [] {
+        Statistics::totalTime(Statistics::TimeFrame::Rolling28Days);
+        Statistics::totalTime(Statistics::TimeFrame::Rolling12Months);
+    }));
+
+    // the same questions answered by the columnar flight store instead of SQL
+    results.append(repeat(QStringLiteral("flightstore/load"), 1, [] {
+        FlightStore::instance()->init();
+        FlightStore::instance()->flightCount();
+    }));
+    results.append(repeat(QStringLiteral("flightstore/getTotals"), repetitions, [] { DB->getTotals(true); }));
+    results.append(repeat(QStringLiteral("flightstore/totals"), repetitions, [] { Statistics::totals(); }));
+    results.append(repeat(QStringLiteral("flightstore/takeOffLanding"), repetitions, [] {
+        Statistics::countTakeOffLanding(90);
+        Statistics::currencyTakeOffLandingExpiry(90);
+    }));
+    results.append(repeat(QStringLiteral("flightstore/totalTime"), repetitions, [] {
+        Statistics::totalTime(Statistics::TimeFrame::Rolling28Days);
+        Statistics::totalTime(Statistics::TimeFrame::Rolling12Months);
+    }));
+
+    // predict a new flight the way the flight entry dialog does when it is opened
+    const int today = QDate::currentDate().toJulianDay();
+    results.append(repeat(QStringLiteral("predictor/build"), 1, [today] {
+        FlightPredictor::instance()->init();
+        FlightPredictor::instance()->predict(today);
+    }));
+    results.append(repeat(QStringLiteral("predictor/predict"), repetitions, [today] {
+        const auto prediction = FlightPredictor::instance()->predict(today);
+        FlightPredictor::instance()->predict(today, prediction.departure, prediction.destination);
+    }));
+
+    // resolve positions close to airports with a linear scan and with the airport index
+    const auto &coordinates = DBCache->getAirportCoordinatesMap();
+    QVector<Coordinates> positions;
+    for (auto it = coordinates.cbegin(); it != coordinates.cend() && positions.size() < 100; ++it)
+        positions.append({it.value().lat + 0.1, it.value().lon + 0.1});
+    qint64 resolved = 0;
+    results.append(repeat(QStringLiteral("airportindex/scan"), repetitions, [&] {
+        for (const auto &position : positions) {
+            int nearest_id = 0;
+            double nearest_distance = std::numeric_limits<double>::max();
+            for (auto it = coordinates.cbegin(); it != coordinates.cend(); ++it) {
+                const double distance = Calc::greatCircleDistance(position.lat, position.lon, it.value().lat, it.value().lon);
+                if (distance < nearest_distance) {
+                    nearest_distance = distance;
+                    nearest_id = it.key();
+                }
+            }
+            resolved += nearest_id;
+        }
+    }));
+    results.append(repeat(QStringLiteral("airportindex/build"), 1, [] { AirportIndex::instance()->size(); }));
+    results.append(repeat(QStringLiteral("airportindex/nearest"), repetitions, [&] {
+        for (const auto &position : positions)
+            resolved += AirportIndex::instance()->nearest(position).value(0).airportId;
+    }));
+    results.append(repeat(QStringLiteral("airportindex/radius"), repetitions, [&] {
+        for (const auto &position : positions)
+            resolved += AirportIndex::instance()->withinRadius(position, 50).size();
+    }));
+    results.append(repeat(QStringLiteral("airportindex/corridor"), repetitions, [&] {
+        for (int i = 1; i < positions.size(); i++)
+            resolved += AirportIndex::instance()->alongRoute(positions.at(i - 1), positions.at(i), 20).size();
+    }));
+    DEB << "Resolved:" << resolved;
+
+    // aggregate distances from the cached city pair metrics, with and without the flight store
+    results.append(repeat(QStringLiteral("routemetrics/first"), 1, [] { Statistics::distancePerYear(); }));
+    results.append(repeat(QStringLiteral("routemetrics/distancePerYear"), repetitions, [] { Statistics::distancePerYear(); }));
+    results.append(repeat(QStringLiteral("routemetrics/distancePerType"), repetitions, [] { Statistics::distancePerType(); }));
+    results.append(repeat(QStringLiteral("routemetrics/longestSector"), repetitions, [] { Statistics::longestSector(); }));
+
+    // select the logbook views the way the logbook widget does and fetch all rows
+    for (const auto view : {LogbookView::Default, LogbookView::Easa}) {
+        const QString view_name = GLOBALS->getViewIdentifier(view);
+        results.append(repeat(QStringLiteral("view/") + view_name, repetitions, [&view_name] {
+            QSqlTableModel model(nullptr, DB->database());
+            model.setTable(view_name);
+            model.select();
+            while (model.canFetchMore())
+                model.fetchMore();
+        }));
+    }
+
+    QTemporaryDir export_dir;
+    const QString database_path = Paths::databaseFileInfo().absoluteFilePath();
+    results.append(repeat(QStringLiteral("export/csv"), 1, [&] {
+        using Format = CsvExportTask::ColumnFormat;
+        const auto view = LogbookView::Default;
+        CsvExportTask task(database_path, GLOBALS->getViewIdentifier(view), export_dir.filePath(QStringLiteral("export.csv")));
+        task.setHeaders(LogbookViewInfo::getTableHeaders(view));
+        task.setColumnFormat(LogbookViewInfo::getDateColumn(view), Format::Date);
+        task.setColumnFormat(LogbookViewInfo::getPicColumn(view), Format::PilotName);
+        task.setColumnFormat(LogbookViewInfo::getTypeColumn(view), Format::AircraftType);
+        for (const auto column : LogbookViewInfo::getTimeColumns(view))
+            task.setColumnFormat(column, Format::Time);
+        if (!task.run())
+            LOG << "CSV export failed:" << task.errorString();
+    }));
+
+    results.append(repeat(QStringLiteral("calc/updateNightTimes"), 1, [] { Calc::updateNightTimes(); }));
+
+    // commit copies of the latest flight, one by one as the flight entry dialog does
+    const int last_flight = DB->getLastEntry(DbTable::Flights);
+    RowData_T flight_data = DB->getFlightEntry(last_flight).getData();
+    flight_data.remove(FlightEntry::ROWID);
+    results.append(repeat(QStringLiteral("database/commit"), commits, [&flight_data] {
+        DB->commit(FlightEntry(flight_data));
+    }));
+
+    // update the night time of a flight the way it used to be done, by copying the row data and writing it back...
+    int night_time = 0;
+    results.append(repeat(QStringLiteral("database/update/copy"), commits, [last_flight, &night_time] {
+        auto flight = DB->getFlightEntry(last_flight);
+        auto data = flight.getData();
+        data.insert(FlightEntry::TNIGHT, ++night_time % 60);
+        flight.setData(data);
+        DB->commit(flight);
+    }));
+    // ...and by committing only the modified column
+    results.append(repeat(QStringLiteral("database/update/inPlace"), commits, [last_flight, &night_time] {
+        DB->commit(FlightEntry(last_flight, {{FlightEntry::TNIGHT, ++night_time % 60}}));
+    }));
+
+    return results;
+}
+
+/*!
+ * \brief Writes a CrewLounge logbook export with the given number of flights to file_path
+ * \details The flights rotate through a small set of airports, pilots and tails, so that the resolve
+ * stage mostly finds known pilots and tails like it does in a real logbook.
+ */
+static bool writeCrewLoungeFile(const QString &file_path, int rows)
+{
+    static constexpr int COLUMNS = 97;
+    const QStringList airports = {QStringLiteral("EDDF"), QStringLiteral("EGLL"), QStringLiteral("LFPG"),
+                                  QStringLiteral("LEMD"), QStringLiteral("EHAM"), QStringLiteral("LSZH"),
+                                  QStringLiteral("LOWW"), QStringLiteral("EKCH")};
+    const QStringList pilots = {QStringLiteral("Miller Anna"), QStringLiteral("Schmidt Peter"),
+                                QStringLiteral("Dubois Claire"), QStringLiteral("Garcia Luis"),
+                                QStringLiteral("Jansen Eva"), QStringLiteral("Rossi Marco")};
+    const QStringList registrations = {QStringLiteral("D-AIAA"), QStringLiteral("D-AIAB"), QStringLiteral("D-AIAC"),
+                                       QStringLiteral("D-AIAD"), QStringLiteral("D-AIAE")};
+
+    QFile file(file_path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+        return false;
+    QTextStream out(&file);
+
+    QStringList values(COLUMNS);
+    for (int i = 0; i < COLUMNS; i++)
+        values[i] = QStringLiteral("Column%1").arg(i + 1);
+    out << values.join(QLatin1Char(',')) << '\n';
+
+    const QDate start(2000, 1, 1);
+    const QTime midnight(0, 0);
+    for (int i = 0; i < rows; i++) {
+        values.fill(QString());
+        const int block_time = 60 + (i * 37) % 420;
+        const int off_block = (i * 53) % 1440;
+        const bool pic = i % 2 == 0;
+        const QString block = QString::number(block_time);
+        values[0] = start.addDays(i / 3).toString(QStringLiteral("dd/MM/yyyy"));
+        values[3] = QStringLiteral("OPL%1").arg(100 + i % 900);
+        values[5] = airports.at(i % airports.size());
+        values[7] = airports.at((i + 1) % airports.size());
+        values[9] = midnight.addSecs(off_block * 60).toString(QStringLiteral("hh:mm"));
+        values[11] = midnight.addSecs(((off_block + block_time) % 1440) * 60).toString(QStringLiteral("hh:mm"));
+        values[17] = block;
+        values[pic ? 19 : 20] = block;
+        values[25] = QString::number(i % 4 == 0 ? block_time / 2 : 0);
+        values[36] = QStringLiteral("Lufthansa");
+        values[38] = pic ? QStringLiteral("SELF") : pilots.at(i % pilots.size());
+        values[42] = pic ? pilots.at(i % pilots.size()) : QStringLiteral("SELF");
+        values[53] = values[55] = pic ? QStringLiteral("1") : QStringLiteral("0");
+        values[54] = values[56] = QStringLiteral("0");
+        values[58] = pic ? QStringLiteral("TRUE") : QStringLiteral("FALSE");
+        values[60] = QStringLiteral("ILS CAT I");
+        values[76] = QStringLiteral("Airbus");
+        values[77] = QStringLiteral("A320");
+        values[78] = QStringLiteral("214");
+        values[79] = registrations.at(i % registrations.size());
+        values[83] = values[84] = values[96] = QStringLiteral("TRUE");
+        values[92] = QStringLiteral("Turbine (jet-fan)");
+        out << values.join(QLatin1Char(',')) << '\n';
+    }
+    out.flush();
+    return out.status() == QTextStream::Ok;
+}
+
+QVector<Result> crewLoungeImport(int rows)
+{
+    QVector<Result> results;
+    QTemporaryDir import_dir;
+    const QString file_path = import_dir.filePath(QStringLiteral("crewlounge.csv"));
+    if (!writeCrewLoungeFile(file_path, rows)) {
+        LOG << "Unable to write the CrewLounge import file" << file_path;
+        return results;
+    }
+
+    for (const bool dry_run : {true, false}) {
+        const QString prefix = dry_run ? QStringLiteral("import/crewlounge/dryRun/")
+                                       : QStringLiteral("import/crewlounge/");
+        Import::Importer importer(Import::Formats::crewLounge(), file_path);
+        importer.setDryRun(dry_run);
+        bool success = false;
+        results.append(repeat(prefix + QStringLiteral("total"), 1, [&] { success = importer.exec(); }));
+        if (!success) {
+            LOG << "CrewLounge import failed:" << importer.errorString();
+            continue;
+        }
+        results.last().iterations = importer.report().rowsRead;
+        for (const auto &stage : importer.report().stages)
+            results.append({prefix + QLatin1String(stage.name), stage.items, stage.nsecs});
+        DEB << "Imported" << importer.report().rowsImported << "of" << importer.report().rowsRead << "rows";
+    }
+    return results;
+}
+
+QJsonArray toJson(const QVector<Result> &results)
+{
+    QJsonArray array;
+    for (const auto &result : results)
+        array.append(result.toJson());
+    return array;
+}
+
+void logResults(const QVector<Result> &results)
+{
+    for (const auto &result : results)
+        LOG << result.name << ":" << result.iterations << "iterations," << result.nsecs / 1000000.0 << "ms,"
+            << result.nsecsPerIteration() << "ns per iteration,"
+            << (result.allocations < 0 ? QStringLiteral("-") : QString::number(result.allocationsPerIteration()))
+            << "allocations per iteration";
+}
+
+} // namespace OPL::Benchmarks
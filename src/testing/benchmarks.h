@@ -0,0 +1,104 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+#include <QtCore>
+#include <atomic>
+
+namespace OPL::Benchmarks {
+
+/*!
+ * \brief Counts heap allocations while the benchmarks are running
+ * \details On glibc, opl_bench interposes malloc, calloc and realloc to increment this counter and sets
+ * allocationCountingEnabled, the results then contain the number of allocations per iteration. This covers all
+ * heap allocations, including those of operator new, the arrays of QString and QList and SQLite. On other
+ * platforms allocations are not counted.
+ */
+inline std::atomic<qint64> allocationCount{0};
+inline bool allocationCountingEnabled = false;
+
+/*!
+ * \brief The timing of a single benchmark
+ */
+struct Result {
+    QString name;
+    qint64 iterations;
+    qint64 nsecs;
+    qint64 allocations = -1; // -1 if allocations have not been counted
+
+    double nsecsPerIteration() const { return iterations > 0 ? double(nsecs) / iterations : 0.0; }
+    double allocationsPerIteration() const { return iterations > 0 ? double(allocations) / iterations : 0.0; }
+
+    QJsonObject toJson() const;
+};
+
+/*!
+ * \brief Compares parsing dates and times with QDate and QTime to the DateTimeParser
+ * \param iterations - the number of values parsed per benchmark
+ */
+QVector<Result> dateTimeParsing(int iterations = 100000);
+
+/*!
+ * \brief Compares formatting dates and times with QDate and QTime to the DateTimeFormatter
+ * \param iterations - the number of values formatted per benchmark
+ */
+QVector<Result> dateTimeFormatting(int iterations = 100000);
+
+/*!
+ * \brief Measures the cost of a debug log statement with the bound values of a database query as arguments
+ * \details Compares a statement in a disabled logging category with formatting the same arguments, which
+ * is what an unconditional qDebug() costs before the message is discarded. If debug output has been
+ * compiled out (OPL_DEBUG_LOGGING=OFF), the disabled statement is not compiled in at all.
+ * \param iterations - the number of statements per benchmark
+ */
+QVector<Result> logging(int iterations = 100000);
+
+/*!
+ * \brief Times the hot paths of the application on the current database
+ * \details Measures initialising and refreshing the database cache, getTotals(), the currency checks, selecting
+ * the logbook views, the CSV export, recomputing the night times of all flights, committing new flights and
+ * updating a flight by copying its data compared to updating only the modified column in place.
+ * The database is modified: night times are recalculated and commits new flights are added.
+ * \param repetitions - the number of repetitions for the fast read-only paths
+ * \param commits - the number of flights committed one by one
+ */
+QVector<Result> hotPaths(int repetitions = 10, int commits = 1000);
+
+/*!
+ * \brief Times a CrewLounge import of a generated export file with the given number of flights
+ * \details The file is imported twice, first as a dry run and then into the current database. Next to the
+ * total duration, the timing of every stage in the ImportReport is returned, with the number of items
+ * the stage has processed as iterations.
+ * The database is modified: the imported flights, pilots and tails are added.
+ * \param rows - the number of flights in the import file
+ */
+QVector<Result> crewLoungeImport(int rows = 15000);
+
+/*!
+ * \brief Converts the results to a JSON array
+ */
+QJsonArray toJson(const QVector<Result> &results);
+
+/*!
+ * \brief Writes the results to the log
+ */
+void logResults(const QVector<Result> &results);
+
+} // namespace OPL::Benchmarks
+
+#endif // BENCHMARKS_H
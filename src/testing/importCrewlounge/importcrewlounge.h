@@ -1,10 +0,0 @@
-#ifndef IMPORTCREWLOUNGE_H
-#define IMPORTCREWLOUNGE_H
-#include <QtCore>
-
-namespace ImportCrewlounge
-{
-void exec(const QString &csv_file_path);
-};
-
-#endif // IMPORTCREWLOUNGE_H
@@ -0,0 +1,400 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "syntheticlogbook.h"
+#include "src/database/database.h"
+#include "src/database/tailentry.h"
+#include "src/functions/calc.h"
+#include <QSqlQuery>
+#include <QSqlError>
+
+namespace OPL {
+
+namespace {
+
+const QStringList LAST_NAMES = {
+    QStringLiteral("Smith"), QStringLiteral("Müller"), QStringLiteral("Dubois"), QStringLiteral("Rossi"),
+    QStringLiteral("García"), QStringLiteral("Jensen"), QStringLiteral("Nowak"), QStringLiteral("Kowalski"),
+    QStringLiteral("O'Brien"), QStringLiteral("Schneider"), QStringLiteral("Fischer"), QStringLiteral("Weber"),
+    QStringLiteral("Martin"), QStringLiteral("Bernard"), QStringLiteral("Fernández"), QStringLiteral("Johansson"),
+    QStringLiteral("Novák"), QStringLiteral("Horvat"), QStringLiteral("Papadopoulos"), QStringLiteral("Yilmaz"),
+    QStringLiteral("Brown"), QStringLiteral("Wilson"), QStringLiteral("Lambert"), QStringLiteral("De Vries"),
+};
+
+const QStringList FIRST_NAMES = {
+    QStringLiteral("Anna"), QStringLiteral("Ben"), QStringLiteral("Clara"), QStringLiteral("David"),
+    QStringLiteral("Elena"), QStringLiteral("Felix"), QStringLiteral("Greta"), QStringLiteral("Hugo"),
+    QStringLiteral("Ingrid"), QStringLiteral("Jonas"), QStringLiteral("Katja"), QStringLiteral("Luca"),
+    QStringLiteral("Marie"), QStringLiteral("Nils"), QStringLiteral("Olivia"), QStringLiteral("Paul"),
+    QStringLiteral("Sofia"), QStringLiteral("Tom"), QStringLiteral("Ursula"), QStringLiteral("Victor"),
+};
+
+const QStringList COMPANIES = {
+    QStringLiteral("Skyways"), QStringLiteral("Alpine Air"), QStringLiteral("Nordic Express"),
+    QStringLiteral("Atlantic Connect"), QStringLiteral("Sunflight"),
+};
+
+QVariant nullable(int value)
+{
+    // use QMetaType for binding null value in QT >= 6
+    return value != 0 ? QVariant(value) : QVariant(QMetaType(QMetaType::Int));
+}
+
+} // namespace
+
+SyntheticLogbook::SyntheticLogbook(quint64 seed)
+    : m_engine(seed)
+{}
+
+int SyntheticLogbook::bounded(int min, int max)
+{
+    const quint64 range = quint64(max - min) + 1;
+    return min + int(m_engine() % range);
+}
+
+double SyntheticLogbook::uniform()
+{
+    return (m_engine() >> 11) * 0x1.0p-53;
+}
+
+bool SyntheticLogbook::generate(int number_of_flights)
+{
+    QSqlDatabase database = DB->database();
+    return generate(number_of_flights, database);
+}
+
+bool SyntheticLogbook::generate(int number_of_flights, const QString &database_path)
+{
+    // every thread needs its own connection
+    const QString connection_name = QStringLiteral("synthetic_logbook_connection_%1")
+            .arg(reinterpret_cast<quintptr>(QThread::currentThread()));
+    bool success = false;
+    { // scope for a temporary database connection, ensures proper cleanup when removeDatabase() is called.
+        QSqlDatabase database = QSqlDatabase::addDatabase(SQLITE_DRIVER, connection_name);
+        database.setDatabaseName(database_path);
+        // the models of the GUI thread may still be reading
+        database.setConnectOptions(QStringLiteral("QSQLITE_BUSY_TIMEOUT=5000"));
+        if (!database.open()) {
+            m_errorString = database.lastError().text();
+        } else {
+            success = generate(number_of_flights, database);
+            database.close();
+        }
+    }
+    QSqlDatabase::removeDatabase(connection_name);
+    return success;
+}
+
+bool SyntheticLogbook::generate(int number_of_flights, QSqlDatabase &database)
+{
+    m_numberOfPilots = qBound(50, number_of_flights / 25, 4000);
+    m_numberOfTails = qBound(5, number_of_flights / 400, 250);
+    m_errorString.clear();
+
+    if (!database.transaction()) {
+        m_errorString = database.lastError().text();
+        return false;
+    }
+    if (insertPilots(database) && insertTails(database) && insertFlights(database, number_of_flights)) {
+        if (database.commit())
+            return true;
+        m_errorString = database.lastError().text();
+    }
+
+    database.rollback();
+    return false;
+}
+
+bool SyntheticLogbook::insertPilots(QSqlDatabase &database)
+{
+    QSqlQuery query(database);
+    query.prepare(QStringLiteral("INSERT INTO pilots (pilot_id, lastname, firstname, company, employeeid) "
+                                 "VALUES (?, ?, ?, ?, ?)"));
+    for (int id = 1; id <= m_numberOfPilots; id++) {
+        query.addBindValue(id);
+        // the logbook owner is always pilot 1
+        query.addBindValue(id == 1 ? QStringLiteral("Self") : LAST_NAMES.at(bounded(0, LAST_NAMES.size() - 1)));
+        query.addBindValue(FIRST_NAMES.at(bounded(0, FIRST_NAMES.size() - 1)));
+        query.addBindValue(COMPANIES.at(bounded(0, COMPANIES.size() - 1)));
+        query.addBindValue(QString::number(bounded(1000, 99999)));
+        if (!query.exec()) {
+            m_errorString = query.lastError().text();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SyntheticLogbook::insertTails(QSqlDatabase &database)
+{
+    // A career spans a few aircraft types, every tail is of one of them
+    QVector<RowData_T> types;
+    QSqlQuery query(database);
+    query.exec(QStringLiteral("SELECT make, model, variant, multipilot, multiengine, engineType, weightClass "
+                              "FROM aircraft WHERE make IS NOT NULL ORDER BY aircraft_id"));
+    while (query.next()) {
+        types.append({
+            {TailEntry::MAKE, query.value(0)},
+            {TailEntry::MODEL, query.value(1)},
+            {TailEntry::VARIANT, query.value(2)},
+            {TailEntry::MULTI_PILOT, query.value(3)},
+            {TailEntry::MULTI_ENGINE, query.value(4)},
+            {TailEntry::ENGINE_TYPE, query.value(5)},
+            {TailEntry::WEIGHT_CLASS, query.value(6)},
+        });
+    }
+    if (types.isEmpty()) {
+        m_errorString = QStringLiteral("No aircraft templates available.");
+        return false;
+    }
+
+    QVector<RowData_T> career;
+    for (int i = 0; i < 4; i++)
+        career.append(types.at(bounded(0, types.size() - 1)));
+
+    query.prepare(QStringLiteral("INSERT INTO tails (tail_id, registration, company, make, model, variant, "
+                                 "multipilot, multiengine, engineType, weightClass, typeString) "
+                                 "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)"));
+    m_tailClasses.fill({false, false}, m_numberOfTails + 1);
+    for (int id = 1; id <= m_numberOfTails; id++) {
+        const TailEntry type(career.at(bounded(0, career.size() - 1)));
+        const RowData_T &data = type.getData();
+
+        // D-Axxx with a unique suffix for every tail
+        QString registration = QStringLiteral("D-A");
+        for (int i = 0, n = id; i < 3; i++, n /= 26)
+            registration.append(QChar('A' + n % 26));
+
+        query.addBindValue(id);
+        query.addBindValue(registration);
+        query.addBindValue(COMPANIES.at(bounded(0, COMPANIES.size() - 1)));
+        query.addBindValue(data.value(TailEntry::MAKE));
+        query.addBindValue(data.value(TailEntry::MODEL));
+        query.addBindValue(data.value(TailEntry::VARIANT));
+        query.addBindValue(data.value(TailEntry::MULTI_PILOT));
+        query.addBindValue(data.value(TailEntry::MULTI_ENGINE));
+        query.addBindValue(data.value(TailEntry::ENGINE_TYPE));
+        query.addBindValue(data.value(TailEntry::WEIGHT_CLASS));
+        query.addBindValue(type.getTypeString());
+        if (!query.exec()) {
+            m_errorString = query.lastError().text();
+            return false;
+        }
+        m_tailClasses[id] = {data.value(TailEntry::MULTI_PILOT).toInt() == 1,
+                             data.value(TailEntry::MULTI_ENGINE).toInt() == 1};
+    }
+    return true;
+}
+
+QVector<SyntheticLogbook::Airport> SyntheticLogbook::loadNetwork(QSqlDatabase &database)
+{
+    QVector<Airport> airports;
+    QSqlQuery query(database);
+    query.setForwardOnly(true);
+    query.exec(QStringLiteral("SELECT icao, lat, long FROM airports WHERE lat IS NOT NULL AND long IS NOT NULL "
+                              "AND iata IS NOT NULL AND LENGTH(icao) = 4 ORDER BY airport_id"));
+    while (query.next())
+        airports.append({query.value(0).toString(), query.value(1).toDouble(), query.value(2).toDouble()});
+    if (airports.size() < 2)
+        return airports;
+
+    // serve up to 80 destinations within 1500 nm of the home base
+    static constexpr int NETWORK_SIZE = 80;
+    static constexpr double MAX_RANGE = 1500.0;
+    const Airport base = airports.at(bounded(0, airports.size() - 1));
+    QVector<Airport> network = {base};
+    const int first = bounded(0, airports.size() - 1);
+    for (int i = 0; i < airports.size() && network.size() <= NETWORK_SIZE; i++) {
+        const Airport &airport = airports.at((first + i) % airports.size());
+        const double distance = Calc::radToNauticalMiles(
+                    Calc::greatCircleDistance(base.lat, base.lon, airport.lat, airport.lon));
+        if (airport.icao != base.icao && distance > 100.0 && distance < MAX_RANGE)
+            network.append(airport);
+    }
+
+    // isolated bases are connected to arbitrary airports instead
+    for (int i = 0; network.size() < 10 && i < airports.size(); i++)
+        if (airports.at(i).icao != base.icao)
+            network.append(airports.at(i));
+    return network;
+}
+
+bool SyntheticLogbook::insertFlights(QSqlDatabase &database, int number_of_flights)
+{
+    const QVector<Airport> network = loadNetwork(database);
+    if (network.size() < 2) {
+        m_errorString = QStringLiteral("No airport templates available.");
+        return false;
+    }
+
+    QVector<Flight> flights = planFlights(network, number_of_flights);
+    QThreadPool thread_pool;
+    for (qsizetype begin = 0; begin < flights.size(); begin += BATCH_SIZE) {
+        Flight *first = flights.data() + begin;
+        Flight *last = flights.data() + qMin<qsizetype>(begin + BATCH_SIZE, flights.size());
+        thread_pool.start([&network, first, last] { calculateNightTimes(network, first, last); });
+    }
+    thread_pool.waitForDone();
+
+    QSqlQuery query(database);
+    int prepared_size = 0;
+    for (qsizetype begin = 0; begin < flights.size(); begin += BATCH_SIZE) {
+        const int size = qMin<qsizetype>(BATCH_SIZE, flights.size() - begin);
+        // only the last batch can be smaller
+        if (size != prepared_size) {
+            if (!query.prepare(insertStatement(size))) {
+                m_errorString = query.lastError().text();
+                return false;
+            }
+            prepared_size = size;
+        }
+
+        for (int i = 0; i < size; i++) {
+            const Flight &flight = flights.at(begin + i);
+            const auto [multi_pilot, multi_engine] = m_tailClasses.at(flight.tail);
+            const bool self_pic = flight.pic == 1;
+            const bool pilot_flying = flight.pilotFlying;
+            query.addBindValue(flight.doft);
+            query.addBindValue(network.at(flight.dept).icao);
+            query.addBindValue(network.at(flight.dest).icao);
+            query.addBindValue(flight.tofb);
+            query.addBindValue((flight.tofb + flight.tblk) % 1440);
+            query.addBindValue(flight.pic);
+            query.addBindValue(flight.tail);
+            query.addBindValue(flight.tblk);
+            query.addBindValue(nullable(!multi_pilot && !multi_engine ? flight.tblk : 0));
+            query.addBindValue(nullable(!multi_pilot && multi_engine ? flight.tblk : 0));
+            query.addBindValue(nullable(multi_pilot ? flight.tblk : 0));
+            query.addBindValue(nullable(flight.tNight));
+            query.addBindValue(nullable(multi_pilot ? flight.tblk : 0));
+            query.addBindValue(nullable(self_pic ? flight.tblk : 0));
+            query.addBindValue(nullable(self_pic ? 0 : flight.tblk));
+            query.addBindValue(pilot_flying ? 1 : 0);
+            query.addBindValue(nullable(pilot_flying && !flight.nightTakeOff));
+            query.addBindValue(nullable(pilot_flying && flight.nightTakeOff));
+            query.addBindValue(nullable(pilot_flying && !flight.nightLanding));
+            query.addBindValue(nullable(pilot_flying && flight.nightLanding));
+            query.addBindValue(flight.secondPilot);
+            query.addBindValue(QStringLiteral("ILS CAT I"));
+            query.addBindValue(QStringLiteral("SKY%1").arg(flight.flightNumber));
+        }
+        if (!query.exec()) {
+            m_errorString = query.lastError().text();
+            return false;
+        }
+    }
+    return true;
+}
+
+QVector<SyntheticLogbook::Flight> SyntheticLogbook::planFlights(const QVector<Airport> &network, int number_of_flights)
+{
+    // Destinations are picked with a Zipf distribution, a few of them are served far more often
+    QVector<double> cumulative_weights;
+    double total_weight = 0;
+    for (int i = 1; i < network.size(); i++) {
+        total_weight += 1.0 / i;
+        cumulative_weights.append(total_weight);
+    }
+    const auto pick_destination = [&]() {
+        const double value = uniform() * total_weight;
+        const auto it = std::upper_bound(cumulative_weights.cbegin(), cumulative_weights.cend(), value);
+        return 1 + qMin<int>(std::distance(cumulative_weights.cbegin(), it), network.size() - 2);
+    };
+
+    QVector<Flight> flights;
+    flights.reserve(number_of_flights);
+    // roughly 200 duty days a year with two to three sectors each
+    qint64 julian_day = LAST_JULIAN_DAY - qint64(number_of_flights) * 365 / 500;
+    int position = 0; // index into the network, 0 is the home base
+    while (flights.size() < number_of_flights) {
+        julian_day += bounded(1, 3);
+        const int sectors = qMin<int>(bounded(1, 4), number_of_flights - flights.size());
+        const int tail = bounded(1, m_numberOfTails);
+        const int other_pilot = bounded(2, m_numberOfPilots);
+        // the logbook owner is upgraded to captain after 40 percent of the career
+        const bool self_pic = flights.size() > number_of_flights * 4 / 10;
+        const int flight_number = bounded(100, 9899);
+
+        int departure_time = bounded(300, 1080); // minutes UTC
+        for (int sector = 0; sector < sectors; sector++) {
+            // out-and-back flights from the home base, odd numbers of sectors end with a night stop
+            const int destination = position == 0 ? pick_destination() : 0;
+
+            const Airport &dept = network.at(position);
+            const Airport &dest = network.at(destination);
+            const double distance = Calc::radToNauticalMiles(
+                        Calc::greatCircleDistance(dept.lat, dept.lon, dest.lat, dest.lon));
+            const int tblk = 20 + qRound(distance / 7.5) + bounded(0, 10);
+
+            Flight flight;
+            flight.doft = julian_day + departure_time / 1440;
+            flight.dept = position;
+            flight.dest = destination;
+            flight.tofb = departure_time % 1440;
+            flight.tblk = tblk;
+            flight.pic = self_pic ? 1 : other_pilot;
+            flight.secondPilot = self_pic ? other_pilot : 1;
+            flight.tail = tail;
+            flight.flightNumber = flight_number + sector;
+            flight.pilotFlying = (sector + flights.size()) % 2 == 0;
+            flights.append(flight);
+
+            position = destination;
+            departure_time += tblk + bounded(35, 75);
+        }
+        julian_day += departure_time / 1440;
+    }
+    return flights;
+}
+
+void SyntheticLogbook::calculateNightTimes(const QVector<Airport> &network, Flight *begin, Flight *end)
+{
+    for (Flight *flight = begin; flight != end; flight++) {
+        const Airport &dept = network.at(flight->dept);
+        const Airport &dest = network.at(flight->dest);
+        const QDateTime off_blocks(QDate::fromJulianDay(flight->doft), QTime(0, 0).addSecs(flight->tofb * 60),
+                                   QTimeZone::utc());
+        const QDateTime on_blocks = off_blocks.addSecs(flight->tblk * 60);
+        flight->tNight = Calc::calculateNightTime(dept.lat, dept.lon, dest.lat, dest.lon,
+                                                  off_blocks, flight->tblk, NIGHT_ANGLE);
+        flight->nightTakeOff = Calc::solarElevation(off_blocks, dept.lat, dept.lon) < NIGHT_ANGLE;
+        flight->nightLanding = Calc::solarElevation(on_blocks, dest.lat, dest.lon) < NIGHT_ANGLE;
+    }
+}
+
+/*!
+ * \brief Returns an INSERT statement for number_of_flights flights with FLIGHT_COLUMNS bound values each
+ */
+QString SyntheticLogbook::insertStatement(int number_of_flights)
+{
+    QString statement = QStringLiteral("INSERT INTO flights (doft, dept, dest, tofb, tonb, pic, acft, tblk, tSPSE, "
+                                       "tSPME, tMP, tNIGHT, tIFR, tPIC, tSIC, pilotFlying, toDay, toNight, ldgDay, "
+                                       "ldgNight, secondPilot, approachType, flightNumber) VALUES ");
+    QString row = QStringLiteral("(?");
+    for (int i = 1; i < FLIGHT_COLUMNS; i++)
+        row.append(QStringLiteral(", ?"));
+    row.append(QLatin1Char(')'));
+
+    for (int i = 0; i < number_of_flights; i++) {
+        if (i > 0)
+            statement.append(QStringLiteral(", "));
+        statement.append(row);
+    }
+    return statement;
+}
+
+} // namespace OPL
@@ -0,0 +1,134 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef SYNTHETICLOGBOOK_H
+#define SYNTHETICLOGBOOK_H
+#include <QtCore>
+#include <QSqlDatabase>
+#include <random>
+
+namespace OPL {
+
+/*!
+ * \brief The SyntheticLogbook class fills an empty database with a randomly generated but realistic logbook
+ * for benchmarking and stress testing.
+ *
+ * \details The logbook is deterministic, generating it twice with the same seed and number of flights produces
+ * the same database content on every platform and on every day. The number of pilots and tails grows with the size of the logbook.
+ *
+ * The flights follow a simple airline pattern: Duty days of one to four sectors, flown from a home base into a
+ * network of destinations of which a few are visited far more often than the rest. Block times are derived from
+ * the great circle distance, night time as well as take-offs and landings are calculated from the airport
+ * coordinates.
+ *
+ * The flights are planned serially, so the logbook does not depend on the number of threads. Night times are the
+ * expensive part and are calculated in batches on a thread pool. Every batch is then written with a single
+ * multi-row INSERT, all inside one transaction.
+ *
+ * The template tables (aircraft, airports) have to be populated before generate() is called.
+ */
+class SyntheticLogbook
+{
+public:
+    explicit SyntheticLogbook(quint64 seed);
+
+    /*!
+     * \brief Generates pilots, tails and number_of_flights flights and inserts them into the database
+     * \return false if the data could not be inserted, errorString() contains a description of the error
+     */
+    bool generate(int number_of_flights);
+
+    /*!
+     * \brief Generates the logbook in the database at database_path through a connection of its own. Unlike
+     * generate(int), this can be called from a worker thread.
+     */
+    bool generate(int number_of_flights, const QString &database_path);
+
+    int numberOfPilots() const { return m_numberOfPilots; }
+    int numberOfTails() const { return m_numberOfTails; }
+    const QString &errorString() const { return m_errorString; }
+
+private:
+    struct Airport {
+        QString icao;
+        double lat;
+        double lon;
+    };
+
+    /*!
+     * \brief A planned flight. tNight and the night take-off and landing flags are calculated afterwards.
+     */
+    struct Flight {
+        qint64 doft;
+        int dept;           // index into the network
+        int dest;           // index into the network
+        int tofb;
+        int tblk;
+        int pic;
+        int secondPilot;
+        int tail;
+        int flightNumber;
+        bool pilotFlying;
+        int tNight = 0;
+        bool nightTakeOff = false;
+        bool nightLanding = false;
+    };
+
+    std::mt19937_64 m_engine;
+    int m_numberOfPilots = 0;
+    int m_numberOfTails = 0;
+    QString m_errorString;
+
+    static constexpr int NIGHT_ANGLE = -6;
+    // 23 columns per flight stay below the 999 bound parameters older SQLite versions allow per statement
+    static constexpr int BATCH_SIZE = 40;
+    static constexpr int FLIGHT_COLUMNS = 23;
+    inline const static QString SQLITE_DRIVER  = QStringLiteral("QSQLITE");
+    // the logbook ends on 31 December 2023, a fixed date so that the logbook does not depend on the current date
+    static constexpr qint64 LAST_JULIAN_DAY = 2460310;
+
+    /*!
+     * \brief Returns a random integer in [min, max]. Unlike std::uniform_int_distribution,
+     * the result does not depend on the standard library implementation.
+     */
+    int bounded(int min, int max);
+
+    /*!
+     * \brief Returns a random double in [0, 1)
+     */
+    double uniform();
+
+    // multi pilot and multi engine flags of the generated tails, indexed by tail id
+    QVector<QPair<bool, bool>> m_tailClasses;
+
+    bool generate(int number_of_flights, QSqlDatabase &database);
+    bool insertPilots(QSqlDatabase &database);
+    bool insertTails(QSqlDatabase &database);
+    bool insertFlights(QSqlDatabase &database, int number_of_flights);
+    QVector<Flight> planFlights(const QVector<Airport> &network, int number_of_flights);
+    static void calculateNightTimes(const QVector<Airport> &network, Flight *begin, Flight *end);
+    static QString insertStatement(int number_of_flights);
+
+    /*!
+     * \brief Selects a home base and the destinations served from it. The home base is the first airport.
+     */
+    QVector<Airport> loadNetwork(QSqlDatabase &database);
+};
+
+} // namespace OPL
+
+#endif // SYNTHETICLOGBOOK_H
@@ -0,0 +1,190 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "trace.h"
+#include <QMutex>
+#include <memory>
+#include <vector>
+
+namespace OPL::Trace {
+
+namespace detail {
+std::atomic_bool enabled = false;
+}
+
+namespace {
+
+// Every thread can record this many events before further events are dropped
+constexpr int BUFFER_CAPACITY = 1 << 16;
+
+struct Event {
+    const char *name;
+    const char *category;
+    qint64 start;    // microseconds since the start of the application
+    qint64 duration; // microseconds
+};
+
+/*!
+ * \brief Events of a single thread. Only the owning thread writes, it publishes new events by
+ * incrementing count, which writeChromeTrace() reads to determine how many events are complete.
+ */
+struct ThreadBuffer {
+    int threadId;
+    QString threadName;
+    std::unique_ptr<Event[]> events = std::make_unique<Event[]>(BUFFER_CAPACITY);
+    std::atomic_int count = 0;
+};
+
+// The buffers are owned by the registry, so the events of a thread remain available after it has finished.
+// Buffers of finished threads are kept on the free list and handed to the next new thread, so the number of
+// buffers is bounded by the number of threads running at the same time.
+QMutex registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+std::vector<ThreadBuffer *> freeBuffers;
+std::atomic<qint64> dropped = 0;
+const Clock::time_point epoch = Clock::now();
+
+/*!
+ * \brief Holds the buffer of the current thread and returns it to the free list when the thread finishes
+ */
+struct BufferLease {
+    ThreadBuffer *buffer = nullptr;
+
+    ~BufferLease()
+    {
+        if (buffer == nullptr)
+            return;
+        QMutexLocker locker(&registryMutex);
+        freeBuffers.push_back(buffer);
+    }
+};
+
+ThreadBuffer *threadBuffer()
+{
+    thread_local BufferLease lease;
+    if (lease.buffer != nullptr)
+        return lease.buffer;
+
+    QMutexLocker locker(&registryMutex);
+    // a recycled buffer keeps its events and name, the new thread appends to them
+    if (!freeBuffers.empty()) {
+        lease.buffer = freeBuffers.back();
+        freeBuffers.pop_back();
+        return lease.buffer;
+    }
+
+    buffers.push_back(std::make_unique<ThreadBuffer>());
+    ThreadBuffer *buffer = buffers.back().get();
+    lease.buffer = buffer;
+    buffer->threadId = int(buffers.size());
+
+    const QThread *thread = QThread::currentThread();
+    if (QCoreApplication::instance() != nullptr && thread == QCoreApplication::instance()->thread())
+        buffer->threadName = QStringLiteral("main");
+    else if (!thread->objectName().isEmpty())
+        buffer->threadName = thread->objectName();
+    else
+        buffer->threadName = QStringLiteral("thread %1").arg(buffer->threadId);
+    return buffer;
+}
+
+qint64 microseconds(Clock::duration duration)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+QString escaped(const QString &string)
+{
+    QString result = string;
+    result.replace(QLatin1Char('\\'), QLatin1String("\\\\"));
+    result.replace(QLatin1Char('"'), QLatin1String("\\\""));
+    return result;
+}
+
+} // namespace
+
+void start()
+{
+    detail::enabled.store(true, std::memory_order_relaxed);
+}
+
+void stop()
+{
+    detail::enabled.store(false, std::memory_order_relaxed);
+}
+
+void clear()
+{
+    QMutexLocker locker(&registryMutex);
+    for (const auto &buffer : buffers)
+        buffer->count.store(0, std::memory_order_release);
+    dropped = 0;
+}
+
+qint64 droppedEvents()
+{
+    return dropped.load(std::memory_order_relaxed);
+}
+
+void addEvent(const char *name, const char *category, Clock::time_point start, Clock::time_point end)
+{
+    ThreadBuffer *buffer = threadBuffer();
+    const int index = buffer->count.load(std::memory_order_relaxed);
+    if (index >= BUFFER_CAPACITY) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer->events[index] = {name, category, microseconds(start - epoch), microseconds(end - start)};
+    buffer->count.store(index + 1, std::memory_order_release);
+}
+
+bool writeChromeTrace(const QString &file_path)
+{
+    QFile file(file_path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        return false;
+
+    const qint64 pid = QCoreApplication::applicationPid();
+    QTextStream out(&file);
+    out << "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":" << droppedEvents()
+        << "},\"traceEvents\":[";
+
+    QMutexLocker locker(&registryMutex);
+    bool first = true;
+    for (const auto &buffer : buffers) {
+        const int count = buffer->count.load(std::memory_order_acquire);
+        if (count == 0)
+            continue;
+
+        // name the thread, then list its events
+        out << (first ? "\n" : ",\n")
+            << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << buffer->threadId
+            << ",\"args\":{\"name\":\"" << escaped(buffer->threadName) << "\"}}";
+        first = false;
+        for (int i = 0; i < count; i++) {
+            const Event &event = buffer->events[i];
+            out << ",\n{\"name\":\"" << escaped(QString::fromUtf8(event.name)) << "\",\"cat\":\"" << event.category
+                << "\",\"ph\":\"X\",\"ts\":" << event.start << ",\"dur\":" << event.duration
+                << ",\"pid\":" << pid << ",\"tid\":" << buffer->threadId << '}';
+        }
+    }
+    out << "\n]}\n";
+    out.flush();
+    return out.status() == QTextStream::Ok && file.error() == QFileDevice::NoError;
+}
+
+} // namespace OPL::Trace
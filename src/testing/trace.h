@@ -0,0 +1,117 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef TRACE_H
+#define TRACE_H
+#include <QtCore>
+#include <atomic>
+#include <chrono>
+
+namespace OPL {
+
+/*!
+ * \brief The Trace namespace records the duration of nested scopes and exports them as a Chrome trace.
+ *
+ * \details Instrument a function with TRACE_FUNCTION("category") or a block with TRACE_SCOPE("name"). While tracing is
+ * enabled, every scope records a complete event with microsecond resolution when it ends. The events are
+ * appended to a buffer owned by the recording thread, so recording does not take any locks. Nesting is
+ * derived from the timestamps by the trace viewer. When a thread finishes, its buffer is handed to the next
+ * new thread, so threads which are retired and re-created by a thread pool share a row in the trace.
+ *
+ * The file written by writeChromeTrace() can be opened in chrome://tracing or https://ui.perfetto.dev
+ *
+ * While tracing is disabled a scope only checks a flag, so the instrumentation can remain in release builds.
+ */
+namespace Trace {
+
+using Clock = std::chrono::steady_clock;
+
+/*!
+ * \brief Start recording events. Events of a previous recording are kept until clear() is called.
+ */
+void start();
+
+/*!
+ * \brief Stop recording events
+ */
+void stop();
+
+/*!
+ * \brief Discards all recorded events. Call while tracing is stopped.
+ */
+void clear();
+
+/*!
+ * \brief Writes the recorded events to file_path in the Chrome trace event format
+ * \return false if the file could not be written
+ */
+bool writeChromeTrace(const QString &file_path);
+
+/*!
+ * \brief Returns the number of events that have been discarded because a thread's buffer was full
+ */
+qint64 droppedEvents();
+
+/*!
+ * \brief Records a complete event. name and category have to be string literals or otherwise outlive the trace.
+ */
+void addEvent(const char *name, const char *category, Clock::time_point start, Clock::time_point end);
+
+namespace detail {
+extern std::atomic_bool enabled;
+}
+
+inline bool isEnabled() { return detail::enabled.load(std::memory_order_relaxed); }
+
+/*!
+ * \brief The Scope class records an event covering its lifetime
+ */
+class Scope
+{
+public:
+    explicit Scope(const char *name, const char *category = "opl")
+        : m_name(name), m_category(category), m_active(isEnabled())
+    {
+        if (m_active)
+            m_start = Clock::now();
+    }
+
+    ~Scope()
+    {
+        if (m_active)
+            addEvent(m_name, m_category, m_start, Clock::now());
+    }
+
+    Q_DISABLE_COPY_MOVE(Scope)
+
+private:
+    const char *m_name;
+    const char *m_category;
+    bool m_active;
+    Clock::time_point m_start;
+};
+
+} // namespace Trace
+} // namespace OPL
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+#define TRACE_SCOPE(name) const OPL::Trace::Scope TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#define TRACE_SCOPE_CAT(name, category) const OPL::Trace::Scope TRACE_CONCAT(trace_scope_, __LINE__)(name, category)
+#define TRACE_FUNCTION(category) TRACE_SCOPE_CAT(Q_FUNC_INFO, category)
+
+#endif // TRACE_H
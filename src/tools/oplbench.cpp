@@ -0,0 +1,189 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * opl_bench - benchmarks the hot paths of openPilotLog on synthetic logbooks
+ *
+ * For every requested size, a fresh database is created in a temporary application directory and filled
+ * with a deterministic synthetic logbook (see OPL::SyntheticLogbook). The hot paths are then timed on this
+ * database. The results are written as JSON, so that they can be compared between releases.
+ *
+ * Usage: opl_bench [--sizes 1000,10000,100000] [--seed 1] [--repetitions 10] [--commits 1000] [--output file]
+ */
+#include "src/opl.h"
+#include "src/classes/paths.h"
+#include "src/classes/settings.h"
+#include "src/database/database.h"
+#include "src/functions/log.h"
+#include "src/testing/benchmarks.h"
+#include "src/testing/syntheticlogbook.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTemporaryDir>
+#include <cstdlib>
+
+#if defined(__GLIBC__)
+// Count the allocations at the malloc level, see OPL::Benchmarks::allocationCount. Symbols defined in the
+// executable take precedence over those of the shared libraries, so these definitions also receive the
+// allocations of Qt, SQLite and operator new. glibc exports its own implementation as __libc_*.
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size)
+{
+    OPL::Benchmarks::allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    OPL::Benchmarks::allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    OPL::Benchmarks::allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+} // extern "C"
+#endif
+
+namespace {
+
+QTextStream &err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+/*!
+ * \brief Creates a new database with the template data and a synthetic logbook of the given size
+ */
+bool createLogbook(int number_of_flights, quint64 seed, QJsonObject &dataset)
+{
+    DB->disconnect();
+    QFile::remove(OPL::Paths::databaseFileInfo().absoluteFilePath());
+    if (!DB->connect() || !DB->createSchema() || !DB->importTemplateData(true)) {
+        err() << "Unable to create database: " << DB->lastError.text() << Qt::endl;
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    OPL::SyntheticLogbook logbook(seed);
+    if (!logbook.generate(number_of_flights)) {
+        err() << "Unable to generate logbook: " << logbook.errorString() << Qt::endl;
+        return false;
+    }
+
+    dataset.insert(QStringLiteral("flights"), number_of_flights);
+    dataset.insert(QStringLiteral("pilots"), logbook.numberOfPilots());
+    dataset.insert(QStringLiteral("tails"), logbook.numberOfTails());
+    dataset.insert(QStringLiteral("generationNsecs"), timer.nsecsElapsed());
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("opl_bench"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Benchmarks openPilotLog on synthetic logbooks"));
+    parser.addHelpOption();
+    const QCommandLineOption sizes_option(QStringLiteral("sizes"), QStringLiteral("Comma separated logbook sizes"),
+                                          QStringLiteral("flights"), QStringLiteral("1000,10000,100000"));
+    const QCommandLineOption seed_option(QStringLiteral("seed"), QStringLiteral("Seed of the synthetic logbooks"),
+                                         QStringLiteral("seed"), QStringLiteral("1"));
+    const QCommandLineOption repetitions_option(QStringLiteral("repetitions"),
+                                                QStringLiteral("Repetitions of the read-only benchmarks"),
+                                                QStringLiteral("count"), QStringLiteral("10"));
+    const QCommandLineOption commits_option(QStringLiteral("commits"), QStringLiteral("Number of flights committed"),
+                                            QStringLiteral("count"), QStringLiteral("1000"));
+    const QCommandLineOption output_option(QStringLiteral("output"), QStringLiteral("Write the results to file"),
+                                           QStringLiteral("file"));
+    parser.addOptions({sizes_option, seed_option, repetitions_option, commits_option, output_option});
+    parser.process(app);
+
+    QVector<int> sizes;
+    for (const auto &size : parser.value(sizes_option).split(QLatin1Char(','), Qt::SkipEmptyParts))
+        sizes.append(size.toInt());
+    const quint64 seed = parser.value(seed_option).toULongLong();
+    const int repetitions = parser.value(repetitions_option).toInt();
+    const int commits = parser.value(commits_option).toInt();
+
+    // run in a temporary application directory and keep the console quiet
+    QTemporaryDir app_dir;
+    if (!app_dir.isValid()) {
+        err() << "Unable to create temporary directory: " << app_dir.errorString() << Qt::endl;
+        return 1;
+    }
+    OPL::Paths::setBasePath(app_dir.path());
+    OPL::Paths::setup();
+    OPL::Log::setCategoryLevel(QStringLiteral("opl"), QtWarningMsg);
+    Settings::init();
+#if defined(__GLIBC__)
+    OPL::Benchmarks::allocationCountingEnabled = true;
+#endif
+
+    QJsonArray datasets;
+    for (const int size : std::as_const(sizes)) {
+        QJsonObject dataset;
+        if (!createLogbook(size, seed, dataset))
+            return 1;
+        err() << "Benchmarking " << size << " flights..." << Qt::endl;
+        QJsonArray results = OPL::Benchmarks::toJson(OPL::Benchmarks::hotPaths(repetitions, commits));
+        for (const auto &result : OPL::Benchmarks::toJson(OPL::Benchmarks::crewLoungeImport()))
+            results.append(result);
+        dataset.insert(QStringLiteral("results"), results);
+        datasets.append(dataset);
+    }
+    DB->disconnect();
+
+    QJsonArray micro_benchmarks = OPL::Benchmarks::toJson(OPL::Benchmarks::dateTimeParsing());
+    for (const auto &result : OPL::Benchmarks::toJson(OPL::Benchmarks::dateTimeFormatting()))
+        micro_benchmarks.append(result);
+    for (const auto &result : OPL::Benchmarks::toJson(OPL::Benchmarks::logging()))
+        micro_benchmarks.append(result);
+
+    const QJsonObject report = {
+        {QStringLiteral("version"), OPL_VERSION_STRING},
+        {QStringLiteral("qtVersion"), QString::fromLatin1(qVersion())},
+        {QStringLiteral("timestamp"), QDateTime::currentDateTimeUtc().toString(Qt::ISODate)},
+        {QStringLiteral("seed"), QString::number(seed)},
+        {QStringLiteral("datasets"), datasets},
+        {QStringLiteral("micro"), micro_benchmarks},
+    };
+    const QByteArray json = QJsonDocument(report).toJson();
+
+    if (!parser.isSet(output_option)) {
+        QTextStream(stdout) << json;
+        return 0;
+    }
+    QFile out(parser.value(output_option));
+    if (!out.open(QIODevice::WriteOnly) || out.write(json) != json.size()) {
+        err() << "Unable to write " << out.fileName() << ": " << out.errorString() << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
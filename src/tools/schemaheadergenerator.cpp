@@ -0,0 +1,169 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * opl_schemagen - build-time generator for the compile-time column descriptors
+ *
+ * Reads the CREATE TABLE statements of the database schema and writes a header declaring one struct
+ * per table in the namespace OPL::Schema. Each struct holds the table name, an enum of its columns in
+ * schema order and a constexpr array describing each column. TypedRow uses these to store rows in a
+ * fixed layout, so the descriptors can never diverge from the schema the database is created from.
+ *
+ * Usage: opl_schemagen <output.h> <schema.sql>
+ */
+#include <QCoreApplication>
+#include <QFile>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QTextStream>
+
+namespace {
+
+QTextStream &err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+struct Column {
+    QString name;
+    QString type;
+    bool notNull;
+};
+
+struct Table {
+    QString name;
+    QList<Column> columns;
+};
+
+QList<Table> parseSchema(const QString &schema)
+{
+    static const QRegularExpression create_table(
+                QStringLiteral(R"(CREATE TABLE(?: IF NOT EXISTS)?\s+['"`\[]?(\w+)['"`\]]?\s*\((.*?)\);)"),
+                QRegularExpression::DotMatchesEverythingOption);
+    // column definitions start with the column name, quoted or not, followed by its type. Table constraints
+    // start with a keyword instead.
+    static const QRegularExpression column_definition(
+                QStringLiteral(R"(^(?!(?:CONSTRAINT|PRIMARY|FOREIGN|UNIQUE|CHECK)\b)['"`\[]?(\w+)['"`\]]?\s+(\w+)(.*)$)"),
+                QRegularExpression::CaseInsensitiveOption);
+
+    QList<Table> tables;
+    auto it = create_table.globalMatch(schema);
+    while (it.hasNext()) {
+        const auto match = it.next();
+        Table table{match.captured(1), {}};
+        const auto lines = match.captured(2).split(QLatin1Char('\n'));
+        for (const auto &line : lines) {
+            const auto column = column_definition.match(line.trimmed());
+            if (column.hasMatch())
+                table.columns.append({column.captured(1),
+                                      column.captured(2).toUpper(),
+                                      column.captured(3).contains(QLatin1String("NOT NULL"), Qt::CaseInsensitive)});
+        }
+        tables.append(table);
+    }
+    return tables;
+}
+
+QString columnType(const QString &sql_type)
+{
+    // dates are stored as julian days in NUMERIC columns
+    if (sql_type == QLatin1String("INTEGER") || sql_type == QLatin1String("NUMERIC"))
+        return QStringLiteral("ColumnType::Integer");
+    if (sql_type == QLatin1String("REAL"))
+        return QStringLiteral("ColumnType::Real");
+    return QStringLiteral("ColumnType::Text");
+}
+
+void writeHeader(QTextStream &out, const QList<Table> &tables)
+{
+    out << "// Generated by opl_schemagen from database_schema.sql, do not edit.\n"
+           "#ifndef OPL_SCHEMA_H\n"
+           "#define OPL_SCHEMA_H\n"
+           "\n"
+           "namespace OPL::Schema {\n"
+           "\n"
+           "enum class ColumnType : unsigned char { Integer, Real, Text };\n"
+           "\n"
+           "struct ColumnDescriptor {\n"
+           "    const char *name;\n"
+           "    ColumnType type;\n"
+           "    bool notNull;\n"
+           "};\n";
+
+    for (const auto &table : tables) {
+        QString struct_name = table.name;
+        struct_name[0] = struct_name.at(0).toUpper();
+
+        out << "\nstruct " << struct_name << " {\n"
+            << "    static constexpr const char *TABLE_NAME = \"" << table.name << "\";\n"
+            << "    enum Column : int {\n";
+        for (const auto &column : table.columns)
+            out << "        " << column.name.toUpper() << ",\n";
+        out << "    };\n"
+            << "    static constexpr int COLUMN_COUNT = " << table.columns.size() << ";\n"
+            << "    static constexpr ColumnDescriptor COLUMNS[COLUMN_COUNT] = {\n";
+        for (const auto &column : table.columns)
+            out << "        {\"" << column.name << "\", " << columnType(column.type) << ", "
+                << (column.notNull ? "true" : "false") << "},\n";
+        out << "    };\n"
+            << "};\n";
+    }
+
+    out << "\n} // namespace OPL::Schema\n"
+           "\n"
+           "#endif // OPL_SCHEMA_H\n";
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+    if (args.size() != 3) {
+        err() << "Usage: opl_schemagen <output.h> <schema.sql>" << Qt::endl;
+        return 1;
+    }
+
+    QFile schema_file(args.at(2));
+    if (!schema_file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        err() << "Unable to read database schema - " << schema_file.errorString() << Qt::endl;
+        return 1;
+    }
+    const QList<Table> tables = parseSchema(QString::fromUtf8(schema_file.readAll()));
+    if (tables.isEmpty()) {
+        err() << "No tables found in " << args.at(2) << Qt::endl;
+        return 1;
+    }
+
+    // QSaveFile leaves an existing header untouched if writing fails
+    QSaveFile header(args.at(1));
+    if (!header.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        err() << "Unable to write " << args.at(1) << " - " << header.errorString() << Qt::endl;
+        return 1;
+    }
+    QTextStream out(&header);
+    writeHeader(out, tables);
+    out.flush();
+    if (!header.commit()) {
+        err() << "Unable to write " << args.at(1) << " - " << header.errorString() << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
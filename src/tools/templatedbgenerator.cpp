@@ -0,0 +1,157 @@
+/*
+ *openPilotLog - A FOSS Pilot Logbook Application
+ *Copyright (C) 2020-2023 Felix Turowsky
+ *
+ *This program is free software: you can redistribute it and/or modify
+ *it under the terms of the GNU General Public License as published by
+ *the Free Software Foundation, either version 3 of the License, or
+ *(at your option) any later version.
+ *
+ *This program is distributed in the hope that it will be useful,
+ *but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *GNU General Public License for more details.
+ *
+ *You should have received a copy of the GNU General Public License
+ *along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * opl_templatedb - build-time generator for the template database
+ *
+ * Creates an SQLite database from the database schema and fills the template tables from
+ * their JSON sources. The result is bundled as a resource so that the application can populate
+ * a new logbook with a single ATTACH and INSERT ... SELECT instead of parsing JSON at runtime.
+ *
+ * Usage: opl_templatedb <output.db> <schema.sql> <table.json>...
+ * The name of each JSON file (without suffix) is the name of the table it is imported into.
+ */
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTextStream>
+
+namespace {
+
+QTextStream &err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+bool createSchema(QSqlDatabase &database, const QString &schema_path)
+{
+    QFile f(schema_path);
+    if (!f.open(QIODevice::ReadOnly)) {
+        err() << "Unable to read database schema - " << f.errorString() << Qt::endl;
+        return false;
+    }
+
+    QSqlQuery q(database);
+    const auto statements = f.readAll().split(';');
+    for (const auto &statement : statements) {
+        if (statement.trimmed().isEmpty())
+            continue;
+        if (!q.exec(QString::fromUtf8(statement))) {
+            err() << "Unable to execute query: " << q.lastQuery() << Qt::endl
+                  << q.lastError().text() << Qt::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool importTable(QSqlDatabase &database, const QString &json_path)
+{
+    const QString table_name = QFileInfo(json_path).baseName();
+
+    QFile f(json_path);
+    if (!f.open(QIODevice::ReadOnly)) {
+        err() << "Unable to read " << json_path << " - " << f.errorString() << Qt::endl;
+        return false;
+    }
+    QJsonParseError parse_error;
+    const QJsonArray rows = QJsonDocument::fromJson(f.readAll(), &parse_error).array();
+    if (parse_error.error != QJsonParseError::NoError) {
+        err() << json_path << ": " << parse_error.errorString() << Qt::endl;
+        return false;
+    }
+
+    // Bind positionally in the column order of the table, so every row re-uses one statement
+    QSqlQuery q(database);
+    QStringList columns;
+    q.exec(QStringLiteral("PRAGMA table_info(\"%1\")").arg(table_name));
+    while (q.next())
+        columns.append(q.value(1).toString());
+    if (columns.isEmpty()) {
+        err() << "Table " << table_name << " does not exist in the schema." << Qt::endl;
+        return false;
+    }
+
+    QStringList placeholders;
+    placeholders.fill(QStringLiteral("?"), columns.size());
+    q.prepare(QStringLiteral("INSERT INTO \"%1\" (%2) VALUES (%3)")
+              .arg(table_name, columns.join(QLatin1Char(',')), placeholders.join(QLatin1Char(','))));
+
+    for (const auto &row : rows) {
+        const QJsonObject object = row.toObject();
+        for (const auto &column : std::as_const(columns))
+            q.addBindValue(object.value(column).toVariant());
+        if (!q.exec()) {
+            err() << "Unable to import into " << table_name << ": " << q.lastError().text() << Qt::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+    if (args.size() < 3) {
+        err() << "Usage: opl_templatedb <output.db> <schema.sql> <table.json>..." << Qt::endl;
+        return 1;
+    }
+
+    const QString output_path = args.at(1);
+    QFile::remove(output_path);
+
+    bool ok = true;
+    {
+        QSqlDatabase database = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"));
+        database.setDatabaseName(output_path);
+        if (!database.open()) {
+            err() << "Unable to create " << output_path << ": " << database.lastError().text() << Qt::endl;
+            return 1;
+        }
+
+        ok = createSchema(database, args.at(2));
+        database.transaction();
+        for (int i = 3; ok && i < args.size(); i++)
+            ok = importTable(database, args.at(i));
+
+        if (ok) {
+            database.commit();
+            QSqlQuery(database).exec(QStringLiteral("VACUUM"));
+        } else {
+            database.rollback();
+        }
+        database.close();
+    }
+    QSqlDatabase::removeDatabase(QSqlDatabase::defaultConnection);
+
+    if (!ok) {
+        QFile::remove(output_path);
+        return 1;
+    }
+    return 0;
+}